@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+// Counts calls of the global operator new when the game is built with SNAKE_COUNT_ALLOCATIONS.
+// Without the define the counter always reports zero and operator new is left untouched.
+namespace AllocationCounter
+{
+    std::size_t getAllocationCount();
+    bool isEnabled();
+}
+
+#endif
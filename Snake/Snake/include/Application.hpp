@@ -12,6 +12,26 @@ public:
 	~Application();
 
 	void run();
+    // Steps the current state for the given number of frames after a warm up and fails if any of them
+    // allocated on the heap. Needs SNAKE_COUNT_ALLOCATIONS, see the Allocations configuration
+    bool checkAllocations(unsigned int frames);
+    // Starts with the given replay instead of the main menu
+    bool playReplay(const std::string& path, float speed);
+    // Starts a game of the given level instead of the main menu
+    void startLevel(int levelIndex);
+    // Every game gets this many computer controlled snakes next to the player's
+    void setAISnakeCount(int count);
+    // Steps a frame may run on top of its own to catch up, the time past that is dropped. Also limits how
+    // many ticks a game runs on top of its tick rate per step, see GameState
+    void setMaxCatchUpSteps(int steps);
+    // Ticks per second of the games, 4 by default. Rates from 1 up to the turbo rates
+    void setTickRate(int ticksPerSecond);
+    // Starts a lockstep game over UDP instead of the main menu, see GameState. A levelIndex of -1 plays the first level
+    bool hostNetworkGame(std::uint16_t port, int playerCount, int levelIndex);
+    bool joinNetworkGame(const std::string& host, std::uint16_t port);
+    // Streams the games to spectators over TCP, or watches such a stream instead of the main menu
+    bool serveSpectators(std::uint16_t port);
+    bool spectateGame(const std::string& host, std::uint16_t port);
 
 private:
 	void processEvents();
@@ -21,9 +41,31 @@ private:
 
     void setIcon();
 
+    // Only used with SNAKE_PROFILER
+    void initProfilerOverlay();
+    void updateProfilerOverlay();
+    void processProfilerKeys();
+
+    // The overlay text is rebuilt a few times per second, not every frame
+    static const unsigned int FRAMES_PER_OVERLAY_UPDATE = 15;
+    static const int DEFAULT_MAX_CATCH_UP_STEPS = 4;
+
+    // Declared first so it starts before the window is created
+    sf::Clock m_startupClock;
+
     std::shared_ptr<StateManager> m_stateManager;
     std::shared_ptr<ResourceManager> m_resourceManager;
 	std::shared_ptr<sf::RenderWindow> m_window;
+
+    sf::Text m_profilerText;
+    sf::RectangleShape m_profilerBackground;
+    bool m_showProfilerOverlay {false};
+    bool m_overlayKeyWasDown {false};
+    bool m_traceKeyWasDown {false};
+    unsigned int m_framesSinceOverlayUpdate {0};
+
+    int m_maxStepsPerFrame {1 + DEFAULT_MAX_CATCH_UP_STEPS};
+    long long m_droppedStepCount {0};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef ASSET_PACK_HPP
+#define ASSET_PACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Layout of the asset pack written by SnakeAssetPacker:
+// AssetPackHeader, one AssetPackEntry per asset, then the payloads.
+// Each payload starts at a multiple of ASSET_PACK_ALIGNMENT. Textures are stored as RGBA8 pixels
+// and sounds as 16 bit PCM samples, so both can be uploaded without decoding.
+enum class AssetType : std::uint32_t
+{
+    Font, Texture, SoundBuffer
+};
+
+const std::uint32_t ASSET_PACK_MAGIC = 0x504B4E53; // "SNKP"
+const std::uint32_t ASSET_PACK_VERSION = 1;
+const std::uint32_t ASSET_PACK_ALIGNMENT = 16;
+const std::size_t ASSET_IDENTIFIER_LENGTH = 32;
+
+struct AssetPackHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t reserved;
+};
+
+struct AssetPackEntry
+{
+    char identifier[ASSET_IDENTIFIER_LENGTH];
+    AssetType type;
+    std::uint32_t widthOrChannelCount;  // Texture width or sound channel count
+    std::uint32_t heightOrSampleRate;   // Texture height or sound sample rate
+    std::uint32_t reserved;
+    std::uint64_t offset;               // From the start of the file
+    std::uint64_t size;                 // In bytes
+};
+
+// Read only memory mapping of an asset pack
+class AssetPack
+{
+public:
+    AssetPack();
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    const AssetPackEntry* findEntry(const std::string& identifier) const;
+    const void* getData(const AssetPackEntry& entry) const;
+
+private:
+    bool validate() const;
+
+    const unsigned char* m_data {nullptr};
+    std::size_t m_size {0};
+
+#ifdef _WIN32
+    void* m_fileHandle {nullptr};
+    void* m_mappingHandle {nullptr};
+#endif
+};
+
+#endif
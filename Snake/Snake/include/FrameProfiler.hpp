@@ -0,0 +1,83 @@
+#ifndef FRAMEPROFILER_HPP
+#define FRAMEPROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped timers for the main loop, compiled in when the game is built with SNAKE_PROFILER.
+// Without the define SNAKE_PROFILE_SCOPE expands to nothing and isEnabled() is a constant false,
+// so the profiling code in the main loop is removed by the compiler.
+// Only the main thread records, the resource loading threads are not profiled.
+namespace FrameProfiler
+{
+    enum class Sample
+    {
+        Frame, Update, Render,
+        Count // Number of samples, keep last
+    };
+
+    // Milliseconds over the last SAMPLE_FRAME_COUNT frames
+    struct Percentiles
+    {
+        float p50 {0.0f};
+        float p95 {0.0f};
+        float p99 {0.0f};
+    };
+
+    const std::size_t SAMPLE_FRAME_COUNT = 600;
+    const std::size_t TRACE_EVENT_CAPACITY = 1 << 16;
+
+#ifdef SNAKE_PROFILER
+    inline bool isEnabled() { return true; }
+    // Microseconds since the game started
+    std::int64_t getTimestamp();
+#else
+    inline bool isEnabled() { return false; }
+    inline std::int64_t getTimestamp() { return 0; }
+#endif
+
+    // Name has to outlive the profiler, pass string literals
+    void recordScope(const char* name, std::int64_t begin, std::int64_t end);
+    // Called once per frame with the frame's totals, the number of fixed steps it ran and the number it
+    // dropped because it was too far behind
+    void recordFrame(std::int64_t frameTime, std::int64_t updateTime, std::int64_t renderTime, int fixedSteps, int droppedSteps);
+
+    Percentiles getPercentiles(Sample sample);
+    int getMaxFixedSteps();
+    // Frames that had to run more than one fixed step to catch up
+    int getCatchUpFrameCount();
+    int getDroppedStepCount();
+
+    // Writes the last TRACE_EVENT_CAPACITY scopes as Chrome trace events, open with chrome://tracing or Perfetto
+    bool writeTrace(const std::string& path);
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const char* name)
+            :m_name(name), m_begin(getTimestamp())
+        {}
+        ~ScopedTimer()
+        {
+            recordScope(m_name, m_begin, getTimestamp());
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        const char* m_name;
+        std::int64_t m_begin;
+    };
+}
+
+#ifdef SNAKE_PROFILER
+#define SNAKE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SNAKE_PROFILE_CONCAT(a, b) SNAKE_PROFILE_CONCAT_IMPL(a, b)
+#define SNAKE_PROFILE_SCOPE(name) FrameProfiler::ScopedTimer SNAKE_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define SNAKE_PROFILE_SCOPE(name)
+#endif
+
+#endif
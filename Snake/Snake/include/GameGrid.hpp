@@ -1,51 +1,67 @@
 #ifndef GAME_GRID_HPP
 #define GAME_GRID_HPP
 
+#include "simulation/TileGrid.hpp"
 #include <SFML/Graphics.hpp>
-#include <optional>
+#include <memory>
+#include <vector>
 
+// Drawable view of a TileGrid, the logical tile values live in the simulation.
+// Tiles are stored in square chunks. Only chunks that intersect the target's view get quads, which are
+// built when a chunk first becomes visible and kept in a vertex buffer that only receives changed tiles.
+// The draw cost depends on the size of the view, not on the size of the level.
 class GameGrid : public sf::Drawable, public sf::Transformable
 {
 public:
-	enum class TileValue
-	{
-		Empty, Wall, SnakeBody, SnakeHead, Food, SuperFood,
-		Poison, Teleport1, Teleport2, NoPlayArea, DeadSnakeBody, DeadSnakeHead
-	};
+    using TileValue = TileGrid::TileValue;
 
-	bool loadFromArray(std::vector<int> level, int width, int height, sf::Vector2u tileSize);
+    static const int CHUNK_SIZE = 64;
+
+	void loadFromTileGrid(const TileGrid& tileGrid, sf::Vector2u tileSize);
 	void updateTile(int x, int y, TileValue value);
 	void updateTile(sf::Vector2i position, TileValue value);
     bool isValidPosition(int x, int y) const;
     bool isValidPosition(sf::Vector2i position) const;
-    bool getTileValueAt(int x, int y, TileValue* const tileValueToSet) const;
-    bool getTileValueAt(sf::Vector2i position, TileValue* const tileValueToSet) const;
-    void getListOfEmptyTiles(std::vector<sf::Vector2i>* tileList) const;
-    std::optional<sf::Vector2i> getPositionOfOtherTeleporter1(sf::Vector2i position) const;
-    std::optional<sf::Vector2i> getPositionOfOtherTeleporter2(sf::Vector2i position) const;
+
+    sf::Vector2f getSize() const; // In pixels, before the transform
+    sf::Vector2u getTileSize() const;
+    std::size_t getDrawnChunkCount() const; // Chunks drawn by the last draw()
+
+	static sf::Color getColorFromTileValue(TileValue value);
 
 protected:
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
 private:
-    struct TeleporterPair
+    // Quads of one chunk, only exists while the chunk is or was recently visible
+    struct ChunkGeometry
     {
-        TeleporterPair(sf::Vector2i pos1, sf::Vector2i pos2)
-            :pos1(pos1), pos2(pos2){}
-        sf::Vector2i pos1;
-        sf::Vector2i pos2;
+        sf::VertexArray vertices {sf::Quads};
+        sf::VertexBuffer vertexBuffer {sf::Quads, sf::VertexBuffer::Dynamic};
+        std::vector<int> dirtyTiles; // Chunk tile indices changed since the last upload
+        unsigned int lastDrawnFrame {0};
     };
 
-	static sf::Color getColorFromTileValue(TileValue value);
-    
+    std::size_t getTileIndex(int x, int y) const; // Index into m_tiles
+    void buildChunkGeometry(int chunkIndex) const;
+    void uploadDirtyTiles(ChunkGeometry& geometry) const;
+    void releaseUnusedGeometry() const;
+
 	int m_width {0};
 	int m_height {0};
-	std::vector<int> m_grid;
-	sf::VertexArray m_vertices;
-	sf::Texture m_tileset;
+    int m_chunksPerRow {0};
+    int m_chunkRows {0};
     sf::Vector2u m_tileSize;
-    std::optional<TeleporterPair> m_teleporterPair1;
-    std::optional<TeleporterPair> m_teleporterPair2;
+
+    // Chunk after chunk, every chunk is CHUNK_SIZE * CHUNK_SIZE tiles including the padding of edge chunks
+    std::vector<TileValue> m_tiles;
+
+    // Geometry is built lazily in draw(), which is const
+    bool m_useVertexBuffer {false};
+    mutable std::vector<std::unique_ptr<ChunkGeometry>> m_chunkGeometry;
+    mutable std::vector<int> m_chunksWithGeometry;
+    mutable unsigned int m_frame {0};
+    mutable std::size_t m_drawnChunkCount {0};
 };
 
 #endif
@@ -0,0 +1,56 @@
+#ifndef GLYPH_ATLAS_HPP
+#define GLYPH_ATLAS_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// The glyphs of one font at a few character sizes, copied into a single texture once. sf::Font keeps a
+// texture per character size, so text of different sizes can't share a draw call, text drawn from the
+// atlas can. Only the printable ASCII characters and the copyright sign are in it.
+class GlyphAtlas
+{
+public:
+    struct Glyph
+    {
+        sf::FloatRect bounds; // Relative to the baseline, like sf::Glyph
+        sf::IntRect textureRect;
+        float advance {0.0f};
+    };
+
+    // Metrics of a character size, as sf::Font reports them
+    struct SizeMetrics
+    {
+        float lineSpacing {0.0f};
+        float underlineThickness {0.0f};
+        float strikeThroughOffset {0.0f}; // Middle of the x, sf::Text draws the line there
+    };
+
+    // Sizes have to be added before build(), outlined text needs the glyphs with and without the outline
+    void addSize(unsigned int characterSize, float outlineThickness);
+    bool build(const sf::Font& font);
+
+    // Nullptr if the character or size isn't in the atlas
+    const Glyph* getGlyph(sf::Uint32 codePoint, unsigned int characterSize, float outlineThickness) const;
+    const SizeMetrics* getSizeMetrics(unsigned int characterSize) const;
+    const sf::Texture& getTexture() const;
+    // Texture coordinates of a white pixel, for strike-through lines
+    sf::Vector2f getWhitePixel() const;
+
+private:
+    struct Size
+    {
+        unsigned int characterSize;
+        float outlineThickness;
+    };
+
+    static std::uint64_t getGlyphKey(sf::Uint32 codePoint, unsigned int characterSize, float outlineThickness);
+
+    std::vector<Size> m_sizes;
+    std::unordered_map<std::uint64_t, Glyph> m_glyphs;
+    std::unordered_map<unsigned int, SizeMetrics> m_sizeMetrics;
+    sf::Texture m_texture;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef INPUT_QUEUE_HPP
+#define INPUT_QUEUE_HPP
+
+#include "simulation/Simulation.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Turns the player pressed, applied one per tick in the order they were pressed. Two quick turns
+// within one tick take effect in two ticks instead of the second one replacing the first.
+// Every turn carries the time its key event was polled, the time from there to the tick that
+// applied it is kept as input latency.
+class InputQueue
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    // More turns than this ahead of the snake are dropped, they would only feel like lag
+    static const std::size_t CAPACITY = 3;
+    static const std::size_t LATENCY_SAMPLE_COUNT = 256;
+
+    // Milliseconds over the last LATENCY_SAMPLE_COUNT applied turns
+    struct LatencyStats
+    {
+        long long count {0}; // All applied turns since the last reset
+        float p50 {0.0f};
+        float p95 {0.0f};
+        float max {0.0f};
+    };
+
+    // Forgets the queued turns, direction is where the snake moves now
+    void clear(PlayerInput direction);
+    // Turns are checked against the direction the snake has after the queued ones, so turning back
+    // after a turn is allowed. Repeating that direction or reversing it is ignored. False if the turn
+    // was ignored or the queue is full, time in microseconds
+    bool push(PlayerInput input, std::int64_t time);
+    // Input for the next tick, the oldest turn or the last direction if nothing is queued
+    PlayerInput pop(std::int64_t tickTime);
+
+    std::size_t getSize() const;
+    long long getDroppedCount() const;
+    LatencyStats getLatencyStats() const;
+    void resetStatistics();
+
+private:
+    struct Turn
+    {
+        PlayerInput input;
+        std::int64_t time;
+    };
+
+    std::array<Turn, CAPACITY> m_turns {};
+    std::size_t m_first {0};
+    std::size_t m_size {0};
+    PlayerInput m_direction {PlayerInput::Up}; // After the queued turns
+    PlayerInput m_lastInput {PlayerInput::Up}; // Returned while the queue is empty
+
+    std::array<std::int64_t, LATENCY_SAMPLE_COUNT> m_latencies {};
+    long long m_latencyCount {0};
+    std::int64_t m_maxLatency {0};
+    long long m_droppedCount {0};
+};
+
+#endif
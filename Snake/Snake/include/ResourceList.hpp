@@ -0,0 +1,58 @@
+#ifndef RESOURCE_LIST_HPP
+#define RESOURCE_LIST_HPP
+
+#include "AssetPack.hpp"
+#include <array>
+
+// Every resource of the game, shared by the ResourceManager and SnakeAssetPacker
+struct ResourceDescription
+{
+    const char* identifier;
+    AssetType type;
+    const char* path;
+};
+
+const std::array<ResourceDescription, 17> RESOURCE_LIST = {{
+    // The font first, the main menu only waits for it
+    {"font_menu", AssetType::Font, "resources/PressStart2P-Regular.ttf"},
+
+    {"level1", AssetType::Texture, "resources/img/level1.png"},
+    {"level1_selected", AssetType::Texture, "resources/img/level1_selected.png"},
+    {"level2", AssetType::Texture, "resources/img/level2.png"},
+    {"level2_selected", AssetType::Texture, "resources/img/level2_selected.png"},
+    {"level3", AssetType::Texture, "resources/img/level3.png"},
+    {"level3_selected", AssetType::Texture, "resources/img/level3_selected.png"},
+
+    {"sound_food", AssetType::SoundBuffer, "resources/sounds/food.wav"},
+    {"sound_food_big", AssetType::SoundBuffer, "resources/sounds/food_big.wav"},
+    {"sound_teleport", AssetType::SoundBuffer, "resources/sounds/teleport.wav"},
+    {"sound_movement", AssetType::SoundBuffer, "resources/sounds/movement.wav"},
+    {"sound_movement_growing", AssetType::SoundBuffer, "resources/sounds/movement_growing.wav"},
+    {"sound_collision", AssetType::SoundBuffer, "resources/sounds/collision.wav"},
+    {"sound_ui", AssetType::SoundBuffer, "resources/sounds/ui.wav"},
+    {"sound_ui_confirm", AssetType::SoundBuffer, "resources/sounds/ui_confirm.wav"},
+    {"sound_volume_up", AssetType::SoundBuffer, "resources/sounds/volume_up.wav"},
+    {"sound_volume_down", AssetType::SoundBuffer, "resources/sounds/volume_down.wav"}
+}};
+
+// Character sizes the states draw the menu font with, and the outline used at that size.
+// Only these are in the glyph atlas of the font
+struct FontSizeDescription
+{
+    unsigned int characterSize;
+    float outlineThickness;
+};
+
+const std::array<FontSizeDescription, 8> MENU_FONT_SIZES = {{
+    {52, 0.0f}, {44, 0.0f}, {38, 0.0f}, {28, 0.0f}, {26, 3.0f}, {22, 0.0f}, {20, 0.0f}, {14, 2.0f}
+}};
+
+const char* const ASSET_PACK_PATH = "snake.pak";
+
+// Written by the SnakeLevelPacker project
+const char* const LEVEL_PACK_PATH = "resources/levels.lvl";
+
+// Hamiltonian cycles of the levels played with the cycle autopilot, solved on first use
+const char* const CYCLE_CACHE_DIRECTORY = "cycles";
+
+#endif
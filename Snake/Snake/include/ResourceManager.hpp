@@ -1,23 +1,81 @@
 #ifndef RESOURCE_MANAGER_HPP
 #define RESOURCE_MANAGER_HPP
 
+#include "AssetPack.hpp"
+#include "GlyphAtlas.hpp"
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
 #include <SFML/Audio.hpp>
+#include <SFML/System/Clock.hpp>
+#include <future>
+#include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
+// Resources come from the memory mapped asset pack if there is one, otherwise they are decoded from
+// the resources folder on worker threads. Either way they are uploaded on the main thread.
+// The getters hand out the final objects right away, they stay empty until the resource is uploaded.
 class ResourceManager
 {
 public:
+    // Maps the asset pack or starts decoding all resources in the background, the font first
+    void startLoading();
+    // Uploads every resource whose decoding has finished, never blocks. Returns true once everything is loaded
+    bool processLoadedResources();
+    // Blocks until the given resource is decoded and uploaded
+    bool waitForResource(const std::string& identifier);
+    bool isResourceReady(const std::string& identifier) const;
+    // Blocking load of everything
     bool loadResources();
+
     std::shared_ptr<sf::Font> getFont(const std::string& identifier) const;
     std::shared_ptr<sf::Texture> getTexture(const std::string& identifier) const;
     std::shared_ptr<sf::SoundBuffer> getSoundBuffer(const std::string& identifier) const;
+    // Built from the loaded font at MENU_FONT_SIZES on first use, nullptr until the font is loaded
+    std::shared_ptr<const GlyphAtlas> getGlyphAtlas(const std::string& fontIdentifier);
 
 private:
+    // Result of the worker thread, only touched by the main thread after the future is ready
+    struct DecodedResource
+    {
+        bool success {false};
+        std::vector<char> fileData;
+        sf::Image image;
+        std::vector<sf::Int16> samples;
+        unsigned int channelCount {0};
+        unsigned int sampleRate {0};
+    };
+
+    struct PendingResource
+    {
+        std::string identifier;
+        AssetType type;
+        std::string path;
+        const AssetPackEntry* packEntry {nullptr};
+        std::future<DecodedResource> decoded;
+        bool uploaded {false};
+        bool success {false};
+    };
+
+    void queueResource(const std::string& identifier, AssetType type, const std::string& path);
+    static DecodedResource decodeResource(AssetType type, const std::string& path);
+    bool uploadResource(PendingResource& resource);
+    bool uploadFromAssetPack(const PendingResource& resource);
+
+    // Declared before the resources, fonts read from the mapping as long as they exist
+    AssetPack m_assetPack;
+    std::vector<PendingResource> m_pendingResources;
+    std::size_t m_uploadedResourceCount {0};
+    sf::Clock m_loadingClock;
+
     std::unordered_map<std::string, std::shared_ptr<sf::Font>> m_fonts;
+    std::unordered_map<std::string, std::vector<char>> m_fontData;
     std::unordered_map<std::string, std::shared_ptr<sf::SoundBuffer>> m_soundBuffers;
     std::unordered_map<std::string, std::shared_ptr<sf::Texture>> m_textures;
+    std::unordered_map<std::string, std::shared_ptr<const GlyphAtlas>> m_glyphAtlases;
 };
 
-#endif
\ No newline at end of file
+#endif
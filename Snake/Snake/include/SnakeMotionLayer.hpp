@@ -0,0 +1,43 @@
+#ifndef SNAKE_MOTION_LAYER_HPP
+#define SNAKE_MOTION_LAYER_HPP
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Drawn over a GameGrid to move the snakes smoothly between ticks. The grid shows the tiles after
+// the last tick, this layer slides each head from its old tile into the new one and pulls each
+// tail out of the tile it left, by the progress towards the next tick. Only the tiles at the ends
+// of a snake are drawn, so the cost per frame is a few quads per visible snake and the simulation
+// is not touched. The snakes are drawn up to one tick behind the simulation.
+class SnakeMotionLayer : public sf::Drawable, public sf::Transformable
+{
+public:
+    void setTileSize(sf::Vector2u tileSize);
+    // Forgets where the snakes were, nothing moves until they moved once more
+    void reset(int snakeCount);
+    // Where a snake is after a tick. Snakes that jumped (teleporters, respawns) or died stay on their tiles
+    void setSnake(int index, sf::Vector2i head, sf::Vector2i tail, bool isAlive);
+    // 0 draws the snakes where they were before the last tick, 1 where they are now
+    void setProgress(float progress);
+
+protected:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+private:
+    struct SnakeMotion
+    {
+        sf::Vector2i head {-1, -1};
+        sf::Vector2i tail {-1, -1};
+        sf::Vector2i headMovement; // Zero if the head doesn't move smoothly
+        sf::Vector2i tailMovement;
+    };
+
+    void addQuad(sf::Vector2f tilePosition, sf::Vector2f size, sf::Color color) const;
+
+    std::vector<SnakeMotion> m_snakes;
+    sf::Vector2f m_tileSize;
+    float m_progress {1.0f};
+    mutable sf::VertexArray m_vertices {sf::Quads}; // Rebuilt every draw from the visible snakes
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef TEXT_BATCH_HPP
+#define TEXT_BATCH_HPP
+
+#include "GlyphAtlas.hpp"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <memory>
+#include <vector>
+
+// All texts of a state in one vertex array, drawn with one draw call from a GlyphAtlas.
+// Texts are laid out like sf::Text when their string changes. Moving or recoloring a text only
+// rewrites its vertices, and counters replace the quads of their digits without any layout.
+// Texts are drawn in the order they were added.
+class TextBatch : public sf::Drawable
+{
+public:
+    struct Style
+    {
+        unsigned int characterSize {30};
+        sf::Color fillColor {sf::Color::White};
+        sf::Color outlineColor {sf::Color::Black};
+        float outlineThickness {0.0f};
+        float letterSpacing {1.0f}; // Factor, like sf::Text::setLetterSpacing
+        bool isItalic {false};
+        bool isStrikeThrough {false};
+    };
+
+    void setAtlas(std::shared_ptr<const GlyphAtlas> atlas);
+
+    // Returns the index of the text, used by the setters. Texts start at (0, 0) and visible
+    std::size_t addText(const sf::String& string, const Style& style);
+    // A number of up to digitCount digits centered in the space of digitCount digits, starts at 0
+    std::size_t addCounter(unsigned int digitCount, const Style& style);
+
+    void setString(std::size_t text, const sf::String& string);
+    // Larger values show all nines
+    void setCounter(std::size_t text, unsigned int value);
+    void setPosition(std::size_t text, sf::Vector2f position);
+    void setFillColor(std::size_t text, sf::Color color);
+    void setStrikeThrough(std::size_t text, bool isStrikeThrough);
+    void setVisible(std::size_t text, bool isVisible);
+
+    // Like sf::Text::getGlobalBounds, counters report the space of all their digits
+    sf::FloatRect getBounds(std::size_t text) const;
+    // Bounds of the string laid out at (0, 0)
+    sf::FloatRect measure(const sf::String& string, const Style& style) const;
+
+protected:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+private:
+    struct Text
+    {
+        Style style;
+        sf::String string;
+        sf::Vector2f position;
+        bool isVisible {true};
+        std::vector<sf::Vertex> vertices; // Relative to the position, the outline before the fill
+        std::size_t outlineVertexCount {0};
+        sf::FloatRect bounds;
+        mutable std::size_t firstVertex {0}; // In m_vertices, set when it is rebuilt
+        // Only counters have digits
+        unsigned int digitCount {0};
+        unsigned int value {0};
+        float digitSpacing {0.0f}; // Added to the advance of every digit, the letter spacing
+        std::array<const GlyphAtlas::Glyph*, 10> digitGlyphs {};
+        std::array<const GlyphAtlas::Glyph*, 10> digitOutlineGlyphs {};
+    };
+
+    void layout(Text& text) const;
+    void setDigitQuads(Text& text) const;
+    sf::FloatRect layout(const sf::String& string, const Style& style, std::vector<sf::Vertex>* vertices, std::size_t* outlineVertexCount) const;
+    // Writes the changed vertices of a text into m_vertices, unless everything is rebuilt anyway
+    void updateVertices(const Text& text) const;
+    void rebuild() const;
+
+    std::shared_ptr<const GlyphAtlas> m_atlas;
+    std::vector<Text> m_texts;
+    mutable std::vector<sf::Vertex> m_vertices;
+    mutable bool m_needsRebuild {true};
+};
+
+#endif
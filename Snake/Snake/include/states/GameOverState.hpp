@@ -2,6 +2,7 @@
 #define GAME_OVER_STATE_HPP
 
 #include "State.hpp"
+#include "TextBatch.hpp"
 #include <array>
 
 class GameOverState : public State
@@ -25,9 +26,11 @@ private:
 
 	int m_score {0};
     int m_currentSelection {0};
-	sf::Text m_textInfo;
-	sf::Text m_textScore;
-	std::array<sf::Text, 2> m_textListMenus;
+    // Indices into m_texts
+    TextBatch m_texts;
+	std::size_t m_textInfo {0};
+	std::size_t m_textScore {0};
+	std::array<std::size_t, 2> m_textListMenus {};
 	sf::RectangleShape m_backgroundLayer;
 };
 #endif
\ No newline at end of file
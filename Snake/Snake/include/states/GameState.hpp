@@ -3,8 +3,21 @@
 
 #include "State.hpp"
 #include "GameGrid.hpp"
-#include <array>
+#include "InputQueue.hpp"
+#include "SnakeMotionLayer.hpp"
+#include "TextBatch.hpp"
+#include "simulation/Autopilot.hpp"
+#include "simulation/CycleFollower.hpp"
+#include "simulation/LevelPack.hpp"
+#include "simulation/Lockstep.hpp"
+#include "simulation/Replay.hpp"
+#include "simulation/Simulation.hpp"
+#include "simulation/SnakeArena.hpp"
+#include "simulation/SpectatorServer.hpp"
+#include "simulation/UdpTransport.hpp"
+#include <memory>
 #include <random>
+#include <string>
 
 class GameState : public State
 {
@@ -22,56 +35,158 @@ public:
     virtual void setEffectsVolume(float volume) override;
 
     void setNextLevel(int levelIndex);
+    // The next enter() plays the replay instead of a new game, speed 1 is the normal game speed
+    void playReplay(const Replay& replay, float speed);
+    // Games with AI snakes run on a SnakeArena and are not recorded, 0 plays the single snake game
+    void setAISnakeCount(int count);
+    // Ticks an update may run on top of the ones its time is worth, the time past that is dropped
+    void setMaxCatchUpTicks(int ticks);
+    // Clamped to MIN_TICK_RATE..MAX_TICK_RATE. Network games always tick at the default rate
+    void setTickRate(int ticksPerSecond);
+    // The next enter() starts a lockstep game over UDP instead. The host runs the server for playerCount
+    // players, itself included, with the next level and the AI snake count. Network games are arena games
+    // without a game over, dead snakes start over. The game ends when the state is left
+    bool hostNetworkGame(std::uint16_t port, int playerCount);
+    bool joinNetworkGame(const std::string& host, std::uint16_t port);
+    // Streams every game played from now on to spectators over TCP, see SpectatorServer
+    bool serveSpectators(std::uint16_t port);
+    // The next enter() watches the game of a spectator server instead of playing, until the state is left
+    bool spectateGame(const std::string& host, std::uint16_t port);
 
 private:
-    enum class PlayerInput
-    {
-        Up, Down, Left, Right
-    };
+    using PlayerInput = Simulation::PlayerInput;
 
-    struct LevelData
+    // Who steers the snake, P switches to the next one
+    enum class Controller
     {
-        std::vector<int> gridData;
-        sf::Vector2u tileSize;
-        int width;
-        int height;
-        sf::Vector2i startPosition;
+        Player, Autopilot, Cycle
     };
 
-    void buildLevels();
-    void loadLevel(int levelIndex);
-    void moveSnake();
-    bool isSnakeValid() const;
+    // The levels of the level pack, or the builtin ones if it couldn't be read
+    int getLevelCount() const;
+    bool loadLevel(int levelIndex);
+    // The arena, network and spectator games are in GameStateArena.cpp, GameStateNetwork.cpp and
+    // GameStateSpectator.cpp
+    bool loadArenaLevel();
+    void stepArena();
+    void updateNetworkGame(sf::Time elapsedTime);
+    bool loadNetworkGame();
+    void endNetworkGame();
+    std::chrono::microseconds getNetworkTime() const;
+    void updateSpectating();
+    void endSpectating();
+    void setupCamera();
+    // The player's snake, in the arena it is snake m_localSnakeIndex. Spectators see the streamed grid
+    const TileGrid& getTileGrid() const;
+    bool isPlayerDead() const;
+    int getPlayerScore() const;
+    PlayerInput getPlayerLastMovement() const;
+    void applySimulationEvents(const Simulation::Events& events);
+    void syncGameGrid();
+    void updateSnakeMotion();
+    sf::Time getTimePerMovement() const;
+    void updateCamera();
     void triggerSnakeDeath();
-    void snakeGrows(int growth);
+    // Microseconds, timestamps of the queued turns
+    std::int64_t getInputTime() const;
+    bool isPlayerSteering() const;
+    void reportInputLatency();
+    void reportTickRate();
     void setScore(int score);
-
+    void setReplaySpeed(float speed);
+    void setController(Controller controller);
+    bool prepareCycle();
+    void writeReplayFile();
 
     const sf::Time TIME_PER_SNAKE_MOVEMENT = sf::seconds(1.0f / 4.0f);
+    // Ticks per second, Page Up and Page Down double and halve the rate, T switches to the turbo rate and back
+    const int DEFAULT_TICK_RATE = 4;
+    const int MIN_TICK_RATE = 1;
+    const int MAX_TICK_RATE = 4096;
+    const int TURBO_TICK_RATE = 1024;
+    // Search time per frame, the rest of a long search continues in the next frames
+    const std::chrono::microseconds AUTOPILOT_BUDGET_PER_FRAME {2000};
+    // Dead AI snakes stay on the grid for a moment before they start over
+    const int AI_SNAKE_RESPAWN_TICKS = 8;
+    const unsigned int SCORE_DIGIT_COUNT = 6;
 
-    std::vector<sf::Vector2i> m_snake;
-    std::array<LevelData, 3> m_levels;
+    Simulation m_simulation;
+    // Only the index is read up front, a level is decoded when it is played
+    LevelPack m_levelPack;
+    LevelData m_level;
+    int m_loadedLevelIndex {-1};
     GameGrid m_gameGrid;
+    // Moves the snakes between ticks, I switches it off and on
+    SnakeMotionLayer m_snakeMotion;
+    bool m_isSmoothMotion {true};
+    // Levels larger than the window are drawn through a camera that follows the snake's head
+    sf::View m_camera;
+    bool m_useCamera {false};
     int m_score {0};
     int m_nextLevelIndex {0};
-    int m_foodInLevel {0};
-    int m_maxFoodInLevel {20};
-    int m_foodSpawnCooldown {5};
-    int m_remainingGrowthTicks {0};
-    int m_remainingFoodSpawnCooldown {0};
-    PlayerInput m_lastInput {PlayerInput::Up};
-    PlayerInput m_lastMovement {PlayerInput::Up};
-    bool m_snakeIsDead {false};
+    // Turns of the player, one is applied per tick
+    InputQueue m_inputQueue;
+    sf::Clock m_inputClock;
+
+    // Steer instead of the player, their inputs are recorded like the player's
+    Controller m_controller {Controller::Player};
+    Autopilot m_autopilot;
+    CycleFollower m_cycleFollower;
+    HamiltonianCycle m_cycle;
+    int m_cycleLevelIndex {-1};
+
+    SnakeArena m_arena;
+    int m_aiSnakeCount {0};
+    bool m_isArenaGame {false};
+    std::vector<PlayerInput> m_arenaInputs;
+    std::vector<int> m_respawnTicks;
+    std::mt19937 m_aiRandomGenerator;
+    int m_localSnakeIndex {0};
+
+    // Lockstep multiplayer, the host runs the server next to its own client
+    std::unique_ptr<UdpTransport> m_serverTransport;
+    std::unique_ptr<UdpTransport> m_clientTransport;
+    LockstepServer m_lockstepServer;
+    LockstepClient m_lockstepClient;
+    bool m_isNetworkGame {false};
+    bool m_isNetworkGameLoaded {false};
+    sf::Clock m_networkClock;
+
+    // Spectators, the server streams the tiles syncGameGrid() draws
+    std::unique_ptr<SpectatorServer> m_spectatorServer;
+    std::uint32_t m_spectatorTick {0};
+    std::unique_ptr<SpectatorClient> m_spectatorClient;
+    bool m_isSpectating {false};
+    long long m_spectatorKeyframeCount {0};
+    sf::Vector2i m_spectatorFocus {-1, -1}; // Snake head the camera follows
+
+    // Every game is recorded, a replay is played back at m_replaySpeed
+    Replay m_replay;
+    bool m_replayPending {false};
+    bool m_isPlayingReplay {false};
+    std::size_t m_replayTick {0};
+    float m_replaySpeed {1.0f};
 
     sf::Clock m_snakeClock;
     sf::Time m_snakeTime;
-    std::default_random_engine m_randomGenerator;
-    std::uniform_int_distribution<int> m_superFoodDistribution;
+    int m_tickRate {DEFAULT_TICK_RATE};
+    int m_tickRateBeforeTurbo {DEFAULT_TICK_RATE};
+    int m_maxCatchUpTicks {4};
+    // Since the game started, reported when it ends
+    long long m_tickCount {0};
+    long long m_droppedTickCount {0};
+    sf::Time m_playTime;
 
     sf::RectangleShape m_gameOverEffect;
 	sf::RectangleShape m_scoreUIShape;
     sf::Font m_font;
-    sf::Text m_scoreText;
+    // Indices into m_texts, the score is a counter
+    TextBatch m_texts;
+    std::size_t m_scoreText {0};
+    std::size_t m_replayText {0};
+    std::size_t m_autopilotText {0};
+    std::size_t m_networkText {0};
+    std::size_t m_tickRateText {0};
 
     sf::Sound m_soundFood;
     sf::Sound m_soundFoodBig;
@@ -2,6 +2,7 @@
 #define LEVEL_SELECTION_STATE_HPP
 
 #include "State.hpp"
+#include "TextBatch.hpp"
 #include <array>
 
 class LevelSelectionState : public State
@@ -22,8 +23,10 @@ private:
 	bool setMenuItemSelection(int index);
 
 	int m_currentSelection {0};
-	sf::Text m_textTitle;
-	sf::Text m_textEscape;
+    // Indices into m_texts
+    TextBatch m_texts;
+	std::size_t m_textTitle {0};
+	std::size_t m_textEscape {0};
     std::array<sf::Sprite, 3> m_selectionSprites;
     std::array<sf::Sprite, 3> m_selectionSpritesSelected;
 };
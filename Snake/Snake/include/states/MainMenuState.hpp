@@ -2,6 +2,7 @@
 #define MAIN_MENU_STATE_HPP
 
 #include "State.hpp"
+#include "TextBatch.hpp"
 #include <array>
 
 class MainMenuState : public State
@@ -22,8 +23,10 @@ private:
     bool setMenuItemSelection(int index);
 
     int m_currentSelection{0};
-    sf::Text m_textTitle;
-    std::array<sf::Text, 3> m_textListMenus;
-    sf::Text m_textCopyright;
+    // Indices into m_texts
+    TextBatch m_texts;
+    std::size_t m_textTitle {0};
+    std::array<std::size_t, 3> m_textListMenus {};
+    std::size_t m_textCopyright {0};
 };
 #endif
\ No newline at end of file
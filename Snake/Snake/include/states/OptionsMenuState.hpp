@@ -2,6 +2,7 @@
 #define OPTIONS_MENU_STATE_HPP
 
 #include "State.hpp"
+#include "TextBatch.hpp"
 #include <array>
 
 class OptionsMenuState : public State
@@ -29,10 +30,12 @@ private:
 	int m_musicVolume = 5;
 	int m_effectVolume = 5;
 
-    sf::Text m_textTitle;
-    sf::Text m_textReturn;
-	sf::Text m_textMusic;
-	sf::Text m_textEffects;
+    // Indices into m_texts
+    TextBatch m_texts;
+    std::size_t m_textTitle {0};
+    std::size_t m_textReturn {0};
+	std::size_t m_textMusic {0};
+	std::size_t m_textEffects {0};
 
 	std::array<sf::RectangleShape, 10> m_musicVolumeShapes;
 	std::array<sf::RectangleShape, 10> m_musicVolumeShapesActive;
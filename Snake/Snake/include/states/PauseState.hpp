@@ -2,6 +2,7 @@
 #define PAUSE_OVER_STATE_HPP
 
 #include "State.hpp"
+#include "TextBatch.hpp"
 #include <array>
 
 class PauseState : public State
@@ -22,8 +23,10 @@ private:
     bool setMenuItemSelection(int index);
 
     int m_currentSelection {0};
-    sf::Text m_textInfo;
-    std::array<sf::Text, 3> m_textListMenus;
+    // Indices into m_texts
+    TextBatch m_texts;
+    std::size_t m_textInfo {0};
+    std::array<std::size_t, 3> m_textListMenus {};
     sf::RectangleShape m_backgroundLayer;
 };
 #endif
\ No newline at end of file
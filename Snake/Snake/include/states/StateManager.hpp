@@ -2,8 +2,10 @@
 #define STATE_MANAGER_HPP
 
 #include "ResourceManager.hpp"
-#include <map>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <SFML/System/Time.hpp>
 
 namespace sf {
@@ -11,13 +13,15 @@ namespace sf {
 }
 
 class State;
+struct Replay;
 
 class StateManager : public std::enable_shared_from_this<StateManager>
 {
 public:
 	enum class StateID
 	{
-		InvalidState, Game, HighscoreMenu, LevelSelection, MainMenu, Options, Pause, GameOver
+		InvalidState, Game, HighscoreMenu, LevelSelection, MainMenu, Options, Pause, GameOver,
+		Count // Number of ids, keep last
 	};
 
     struct StackInfo
@@ -47,15 +51,38 @@ public:
 
     void startTheMusic();
     void setNextLevelForGameState(int levelIndex) const;
+    void setAISnakeCountForGameState(int count) const;
+    void setMaxCatchUpTicksForGameState(int ticks) const;
+    void setTickRateForGameState(int ticksPerSecond) const;
 	void setScoreForGameOverState(int score) const;
+    void playReplay(const Replay& replay, float speed);
+    bool hostNetworkGame(std::uint16_t port, int playerCount);
+    bool joinNetworkGame(const std::string& host, std::uint16_t port);
+    bool serveSpectators(std::uint16_t port);
+    bool spectateGame(const std::string& host, std::uint16_t port);
     void playSoundUI();
     void playSoundUIConfirm();
     void setEffectsVolume(float volume);
     void setMusicVolume(float volume);
 
 private:
+    static const std::size_t STATE_COUNT = static_cast<std::size_t>(StateID::Count);
+
+    // States to update or render this frame, bottom to top. Rebuilt only when the stack changes.
+    struct ActiveStates
+    {
+        std::array<State*, STATE_COUNT> states {};
+        std::array<StateID, STATE_COUNT> ids {};
+        std::size_t count {0};
+    };
+
+    State* getState(StateID stateID) const;
+    void rebuildActiveStates();
+
 	StateID m_currentState {StateID::InvalidState};
-    std::map<StateID, std::unique_ptr<State>> m_states;
+    std::array<std::unique_ptr<State>, STATE_COUNT> m_states;
+    ActiveStates m_statesToUpdate;
+    ActiveStates m_statesToRender;
     std::vector<StateID> m_stack;
 	std::vector<StackInfo> m_infoStack;
     std::shared_ptr<sf::RenderWindow> m_window;
@@ -0,0 +1,66 @@
+#include "AllocationCounter.hpp"
+
+#ifdef SNAKE_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::size_t> allocationCount {0};
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+std::size_t AllocationCounter::getAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+bool AllocationCounter::isEnabled()
+{
+    return true;
+}
+#else
+std::size_t AllocationCounter::getAllocationCount()
+{
+    return 0;
+}
+
+bool AllocationCounter::isEnabled()
+{
+    return false;
+}
+#endif
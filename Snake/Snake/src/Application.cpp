@@ -1,21 +1,40 @@
 #include "Application.hpp"
+#include "AllocationCounter.hpp"
+#include "FrameProfiler.hpp"
+#include "simulation/Replay.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
 
 using std::cout;
 using std::endl;
 using std::cerr;
 
+namespace
+{
+    const sf::Time TIME_PER_FRAME = sf::seconds(1.0f / 60.0f);
+}
+
 Application::Application(const std::string& title)
 	:m_window(std::make_shared<sf::RenderWindow>(sf::VideoMode(800, 600), title, sf::Style::Titlebar | sf::Style::Close)),
 	m_stateManager(std::make_shared<StateManager>()),
     m_resourceManager(std::make_shared<ResourceManager>())
 {
-    m_resourceManager->loadResources();
+    // The menu only needs the font, everything else keeps loading while it is shown
+    m_resourceManager->startLoading();
+    if (!m_resourceManager->waitForResource("font_menu"))
+        cerr << "Application ctor: error loading the menu font!" << endl;
     m_stateManager->init(m_window, m_resourceManager);
 
     setIcon();
 
+    if (FrameProfiler::isEnabled())
+    {
+        initProfilerOverlay();
+    }
+
 	m_window->setVerticalSyncEnabled(true);
 }
 
@@ -28,45 +47,310 @@ void Application::run()
 	sf::Clock clock;
 	sf::Time stepTime;
 
-	const sf::Time TIME_PER_FRAME = sf::seconds(1.0f / 60.0f);
-
     m_stateManager->startTheMusic();
 
+    // Frames that allocated on the heap, only counted with SNAKE_COUNT_ALLOCATIONS
+    const unsigned int FRAMES_PER_ALLOCATION_REPORT = 600;
+    unsigned int framesSinceReport = 0;
+    unsigned int allocatingFrames = 0;
+    std::size_t allocations = 0;
+
+    bool firstFrame = true;
+    bool resourcesLoaded = false;
+
+    // Frame timings, only recorded with SNAKE_PROFILER
+    std::int64_t lastFrameBegin = FrameProfiler::getTimestamp();
+
     while(m_window->isOpen())
     {
+        SNAKE_PROFILE_SCOPE("frame");
+        const std::int64_t frameBegin = FrameProfiler::getTimestamp();
+        const std::size_t allocationsBeforeFrame = AllocationCounter::getAllocationCount();
+
+        if (!resourcesLoaded)
+        {
+            SNAKE_PROFILE_SCOPE("process loaded resources");
+            resourcesLoaded = m_resourceManager->processLoadedResources();
+        }
+
         stepTime += clock.restart();
 
-        // Fixed time step loop
-        while(stepTime >= TIME_PER_FRAME)
+        // Fixed time step loop, more than one step per frame means the game is catching up
+        std::int64_t updateTime = 0;
+        int fixedSteps = 0;
+        while(stepTime >= TIME_PER_FRAME && fixedSteps < m_maxStepsPerFrame)
         {
+            SNAKE_PROFILE_SCOPE("fixed step");
+            const std::int64_t stepBegin = FrameProfiler::getTimestamp();
+
 			processEvents();
 			processInput();
 			update(TIME_PER_FRAME);
 
+            updateTime += FrameProfiler::getTimestamp() - stepBegin;
+            ++fixedSteps;
             stepTime -= TIME_PER_FRAME;
         }
+
+        // After a stall (dragging the window, a breakpoint) the rest is dropped instead of stepped, catching
+        // up on all of it would take longer than the stall itself if the steps are slow
+        int droppedSteps = 0;
+        if (stepTime >= TIME_PER_FRAME)
+        {
+            droppedSteps = static_cast<int>(stepTime / TIME_PER_FRAME);
+            m_droppedStepCount += droppedSteps;
+            stepTime %= TIME_PER_FRAME;
+        }
+
+        const std::int64_t renderBegin = FrameProfiler::getTimestamp();
         render();
+
+        if (FrameProfiler::isEnabled())
+        {
+            // Frame time is measured from frame start to frame start, so it includes waiting for vsync
+            FrameProfiler::recordFrame(frameBegin - lastFrameBegin, updateTime, FrameProfiler::getTimestamp() - renderBegin, fixedSteps, droppedSteps);
+            lastFrameBegin = frameBegin;
+            processProfilerKeys();
+        }
+
+        if (firstFrame)
+        {
+            cout << "Time to first frame: " << m_startupClock.getElapsedTime().asMilliseconds() << " ms" << endl;
+            firstFrame = false;
+        }
+
+        if (AllocationCounter::isEnabled())
+        {
+            const std::size_t frameAllocations = AllocationCounter::getAllocationCount() - allocationsBeforeFrame;
+            allocations += frameAllocations;
+            if (frameAllocations > 0)
+                ++allocatingFrames;
+
+            if (++framesSinceReport == FRAMES_PER_ALLOCATION_REPORT)
+            {
+                cout << "Allocations: " << allocations << " in " << allocatingFrames << " of "
+                    << framesSinceReport << " frames" << endl;
+                framesSinceReport = 0;
+                allocatingFrames = 0;
+                allocations = 0;
+            }
+        }
+    }
+
+    if (m_droppedStepCount > 0)
+        cout << "Dropped " << m_droppedStepCount << " steps in total" << endl;
+}
+
+bool Application::checkAllocations(unsigned int frames)
+{
+    if (!AllocationCounter::isEnabled())
+    {
+        cerr << "Application::checkAllocations(): built without SNAKE_COUNT_ALLOCATIONS!" << endl;
+        return false;
+    }
+
+    // Warm up until the loader threads are done and the scene had time to fill its buffers, those
+    // allocations are expected
+    const unsigned int WARM_UP_FRAMES = 120;
+    bool resourcesLoaded = false;
+    for (unsigned int i = 0; (i < WARM_UP_FRAMES || !resourcesLoaded) && m_window->isOpen(); ++i)
+    {
+        resourcesLoaded = m_resourceManager->processLoadedResources();
+        processEvents();
+        processInput();
+        update(TIME_PER_FRAME);
+        render();
+    }
+
+    // Every frame steps exactly once, so the check doesn't depend on the frame rate
+    unsigned int allocatingFrames = 0;
+    std::size_t allocations = 0;
+    for (unsigned int frame = 0; frame < frames && m_window->isOpen(); ++frame)
+    {
+        const std::size_t allocationsBeforeFrame = AllocationCounter::getAllocationCount();
+
+        processEvents();
+        processInput();
+        update(TIME_PER_FRAME);
+        render();
+
+        const std::size_t frameAllocations = AllocationCounter::getAllocationCount() - allocationsBeforeFrame;
+        if (frameAllocations > 0)
+        {
+            if (allocatingFrames == 0)
+                cerr << "Application::checkAllocations(): frame " << frame << " allocated " << frameAllocations << " times!" << endl;
+            allocations += frameAllocations;
+            ++allocatingFrames;
+        }
     }
+
+    cout << "Allocations: " << allocations << " in " << allocatingFrames << " of " << frames << " frames" << endl;
+    return allocatingFrames == 0;
+}
+
+bool Application::playReplay(const std::string& path, float speed)
+{
+    Replay replay;
+    if (!loadReplay(path, &replay))
+        return false;
+
+    m_stateManager->playReplay(replay, speed);
+    return true;
+}
+
+void Application::startLevel(int levelIndex)
+{
+    m_stateManager->setNextLevelForGameState(levelIndex);
+    m_stateManager->replaceCurrentState(StateManager::StateID::Game);
+}
+
+void Application::setAISnakeCount(int count)
+{
+    m_stateManager->setAISnakeCountForGameState(count);
+}
+
+void Application::setMaxCatchUpSteps(int steps)
+{
+    m_maxStepsPerFrame = 1 + std::max(0, steps);
+    m_stateManager->setMaxCatchUpTicksForGameState(steps);
+}
+
+void Application::setTickRate(int ticksPerSecond)
+{
+    m_stateManager->setTickRateForGameState(ticksPerSecond);
+}
+
+bool Application::hostNetworkGame(std::uint16_t port, int playerCount, int levelIndex)
+{
+    if (levelIndex >= 0)
+        m_stateManager->setNextLevelForGameState(levelIndex);
+    return m_stateManager->hostNetworkGame(port, playerCount);
+}
+
+bool Application::joinNetworkGame(const std::string& host, std::uint16_t port)
+{
+    return m_stateManager->joinNetworkGame(host, port);
+}
+
+bool Application::serveSpectators(std::uint16_t port)
+{
+    return m_stateManager->serveSpectators(port);
+}
+
+bool Application::spectateGame(const std::string& host, std::uint16_t port)
+{
+    return m_stateManager->spectateGame(host, port);
 }
 
 void Application::processEvents()
 {
+    SNAKE_PROFILE_SCOPE("processEvents");
     m_stateManager->processEvents();
 }
 
 void Application::processInput()
 {
+    SNAKE_PROFILE_SCOPE("processInput");
 	m_stateManager->processInput();
 }
 
 void Application::update(sf::Time elapsedTime)
 {
+    SNAKE_PROFILE_SCOPE("update");
 	m_stateManager->update(elapsedTime);
 }
 
 void Application::render()
 {
+    SNAKE_PROFILE_SCOPE("render");
 	m_stateManager->render();
+
+    if (FrameProfiler::isEnabled() && m_showProfilerOverlay)
+    {
+        SNAKE_PROFILE_SCOPE("render profiler overlay");
+        if (++m_framesSinceOverlayUpdate >= FRAMES_PER_OVERLAY_UPDATE)
+            updateProfilerOverlay();
+
+        // Draw in screen space, states may have moved the view
+        const sf::View view = m_window->getView();
+        m_window->setView(m_window->getDefaultView());
+        m_window->draw(m_profilerBackground);
+        m_window->draw(m_profilerText);
+        m_window->setView(view);
+    }
+
+    {
+        SNAKE_PROFILE_SCOPE("display");
+        m_window->display();
+    }
+}
+
+void Application::initProfilerOverlay()
+{
+    auto font = m_resourceManager->getFont("font_menu");
+    if (font)
+        m_profilerText.setFont(*font);
+    else
+        cerr << "Application::initProfilerOverlay(): error getting font!" << endl;
+
+    m_profilerText.setCharacterSize(12);
+    m_profilerText.setFillColor(sf::Color::White);
+    m_profilerText.setPosition(10.0f, 10.0f);
+    m_profilerBackground.setFillColor(sf::Color(0, 0, 0, 160));
+    m_profilerBackground.setPosition(5.0f, 5.0f);
+    updateProfilerOverlay();
+
+    cout << "Profiler: F2 toggles the overlay, F3 writes a trace to the profiles folder" << endl;
+}
+
+void Application::updateProfilerOverlay()
+{
+    m_framesSinceOverlayUpdate = 0;
+
+    char line[96];
+    std::string text;
+    const char* const SAMPLE_NAMES[] = {"frame", "update", "render"};
+    for (std::size_t i = 0; i < static_cast<std::size_t>(FrameProfiler::Sample::Count); ++i)
+    {
+        const FrameProfiler::Percentiles percentiles = FrameProfiler::getPercentiles(static_cast<FrameProfiler::Sample>(i));
+        std::snprintf(line, sizeof(line), "%-7s p50 %6.2f  p95 %6.2f  p99 %6.2f ms\n",
+            SAMPLE_NAMES[i], percentiles.p50, percentiles.p95, percentiles.p99);
+        text += line;
+    }
+    std::snprintf(line, sizeof(line), "catch-up frames %d, max steps per frame %d, dropped steps %d",
+        FrameProfiler::getCatchUpFrameCount(), FrameProfiler::getMaxFixedSteps(), FrameProfiler::getDroppedStepCount());
+    text += line;
+
+    m_profilerText.setString(text);
+    const sf::FloatRect bounds = m_profilerText.getGlobalBounds();
+    m_profilerBackground.setSize(sf::Vector2f(bounds.left + bounds.width + 5.0f, bounds.top + bounds.height + 5.0f) - m_profilerBackground.getPosition());
+}
+
+void Application::processProfilerKeys()
+{
+    // Polled instead of handled as events, the states own the event queue
+    const bool overlayKeyDown = m_window->hasFocus() && sf::Keyboard::isKeyPressed(sf::Keyboard::F2);
+    const bool traceKeyDown = m_window->hasFocus() && sf::Keyboard::isKeyPressed(sf::Keyboard::F3);
+
+    if (overlayKeyDown && !m_overlayKeyWasDown)
+    {
+        m_showProfilerOverlay = !m_showProfilerOverlay;
+        if (m_showProfilerOverlay)
+            updateProfilerOverlay();
+    }
+
+    if (traceKeyDown && !m_traceKeyWasDown)
+    {
+        std::error_code error;
+        std::filesystem::create_directories("profiles", error);
+
+        const std::string path = "profiles/trace_" + std::to_string(FrameProfiler::getTimestamp()) + ".json";
+        if (FrameProfiler::writeTrace(path))
+            cout << "Trace of the last frames saved to " << path << endl;
+    }
+
+    m_overlayKeyWasDown = overlayKeyDown;
+    m_traceKeyWasDown = traceKeyDown;
 }
 
 void Application::setIcon()
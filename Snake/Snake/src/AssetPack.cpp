@@ -0,0 +1,162 @@
+#include "AssetPack.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack::AssetPack()
+{
+}
+
+AssetPack::~AssetPack()
+{
+    close();
+}
+
+bool AssetPack::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat fileInfo;
+    if (fstat(file, &fileInfo) != 0 || fileInfo.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<std::size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping stays valid after the descriptor is closed
+    ::close(file);
+    if (view == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<std::size_t>(fileInfo.st_size);
+#endif
+
+    if (!validate())
+    {
+        std::cerr << "AssetPack: " << path << " is damaged or has the wrong version" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::close()
+{
+    if (!m_data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mappingHandle);
+    CloseHandle(m_fileHandle);
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool AssetPack::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+const AssetPackEntry* AssetPack::findEntry(const std::string& identifier) const
+{
+    if (!m_data || identifier.size() >= ASSET_IDENTIFIER_LENGTH)
+        return nullptr;
+
+    const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(m_data);
+    const AssetPackEntry* entries = reinterpret_cast<const AssetPackEntry*>(m_data + sizeof(AssetPackHeader));
+
+    // Only a handful of entries, a linear search is fine
+    for (std::uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        if (std::strncmp(entries[i].identifier, identifier.c_str(), ASSET_IDENTIFIER_LENGTH) == 0)
+            return &entries[i];
+    }
+    return nullptr;
+}
+
+const void* AssetPack::getData(const AssetPackEntry& entry) const
+{
+    return m_data + entry.offset;
+}
+
+bool AssetPack::validate() const
+{
+    if (m_size < sizeof(AssetPackHeader))
+        return false;
+
+    const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(m_data);
+    if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION)
+        return false;
+
+    const std::size_t tableEnd = sizeof(AssetPackHeader) + static_cast<std::size_t>(header->entryCount) * sizeof(AssetPackEntry);
+    if (tableEnd > m_size)
+        return false;
+
+    const AssetPackEntry* entries = reinterpret_cast<const AssetPackEntry*>(m_data + sizeof(AssetPackHeader));
+    for (std::uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        const AssetPackEntry& entry = entries[i];
+        if (entry.identifier[ASSET_IDENTIFIER_LENGTH - 1] != '\0')
+            return false;
+        if (entry.offset % ASSET_PACK_ALIGNMENT != 0 || entry.offset < tableEnd || entry.offset > m_size
+            || entry.size > m_size - entry.offset)
+            return false;
+    }
+    return true;
+}
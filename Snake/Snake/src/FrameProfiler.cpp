@@ -0,0 +1,175 @@
+#include "FrameProfiler.hpp"
+
+#ifdef SNAKE_PROFILER
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        std::int64_t begin;
+        std::int64_t duration;
+    };
+
+    struct FrameSample
+    {
+        std::array<std::int64_t, static_cast<std::size_t>(FrameProfiler::Sample::Count)> times {};
+        int fixedSteps {0};
+        int droppedSteps {0};
+    };
+
+    // Both are ring buffers, the oldest entries get overwritten
+    std::vector<TraceEvent> traceEvents;
+    std::size_t nextTraceEvent {0};
+    std::array<FrameSample, FrameProfiler::SAMPLE_FRAME_COUNT> frameSamples;
+    std::size_t nextFrameSample {0};
+    std::size_t frameSampleCount {0};
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+}
+
+std::int64_t FrameProfiler::getTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void FrameProfiler::recordScope(const char* name, std::int64_t begin, std::int64_t end)
+{
+    // Allocated once, recording a scope never allocates afterwards
+    if (traceEvents.empty())
+        traceEvents.resize(TRACE_EVENT_CAPACITY, TraceEvent {nullptr, 0, 0});
+
+    traceEvents[nextTraceEvent] = TraceEvent {name, begin, end - begin};
+    nextTraceEvent = (nextTraceEvent + 1) % TRACE_EVENT_CAPACITY;
+}
+
+void FrameProfiler::recordFrame(std::int64_t frameTime, std::int64_t updateTime, std::int64_t renderTime, int fixedSteps, int droppedSteps)
+{
+    FrameSample& sample = frameSamples[nextFrameSample];
+    sample.times[static_cast<std::size_t>(Sample::Frame)] = frameTime;
+    sample.times[static_cast<std::size_t>(Sample::Update)] = updateTime;
+    sample.times[static_cast<std::size_t>(Sample::Render)] = renderTime;
+    sample.fixedSteps = fixedSteps;
+    sample.droppedSteps = droppedSteps;
+
+    nextFrameSample = (nextFrameSample + 1) % SAMPLE_FRAME_COUNT;
+    frameSampleCount = std::min(frameSampleCount + 1, SAMPLE_FRAME_COUNT);
+}
+
+FrameProfiler::Percentiles FrameProfiler::getPercentiles(Sample sample)
+{
+    Percentiles percentiles;
+    if (frameSampleCount == 0)
+        return percentiles;
+
+    std::array<std::int64_t, SAMPLE_FRAME_COUNT> times;
+    for (std::size_t i = 0; i < frameSampleCount; ++i)
+        times[i] = frameSamples[i].times[static_cast<std::size_t>(sample)];
+
+    auto percentile = [&times](std::size_t count, std::size_t percent)
+    {
+        const std::size_t index = std::min(count - 1, count * percent / 100);
+        std::nth_element(times.begin(), times.begin() + index, times.begin() + count);
+        return static_cast<float>(times[index]) / 1000.0f;
+    };
+    percentiles.p50 = percentile(frameSampleCount, 50);
+    percentiles.p95 = percentile(frameSampleCount, 95);
+    percentiles.p99 = percentile(frameSampleCount, 99);
+    return percentiles;
+}
+
+int FrameProfiler::getMaxFixedSteps()
+{
+    int maxFixedSteps = 0;
+    for (std::size_t i = 0; i < frameSampleCount; ++i)
+        maxFixedSteps = std::max(maxFixedSteps, frameSamples[i].fixedSteps);
+    return maxFixedSteps;
+}
+
+int FrameProfiler::getCatchUpFrameCount()
+{
+    int catchUpFrames = 0;
+    for (std::size_t i = 0; i < frameSampleCount; ++i)
+    {
+        if (frameSamples[i].fixedSteps > 1)
+            ++catchUpFrames;
+    }
+    return catchUpFrames;
+}
+
+int FrameProfiler::getDroppedStepCount()
+{
+    int droppedSteps = 0;
+    for (std::size_t i = 0; i < frameSampleCount; ++i)
+        droppedSteps += frameSamples[i].droppedSteps;
+    return droppedSteps;
+}
+
+bool FrameProfiler::writeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        std::cerr << "FrameProfiler::writeTrace(): could not open " << path << "!" << std::endl;
+        return false;
+    }
+
+    file << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (std::size_t i = 0; i < traceEvents.size(); ++i)
+    {
+        // Oldest first, unused slots have no name
+        const TraceEvent& event = traceEvents[(nextTraceEvent + i) % traceEvents.size()];
+        if (!event.name)
+            continue;
+
+        if (!first)
+            file << ",\n";
+        first = false;
+        file << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"ts\":" << event.begin
+            << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":1}";
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return static_cast<bool>(file);
+}
+#else
+void FrameProfiler::recordScope(const char*, std::int64_t, std::int64_t)
+{
+}
+
+void FrameProfiler::recordFrame(std::int64_t, std::int64_t, std::int64_t, int, int)
+{
+}
+
+FrameProfiler::Percentiles FrameProfiler::getPercentiles(Sample)
+{
+    return Percentiles();
+}
+
+int FrameProfiler::getMaxFixedSteps()
+{
+    return 0;
+}
+
+int FrameProfiler::getCatchUpFrameCount()
+{
+    return 0;
+}
+
+int FrameProfiler::getDroppedStepCount()
+{
+    return 0;
+}
+
+bool FrameProfiler::writeTrace(const std::string&)
+{
+    return false;
+}
+#endif
@@ -1,93 +1,44 @@
 #include "GameGrid.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 
 using std::cout;
 using std::cerr;
 using std::endl;
 
-bool GameGrid::loadFromArray(std::vector<int> level, int width, int height, sf::Vector2u tileSize)
+namespace
 {
-	if(level.size() != width * height)
-	{
-		cerr << "Size of level data is not equal (width * height)!" << endl;
-		return false;
-	}
-
-	m_width = width;
-	m_height = height;
-	m_grid.resize(width * height * 4);
-
-	// Resize the vertex array to fit the level size
-	m_vertices.setPrimitiveType(sf::Quads);
-	m_vertices.resize(width * height * 4);
-
-	int teleportOneCount = 0;
-	int teleportTwoCount = 0;
-
-    sf::Vector2i teleportOnePos1;
-    sf::Vector2i teleportOnePos2;
-    sf::Vector2i teleportTwoPos1;
-    sf::Vector2i teleportTwoPos2;
-
-	// Populate the vertex array, with one quad per tile
-	for (unsigned int i = 0; i < width; ++i)
-		for (unsigned int j = 0; j < height; ++j)
-		{
-			// Get the current tile number
-			int intValue = level[i + j * width];
-			TileValue tileValue = static_cast<TileValue>(intValue);
-
-            // Check for teleporter tiles
-			if (tileValue == TileValue::Teleport1)
-			{
-                if (teleportOneCount == 0)
-                    teleportOnePos1 = sf::Vector2i(i, j);
-                else if (teleportOneCount == 1)
-                    teleportOnePos2 = sf::Vector2i(i, j);
-			    ++teleportOneCount;
-			}
-			else if (tileValue == TileValue::Teleport2)
-			{
-                if (teleportTwoCount == 0)
-                    teleportTwoPos1 = sf::Vector2i(i, j);
-                else if (teleportTwoCount == 1)
-                    teleportTwoPos2 = sf::Vector2i(i, j);
-				++teleportTwoCount;
-			}
-
-			// Get a pointer to the current tile's quad
-			sf::Vertex* quad = &m_vertices[(i + j * width) * 4];
-
-			// Define its 4 corners
-			quad[0].position = sf::Vector2f(i * tileSize.x, j * tileSize.y);
-			quad[1].position = sf::Vector2f((i + 1) * tileSize.x, j * tileSize.y);
-			quad[2].position = sf::Vector2f((i + 1) * tileSize.x, (j + 1) * tileSize.y);
-			quad[3].position = sf::Vector2f(i * tileSize.x, (j + 1) * tileSize.y);
-
-			// Set color of quad
-			sf::Color tileColor = getColorFromTileValue(tileValue);
-			for (std::size_t k = 0; k < 4; ++k)
-				quad[k].color = tileColor;
+    // Geometry of chunks that were not drawn for this many frames is released again
+    const unsigned int FRAMES_TO_KEEP_GEOMETRY = 120;
+    const int CHUNK_AREA = GameGrid::CHUNK_SIZE * GameGrid::CHUNK_SIZE;
+}
 
-			// set logical tile value
-			m_grid[i + j * width] = intValue;
-		}
+void GameGrid::loadFromTileGrid(const TileGrid& tileGrid, sf::Vector2u tileSize)
+{
+	m_width = tileGrid.getWidth();
+	m_height = tileGrid.getHeight();
+    m_tileSize = tileSize;
+    m_chunksPerRow = (m_width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    m_chunkRows = (m_height + CHUNK_SIZE - 1) / CHUNK_SIZE;
 
-    // Only none or exactly one pair of each teleporter type is allowed in a level
-	if(!(teleportOneCount == 0 || teleportOneCount == 2) || !(teleportTwoCount == 0 || teleportTwoCount == 2))
-	{
-		cerr << "count of teleporter tiles not valid!" << endl;
-		return false;
-	}
+    // Only the tile values are copied, quads are built per chunk once it is visible
+    m_tiles.assign(static_cast<std::size_t>(m_chunksPerRow) * m_chunkRows * CHUNK_AREA, TileValue::NoPlayArea);
+    for (int y = 0; y < m_height; ++y)
+    {
+        for (int x = 0; x < m_width; ++x)
+            tileGrid.getTileValueAt(x, y, &m_tiles[getTileIndex(x, y)]);
+    }
 
-    // Save the valid teleporter positions in a pair
-    if(teleportOneCount == 2)
-        m_teleporterPair1 = std::make_optional<TeleporterPair>(teleportOnePos1, teleportOnePos2);
-    if(teleportTwoCount == 2)
-        m_teleporterPair2 = std::make_optional<TeleporterPair>(teleportTwoPos1, teleportTwoPos2);
+    m_chunkGeometry.clear();
+    m_chunkGeometry.resize(static_cast<std::size_t>(m_chunksPerRow) * m_chunkRows);
+    m_chunksWithGeometry.clear();
+    m_drawnChunkCount = 0;
 
-	return true;
+    m_useVertexBuffer = sf::VertexBuffer::isAvailable();
+    if (!m_useVertexBuffer)
+        cerr << "GameGrid: vertex buffers not available, drawing from vertex arrays" << endl;
 }
 
 void GameGrid::updateTile(int x, int y, TileValue value)
@@ -98,18 +49,23 @@ void GameGrid::updateTile(int x, int y, TileValue value)
         return;
     }
 
-    int intValue = static_cast<int>(value);
+    const std::size_t tileIndex = getTileIndex(x, y);
+    m_tiles[tileIndex] = value;
 
-    // Get a pointer to the current tile's quad
-    sf::Vertex* quad = &m_vertices[(x + y * m_width) * 4];
+    // Chunks without geometry pick the value up when they are built
+    ChunkGeometry* geometry = m_chunkGeometry[tileIndex / CHUNK_AREA].get();
+    if (!geometry)
+        return;
 
     // Set color of quad
+    const int chunkTile = static_cast<int>(tileIndex % CHUNK_AREA);
+    sf::Vertex* quad = &geometry->vertices[chunkTile * 4];
     sf::Color tileColor = getColorFromTileValue(value);
     for (std::size_t k = 0; k < 4; ++k)
         quad[k].color = tileColor;
 
-    // Set logical tile value
-    m_grid[x + y * m_width] = intValue;
+    if (m_useVertexBuffer)
+        geometry->dirtyTiles.push_back(chunkTile);
 }
 
 void GameGrid::updateTile(sf::Vector2i position, TileValue value)
@@ -127,57 +83,155 @@ bool GameGrid::isValidPosition(sf::Vector2i position) const
     return isValidPosition(position.x, position.y);
 }
 
-bool GameGrid::getTileValueAt(int x, int y, TileValue* const tileValueToSet) const
+sf::Vector2f GameGrid::getSize() const
 {
-    if (!isValidPosition(x, y))
-        return false;
+    return sf::Vector2f(static_cast<float>(m_width * m_tileSize.x), static_cast<float>(m_height * m_tileSize.y));
+}
 
-    *tileValueToSet = static_cast<TileValue>(m_grid[x + y * m_width]);
-    return true;
+sf::Vector2u GameGrid::getTileSize() const
+{
+    return m_tileSize;
 }
 
-bool GameGrid::getTileValueAt(sf::Vector2i position, TileValue* const tileValueToSet) const
+std::size_t GameGrid::getDrawnChunkCount() const
+{
+    return m_drawnChunkCount;
+}
+
+void GameGrid::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    return getTileValueAt(position.x, position.y, tileValueToSet);
+	states.transform *= getTransform();
+    ++m_frame;
+    m_drawnChunkCount = 0;
+
+    if (m_tileSize.x == 0 || m_tileSize.y == 0 || m_chunkGeometry.empty())
+        return;
+
+    // Visible area in grid pixels, views are never rotated here so the bounding box is exact
+    const sf::View& view = target.getView();
+    const sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+    const sf::FloatRect visible = getInverseTransform().transformRect(viewRect);
+
+    const float chunkWidth = static_cast<float>(CHUNK_SIZE * m_tileSize.x);
+    const float chunkHeight = static_cast<float>(CHUNK_SIZE * m_tileSize.y);
+    const int firstColumn = std::max(0, static_cast<int>(std::floor(visible.left / chunkWidth)));
+    const int firstRow = std::max(0, static_cast<int>(std::floor(visible.top / chunkHeight)));
+    const int lastColumn = std::min(m_chunksPerRow - 1, static_cast<int>(std::floor((visible.left + visible.width) / chunkWidth)));
+    const int lastRow = std::min(m_chunkRows - 1, static_cast<int>(std::floor((visible.top + visible.height) / chunkHeight)));
+
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            const int chunkIndex = column + row * m_chunksPerRow;
+            if (!m_chunkGeometry[chunkIndex])
+                buildChunkGeometry(chunkIndex);
+
+            ChunkGeometry& geometry = *m_chunkGeometry[chunkIndex];
+            geometry.lastDrawnFrame = m_frame;
+            if (m_useVertexBuffer)
+            {
+                uploadDirtyTiles(geometry);
+                target.draw(geometry.vertexBuffer, states);
+            }
+            else
+                target.draw(geometry.vertices, states);
+            ++m_drawnChunkCount;
+        }
+    }
+
+    releaseUnusedGeometry();
 }
 
-void GameGrid::getListOfEmptyTiles(std::vector<sf::Vector2i>* tileList) const
+std::size_t GameGrid::getTileIndex(int x, int y) const
 {
-    // Could be optimized with a cached list
-    for (unsigned int i = 0; i < m_width; ++i)
-        for (unsigned int j = 0; j < m_height; ++j)
-            if(TileValue::Empty == static_cast<TileValue>(m_grid[i + j * m_width]))
-                tileList->emplace_back(i, j);   
+    const int chunkIndex = x / CHUNK_SIZE + (y / CHUNK_SIZE) * m_chunksPerRow;
+    return static_cast<std::size_t>(chunkIndex) * CHUNK_AREA + (x % CHUNK_SIZE) + (y % CHUNK_SIZE) * CHUNK_SIZE;
 }
 
-std::optional<sf::Vector2i> GameGrid::getPositionOfOtherTeleporter1(sf::Vector2i position) const
+void GameGrid::buildChunkGeometry(int chunkIndex) const
 {
-    if(m_teleporterPair1)
+    auto geometry = std::make_unique<ChunkGeometry>();
+    geometry->vertices.resize(CHUNK_AREA * 4);
+
+    const int chunkX = (chunkIndex % m_chunksPerRow) * CHUNK_SIZE;
+    const int chunkY = (chunkIndex / m_chunksPerRow) * CHUNK_SIZE;
+    const TileValue* tiles = &m_tiles[static_cast<std::size_t>(chunkIndex) * CHUNK_AREA];
+
+	// Populate the vertex array, with one quad per tile, padding tiles of edge chunks stay empty quads
+	for (int j = 0; j < CHUNK_SIZE; ++j)
     {
-        if(position == m_teleporterPair1->pos1)
-            return m_teleporterPair1->pos2;
-        if (position == m_teleporterPair1->pos2)
-            return m_teleporterPair1->pos1;
+		for (int i = 0; i < CHUNK_SIZE; ++i)
+		{
+            const int x = chunkX + i;
+            const int y = chunkY + j;
+            if (x >= m_width || y >= m_height)
+                continue;
+
+			// Get a pointer to the current tile's quad
+			sf::Vertex* quad = &geometry->vertices[(i + j * CHUNK_SIZE) * 4];
+
+			// Define its 4 corners
+			quad[0].position = sf::Vector2f(static_cast<float>(x * m_tileSize.x), static_cast<float>(y * m_tileSize.y));
+			quad[1].position = sf::Vector2f(static_cast<float>((x + 1) * m_tileSize.x), static_cast<float>(y * m_tileSize.y));
+			quad[2].position = sf::Vector2f(static_cast<float>((x + 1) * m_tileSize.x), static_cast<float>((y + 1) * m_tileSize.y));
+			quad[3].position = sf::Vector2f(static_cast<float>(x * m_tileSize.x), static_cast<float>((y + 1) * m_tileSize.y));
+
+			// Set color of quad
+			sf::Color tileColor = getColorFromTileValue(tiles[i + j * CHUNK_SIZE]);
+			for (std::size_t k = 0; k < 4; ++k)
+				quad[k].color = tileColor;
+		}
     }
-	return std::nullopt;
+
+    // Upload the whole chunk once, afterwards only changed tiles are sent
+    if (m_useVertexBuffer && !(geometry->vertexBuffer.create(geometry->vertices.getVertexCount())
+        && geometry->vertexBuffer.update(&geometry->vertices[0])))
+        cerr << "GameGrid: could not create the vertex buffer of chunk " << chunkIndex << "!" << endl;
+
+    m_chunkGeometry[chunkIndex] = std::move(geometry);
+    m_chunksWithGeometry.push_back(chunkIndex);
 }
 
-std::optional<sf::Vector2i> GameGrid::getPositionOfOtherTeleporter2(sf::Vector2i position) const
+void GameGrid::uploadDirtyTiles(ChunkGeometry& geometry) const
 {
-    if (m_teleporterPair2)
+    std::vector<int>& dirtyTiles = geometry.dirtyTiles;
+    if (dirtyTiles.empty())
+        return;
+
+    // Merge neighbouring tiles into ranges, so one update call covers each run of changed tiles
+    std::sort(dirtyTiles.begin(), dirtyTiles.end());
+
+    std::size_t rangeStart = 0;
+    for (std::size_t i = 1; i <= dirtyTiles.size(); ++i)
     {
-        if (position == m_teleporterPair2->pos1)
-            return m_teleporterPair2->pos2;
-        if (position == m_teleporterPair2->pos2)
-            return m_teleporterPair2->pos1;
+        if (i < dirtyTiles.size() && dirtyTiles[i] <= dirtyTiles[i - 1] + 1)
+            continue;
+
+        const unsigned int firstTile = static_cast<unsigned int>(dirtyTiles[rangeStart]);
+        const unsigned int tileCount = static_cast<unsigned int>(dirtyTiles[i - 1]) - firstTile + 1;
+        geometry.vertexBuffer.update(&geometry.vertices[firstTile * 4], tileCount * 4, firstTile * 4);
+        rangeStart = i;
     }
-    return std::nullopt;
+
+    dirtyTiles.clear();
 }
 
-void GameGrid::draw(sf::RenderTarget& target, sf::RenderStates states) const
+void GameGrid::releaseUnusedGeometry() const
 {
-	states.transform *= getTransform();
-	target.draw(m_vertices, states);
+    // Keeps memory bounded by the area the view moved over recently, not by the level size
+    for (std::size_t i = 0; i < m_chunksWithGeometry.size();)
+    {
+        const int chunkIndex = m_chunksWithGeometry[i];
+        if (m_frame - m_chunkGeometry[chunkIndex]->lastDrawnFrame > FRAMES_TO_KEEP_GEOMETRY)
+        {
+            m_chunkGeometry[chunkIndex].reset();
+            m_chunksWithGeometry[i] = m_chunksWithGeometry.back();
+            m_chunksWithGeometry.pop_back();
+        }
+        else
+            ++i;
+    }
 }
 
 sf::Color GameGrid::getColorFromTileValue(GameGrid::TileValue value)
@@ -0,0 +1,153 @@
+#include "GlyphAtlas.hpp"
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+namespace
+{
+    const unsigned int ATLAS_WIDTH = 1024;
+    // Transparent pixels around every glyph, like sf::Font, so filtering doesn't bleed in the neighbours
+    const int PADDING = 1;
+    const sf::Uint32 COPYRIGHT_SIGN = 0xA9;
+
+    std::vector<sf::Uint32> getCodePoints()
+    {
+        std::vector<sf::Uint32> codePoints;
+        for (sf::Uint32 codePoint = 32; codePoint < 127; ++codePoint)
+            codePoints.push_back(codePoint);
+        codePoints.push_back(COPYRIGHT_SIGN);
+        return codePoints;
+    }
+}
+
+void GlyphAtlas::addSize(unsigned int characterSize, float outlineThickness)
+{
+    auto addVariant = [this](unsigned int characterSize, float outlineThickness)
+    {
+        for (const Size& size : m_sizes)
+        {
+            if (size.characterSize == characterSize && size.outlineThickness == outlineThickness)
+                return;
+        }
+        m_sizes.push_back(Size {characterSize, outlineThickness});
+    };
+
+    addVariant(characterSize, 0.0f);
+    if (outlineThickness > 0.0f)
+        addVariant(characterSize, outlineThickness);
+}
+
+bool GlyphAtlas::build(const sf::Font& font)
+{
+    m_glyphs.clear();
+    m_sizeMetrics.clear();
+
+    struct PlacedGlyph
+    {
+        unsigned int characterSize;
+        sf::IntRect fontRect; // With padding, in the font's texture of the size
+        sf::Vector2i position; // In the atlas
+    };
+
+    // Rows of glyphs left to right, every row as high as its highest glyph. The top left corner is
+    // kept free for the white pixels
+    const std::vector<sf::Uint32> codePoints = getCodePoints();
+    std::vector<PlacedGlyph> placedGlyphs;
+    sf::Vector2i cursor(4, 0);
+    int rowHeight = 4;
+    for (const Size& size : m_sizes)
+    {
+        for (sf::Uint32 codePoint : codePoints)
+        {
+            const sf::Glyph& fontGlyph = font.getGlyph(codePoint, size.characterSize, false, size.outlineThickness);
+            Glyph& glyph = m_glyphs[getGlyphKey(codePoint, size.characterSize, size.outlineThickness)];
+            glyph.bounds = fontGlyph.bounds;
+            glyph.advance = fontGlyph.advance;
+            // Whitespace has nothing to draw
+            if (fontGlyph.textureRect.width <= 0 || fontGlyph.textureRect.height <= 0)
+                continue;
+
+            const sf::IntRect fontRect(fontGlyph.textureRect.left - PADDING, fontGlyph.textureRect.top - PADDING,
+                fontGlyph.textureRect.width + 2 * PADDING, fontGlyph.textureRect.height + 2 * PADDING);
+            if (cursor.x + fontRect.width > static_cast<int>(ATLAS_WIDTH))
+            {
+                cursor = sf::Vector2i(0, cursor.y + rowHeight);
+                rowHeight = 0;
+            }
+
+            glyph.textureRect = sf::IntRect(cursor.x + PADDING, cursor.y + PADDING, fontGlyph.textureRect.width, fontGlyph.textureRect.height);
+            placedGlyphs.push_back(PlacedGlyph {size.characterSize, fontRect, cursor});
+
+            cursor.x += fontRect.width;
+            rowHeight = std::max(rowHeight, fontRect.height);
+        }
+
+        if (size.outlineThickness == 0.0f)
+        {
+            const sf::FloatRect xBounds = font.getGlyph(L'x', size.characterSize, false).bounds;
+            SizeMetrics& metrics = m_sizeMetrics[size.characterSize];
+            metrics.lineSpacing = font.getLineSpacing(size.characterSize);
+            metrics.underlineThickness = font.getUnderlineThickness(size.characterSize);
+            metrics.strikeThroughOffset = xBounds.top + xBounds.height / 2.0f;
+        }
+    }
+
+    const unsigned int height = static_cast<unsigned int>(cursor.y + rowHeight);
+    if (height > sf::Texture::getMaximumSize())
+    {
+        std::cerr << "GlyphAtlas::build(): " << ATLAS_WIDTH << "x" << height << " is larger than the maximum texture size!" << std::endl;
+        return false;
+    }
+
+    sf::Image image;
+    image.create(ATLAS_WIDTH, height, sf::Color(255, 255, 255, 0));
+    for (unsigned int y = 0; y < 2; ++y)
+    {
+        for (unsigned int x = 0; x < 2; ++x)
+            image.setPixel(x, y, sf::Color::White);
+    }
+
+    // All glyphs of a size were requested above, so each of the font's textures is read back only once
+    std::map<unsigned int, sf::Image> fontImages;
+    for (const PlacedGlyph& placedGlyph : placedGlyphs)
+    {
+        auto fontImage = fontImages.find(placedGlyph.characterSize);
+        if (fontImage == fontImages.end())
+            fontImage = fontImages.emplace(placedGlyph.characterSize, font.getTexture(placedGlyph.characterSize).copyToImage()).first;
+        image.copy(fontImage->second, placedGlyph.position.x, placedGlyph.position.y, placedGlyph.fontRect);
+    }
+
+    if (!m_texture.loadFromImage(image))
+        return false;
+    m_texture.setSmooth(true);
+    return true;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::getGlyph(sf::Uint32 codePoint, unsigned int characterSize, float outlineThickness) const
+{
+    auto glyph = m_glyphs.find(getGlyphKey(codePoint, characterSize, outlineThickness));
+    return glyph != m_glyphs.end() ? &glyph->second : nullptr;
+}
+
+const GlyphAtlas::SizeMetrics* GlyphAtlas::getSizeMetrics(unsigned int characterSize) const
+{
+    auto metrics = m_sizeMetrics.find(characterSize);
+    return metrics != m_sizeMetrics.end() ? &metrics->second : nullptr;
+}
+
+const sf::Texture& GlyphAtlas::getTexture() const
+{
+    return m_texture;
+}
+
+sf::Vector2f GlyphAtlas::getWhitePixel() const
+{
+    return sf::Vector2f(1.0f, 1.0f);
+}
+
+std::uint64_t GlyphAtlas::getGlyphKey(sf::Uint32 codePoint, unsigned int characterSize, float outlineThickness)
+{
+    // Outlines in steps of 1/8 pixel
+    const std::uint64_t outline = static_cast<std::uint64_t>(outlineThickness * 8.0f + 0.5f) & 0xFF;
+    return (static_cast<std::uint64_t>(characterSize) << 40) | (outline << 32) | codePoint;
+}
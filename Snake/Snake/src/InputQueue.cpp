@@ -0,0 +1,82 @@
+#include "InputQueue.hpp"
+#include <algorithm>
+
+void InputQueue::clear(PlayerInput direction)
+{
+    m_first = 0;
+    m_size = 0;
+    m_direction = direction;
+    m_lastInput = direction;
+}
+
+bool InputQueue::push(PlayerInput input, std::int64_t time)
+{
+    if (input == m_direction || Simulation::isOppositeDirection(input, m_direction))
+        return false;
+    if (m_size == CAPACITY)
+    {
+        ++m_droppedCount;
+        return false;
+    }
+
+    m_turns[(m_first + m_size) % CAPACITY] = Turn {input, time};
+    ++m_size;
+    m_direction = input;
+    return true;
+}
+
+InputQueue::PlayerInput InputQueue::pop(std::int64_t tickTime)
+{
+    if (m_size == 0)
+        return m_lastInput;
+
+    const Turn& turn = m_turns[m_first];
+    m_first = (m_first + 1) % CAPACITY;
+    --m_size;
+
+    const std::int64_t latency = std::max<std::int64_t>(0, tickTime - turn.time);
+    m_latencies[m_latencyCount % LATENCY_SAMPLE_COUNT] = latency;
+    ++m_latencyCount;
+    m_maxLatency = std::max(m_maxLatency, latency);
+
+    m_lastInput = turn.input;
+    return turn.input;
+}
+
+std::size_t InputQueue::getSize() const
+{
+    return m_size;
+}
+
+long long InputQueue::getDroppedCount() const
+{
+    return m_droppedCount;
+}
+
+InputQueue::LatencyStats InputQueue::getLatencyStats() const
+{
+    LatencyStats stats;
+    stats.count = m_latencyCount;
+    stats.max = static_cast<float>(m_maxLatency) / 1000.0f;
+    const std::size_t sampleCount = static_cast<std::size_t>(std::min<long long>(m_latencyCount, LATENCY_SAMPLE_COUNT));
+    if (sampleCount == 0)
+        return stats;
+
+    std::array<std::int64_t, LATENCY_SAMPLE_COUNT> latencies = m_latencies;
+    auto percentile = [&latencies, sampleCount](std::size_t percent)
+    {
+        const std::size_t index = std::min(sampleCount - 1, sampleCount * percent / 100);
+        std::nth_element(latencies.begin(), latencies.begin() + index, latencies.begin() + sampleCount);
+        return static_cast<float>(latencies[index]) / 1000.0f;
+    };
+    stats.p50 = percentile(50);
+    stats.p95 = percentile(95);
+    return stats;
+}
+
+void InputQueue::resetStatistics()
+{
+    m_latencyCount = 0;
+    m_maxLatency = 0;
+    m_droppedCount = 0;
+}
@@ -1,156 +1,264 @@
 #include "ResourceManager.hpp"
+#include "ResourceList.hpp"
 
-bool ResourceManager::loadResources()
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+void ResourceManager::startLoading()
 {
-    //////// Fonts //////
+    if (!m_pendingResources.empty())
+        return;
 
-    std::shared_ptr<sf::Font> font = std::make_shared<sf::Font>();
-    if (!font->loadFromFile("resources/PressStart2P-Regular.ttf"))
-    {
-        return false;
-    }
-    m_fonts.emplace("font_menu", font);
+    m_loadingClock.restart();
 
-    //////// Textures //////
+    if (m_assetPack.open(ASSET_PACK_PATH))
+        std::cout << "Loading resources from " << ASSET_PACK_PATH << std::endl;
 
-    std::shared_ptr<sf::Texture> texture = std::make_shared<sf::Texture>();
-    if (!texture->loadFromFile("resources/img/level1.png"))
-    {
-        return false;
-    }
-    m_textures.emplace("level1", texture);
+    for (const auto& resource : RESOURCE_LIST)
+        queueResource(resource.identifier, resource.type, resource.path);
+}
 
-	texture = std::make_shared<sf::Texture>();
-    if (!texture->loadFromFile("resources/img/level1_selected.png"))
-    {
-        return false;
-    }
-    m_textures.emplace("level1_selected", texture);
+bool ResourceManager::processLoadedResources()
+{
+    if (m_uploadedResourceCount == m_pendingResources.size())
+        return true;
 
-    texture = std::make_shared<sf::Texture>();
-    if (!texture->loadFromFile("resources/img/level2.png"))
+    for (auto& resource : m_pendingResources)
     {
-        return false;
+        if (resource.uploaded)
+            continue;
+        if (resource.packEntry || resource.decoded.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            uploadResource(resource);
     }
-    m_textures.emplace("level2", texture);
 
-	texture = std::make_shared<sf::Texture>();
-    if (!texture->loadFromFile("resources/img/level2_selected.png"))
-    {
-        return false;
-    }
-    m_textures.emplace("level2_selected", texture);
+    return m_uploadedResourceCount == m_pendingResources.size();
+}
 
-    texture = std::make_shared<sf::Texture>();
-    if (!texture->loadFromFile("resources/img/level3.png"))
+bool ResourceManager::waitForResource(const std::string& identifier)
+{
+    for (auto& resource : m_pendingResources)
     {
-        return false;
+        if (resource.identifier == identifier)
+        {
+            if (!resource.uploaded)
+                uploadResource(resource);
+            return resource.success;
+        }
     }
-    m_textures.emplace("level3", texture);
+    return false;
+}
 
-    texture = std::make_shared<sf::Texture>();
-    if (!texture->loadFromFile("resources/img/level3_selected.png"))
+bool ResourceManager::isResourceReady(const std::string& identifier) const
+{
+    for (const auto& resource : m_pendingResources)
     {
-        return false;
+        if (resource.identifier == identifier)
+            return resource.uploaded && resource.success;
     }
-    m_textures.emplace("level3_selected", texture);
+    return false;
+}
 
-    //////// SoundBuffers //////
+bool ResourceManager::loadResources()
+{
+    startLoading();
 
-    std::shared_ptr<sf::SoundBuffer> soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/food.wav"))
+    bool success = true;
+    for (auto& resource : m_pendingResources)
     {
-        return false;
+        if (!waitForResource(resource.identifier))
+            success = false;
     }
-    m_soundBuffers.emplace("sound_food", soundBuffer);
+    processLoadedResources();
+    return success;
+}
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/food_big.wav"))
+std::shared_ptr<sf::Font> ResourceManager::getFont(const std::string & identifier) const
+{
+    if (m_fonts.find(identifier) != m_fonts.end())
     {
-        return false;
+        return m_fonts.at(identifier);
     }
-    m_soundBuffers.emplace("sound_food_big", soundBuffer);
+    return nullptr;
+}
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/teleport.wav"))
+std::shared_ptr<sf::Texture> ResourceManager::getTexture(const std::string & identifier) const
+{
+    if (m_textures.find(identifier) != m_textures.end())
     {
-        return false;
+        return m_textures.at(identifier);
     }
-    m_soundBuffers.emplace("sound_teleport", soundBuffer);
+    return nullptr;
+}
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/movement.wav"))
+std::shared_ptr<sf::SoundBuffer> ResourceManager::getSoundBuffer(const std::string & identifier) const
+{
+    if (m_soundBuffers.find(identifier) != m_soundBuffers.end())
     {
-        return false;
+        return m_soundBuffers.at(identifier);
     }
-    m_soundBuffers.emplace("sound_movement", soundBuffer);
+    return nullptr;
+}
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/movement_growing.wav"))
-    {
-        return false;
-    }
-    m_soundBuffers.emplace("sound_movement_growing", soundBuffer);
+std::shared_ptr<const GlyphAtlas> ResourceManager::getGlyphAtlas(const std::string& fontIdentifier)
+{
+    auto atlas = m_glyphAtlases.find(fontIdentifier);
+    if (atlas != m_glyphAtlases.end())
+        return atlas->second;
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/collision.wav"))
-    {
-        return false;
-    }
-    m_soundBuffers.emplace("sound_collision", soundBuffer);
+    std::shared_ptr<sf::Font> font = getFont(fontIdentifier);
+    if (!font || !isResourceReady(fontIdentifier))
+        return nullptr;
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/ui.wav"))
+    sf::Clock clock;
+    auto newAtlas = std::make_shared<GlyphAtlas>();
+    for (const FontSizeDescription& size : MENU_FONT_SIZES)
+        newAtlas->addSize(size.characterSize, size.outlineThickness);
+    if (!newAtlas->build(*font))
     {
-        return false;
+        std::cerr << "ResourceManager::getGlyphAtlas(): error building the glyph atlas of " << fontIdentifier << "!" << std::endl;
+        return nullptr;
     }
-    m_soundBuffers.emplace("sound_ui", soundBuffer);
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/ui_confirm.wav"))
+    const sf::Vector2u textureSize = newAtlas->getTexture().getSize();
+    std::cout << "Glyph atlas of " << fontIdentifier << ": " << textureSize.x << "x" << textureSize.y << " in "
+        << clock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    m_glyphAtlases.emplace(fontIdentifier, newAtlas);
+    return newAtlas;
+}
+
+void ResourceManager::queueResource(const std::string& identifier, AssetType type, const std::string& path)
+{
+    // The objects exist from the start so states can keep pointers to them while they load
+    switch (type)
     {
-        return false;
+    case AssetType::Font:
+        m_fonts.emplace(identifier, std::make_shared<sf::Font>());
+        break;
+    case AssetType::Texture:
+        m_textures.emplace(identifier, std::make_shared<sf::Texture>());
+        break;
+    case AssetType::SoundBuffer:
+        m_soundBuffers.emplace(identifier, std::make_shared<sf::SoundBuffer>());
+        break;
     }
-    m_soundBuffers.emplace("sound_ui_confirm", soundBuffer);
 
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/volume_up.wav"))
+    PendingResource resource;
+    resource.identifier = identifier;
+    resource.type = type;
+    resource.path = path;
+
+    // Resources in the pack need no decoding, anything missing from it still comes from its file
+    resource.packEntry = m_assetPack.isOpen() ? m_assetPack.findEntry(identifier) : nullptr;
+    if (resource.packEntry && resource.packEntry->type != type)
+        resource.packEntry = nullptr;
+    if (!resource.packEntry)
+        resource.decoded = std::async(std::launch::async, &ResourceManager::decodeResource, type, path);
+    m_pendingResources.push_back(std::move(resource));
+}
+
+ResourceManager::DecodedResource ResourceManager::decodeResource(AssetType type, const std::string& path)
+{
+    // Runs on a worker thread, must not touch OpenGL or OpenAL
+    DecodedResource decoded;
+
+    switch (type)
+    {
+    case AssetType::Font:
     {
-        return false;
+        std::ifstream file(path, std::ios::binary);
+        if (file)
+        {
+            decoded.fileData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            decoded.success = !decoded.fileData.empty();
+        }
+        break;
     }
-    m_soundBuffers.emplace("sound_volume_up", soundBuffer);
-
-    soundBuffer = std::make_shared<sf::SoundBuffer>();
-    if (!soundBuffer->loadFromFile("resources/sounds/volume_down.wav"))
+    case AssetType::Texture:
+        decoded.success = decoded.image.loadFromFile(path);
+        break;
+    case AssetType::SoundBuffer:
     {
-        return false;
+        sf::InputSoundFile soundFile;
+        if (soundFile.openFromFile(path))
+        {
+            decoded.samples.resize(static_cast<std::size_t>(soundFile.getSampleCount()));
+            decoded.channelCount = soundFile.getChannelCount();
+            decoded.sampleRate = soundFile.getSampleRate();
+            decoded.success = soundFile.read(decoded.samples.data(), decoded.samples.size()) == decoded.samples.size();
+        }
+        break;
+    }
     }
-    m_soundBuffers.emplace("sound_volume_down", soundBuffer);
+
+    return decoded;
 }
 
-std::shared_ptr<sf::Font> ResourceManager::getFont(const std::string & identifier) const
+bool ResourceManager::uploadResource(PendingResource& resource)
 {
-    if (m_fonts.find(identifier) != m_fonts.end())
+    resource.uploaded = true;
+
+    if (resource.packEntry)
     {
-        return m_fonts.at(identifier);
+        resource.success = uploadFromAssetPack(resource);
+    }
+    else if (DecodedResource decoded = resource.decoded.get(); decoded.success)
+    {
+        switch (resource.type)
+        {
+        case AssetType::Font:
+            // sf::Font reads from the buffer for its whole lifetime
+            m_fontData[resource.identifier] = std::move(decoded.fileData);
+            resource.success = m_fonts.at(resource.identifier)->loadFromMemory(m_fontData[resource.identifier].data(),
+                m_fontData[resource.identifier].size());
+            break;
+        case AssetType::Texture:
+            resource.success = m_textures.at(resource.identifier)->loadFromImage(decoded.image);
+            break;
+        case AssetType::SoundBuffer:
+            resource.success = m_soundBuffers.at(resource.identifier)->loadFromSamples(decoded.samples.data(),
+                decoded.samples.size(), decoded.channelCount, decoded.sampleRate);
+            break;
+        }
     }
-    return nullptr;
-}
 
-std::shared_ptr<sf::Texture> ResourceManager::getTexture(const std::string & identifier) const
-{
-    if (m_textures.find(identifier) != m_textures.end())
+    if (!resource.success)
+        std::cerr << "ResourceManager: error loading " << resource.path << std::endl;
+
+    if (++m_uploadedResourceCount == m_pendingResources.size())
     {
-        return m_textures.at(identifier);
+        std::cout << "Loaded " << m_pendingResources.size() << " resources in "
+            << m_loadingClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
     }
-    return nullptr;
+
+    return resource.success;
 }
 
-std::shared_ptr<sf::SoundBuffer> ResourceManager::getSoundBuffer(const std::string & identifier) const
+bool ResourceManager::uploadFromAssetPack(const PendingResource& resource)
 {
-    if (m_soundBuffers.find(identifier) != m_soundBuffers.end())
+    const AssetPackEntry& entry = *resource.packEntry;
+    const void* data = m_assetPack.getData(entry);
+
+    switch (resource.type)
     {
-        return m_soundBuffers.at(identifier);
+    case AssetType::Font:
+        return m_fonts.at(resource.identifier)->loadFromMemory(data, static_cast<std::size_t>(entry.size));
+    case AssetType::Texture:
+    {
+        const unsigned int width = entry.widthOrChannelCount;
+        const unsigned int height = entry.heightOrSampleRate;
+        if (entry.size != static_cast<std::uint64_t>(width) * height * 4)
+            return false;
+
+        auto texture = m_textures.at(resource.identifier);
+        if (!texture->create(width, height))
+            return false;
+        texture->update(static_cast<const sf::Uint8*>(data));
+        return true;
     }
-    return nullptr;
+    case AssetType::SoundBuffer:
+        return m_soundBuffers.at(resource.identifier)->loadFromSamples(static_cast<const sf::Int16*>(data),
+            static_cast<sf::Uint64>(entry.size / sizeof(sf::Int16)), entry.widthOrChannelCount, entry.heightOrSampleRate);
+    }
+    return false;
 }
@@ -0,0 +1,115 @@
+#include "SnakeMotionLayer.hpp"
+#include "GameGrid.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    // Neighbouring tiles, anything else is a jump
+    sf::Vector2i getStep(sf::Vector2i from, sf::Vector2i to)
+    {
+        const sf::Vector2i difference = to - from;
+        if (from.x < 0 || to.x < 0 || std::abs(difference.x) + std::abs(difference.y) != 1)
+            return sf::Vector2i();
+        return difference;
+    }
+
+    // The part of a tile that is not yet entered (or not yet left) after moving progress along direction
+    void getRemainingPart(sf::Vector2i tile, sf::Vector2i direction, float progress, sf::Vector2f* position, sf::Vector2f* size)
+    {
+        *position = sf::Vector2f(tile);
+        *size = sf::Vector2f(1.0f, 1.0f);
+        if (direction.x != 0)
+        {
+            position->x += direction.x > 0 ? progress : 0.0f;
+            size->x = 1.0f - progress;
+        }
+        else
+        {
+            position->y += direction.y > 0 ? progress : 0.0f;
+            size->y = 1.0f - progress;
+        }
+    }
+}
+
+void SnakeMotionLayer::setTileSize(sf::Vector2u tileSize)
+{
+    m_tileSize = sf::Vector2f(tileSize);
+}
+
+void SnakeMotionLayer::reset(int snakeCount)
+{
+    m_snakes.assign(static_cast<std::size_t>(std::max(0, snakeCount)), SnakeMotion());
+}
+
+void SnakeMotionLayer::setSnake(int index, sf::Vector2i head, sf::Vector2i tail, bool isAlive)
+{
+    if (index < 0 || index >= static_cast<int>(m_snakes.size()))
+        return;
+
+    SnakeMotion& snake = m_snakes[index];
+    snake.headMovement = isAlive ? getStep(snake.head, head) : sf::Vector2i();
+    // A tail that stayed is a growing snake, nothing to pull out
+    snake.tailMovement = isAlive ? getStep(snake.tail, tail) : sf::Vector2i();
+    snake.head = head;
+    snake.tail = tail;
+}
+
+void SnakeMotionLayer::setProgress(float progress)
+{
+    m_progress = std::max(0.0f, std::min(progress, 1.0f));
+}
+
+void SnakeMotionLayer::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    m_vertices.clear();
+    if (m_progress >= 1.0f || m_tileSize.x <= 0.0f || m_tileSize.y <= 0.0f)
+        return;
+
+    states.transform *= getTransform();
+
+    // Visible tiles with a tile of margin, like GameGrid only the snakes in view cost anything
+    const sf::View& view = target.getView();
+    const sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+    const sf::FloatRect visible = getInverseTransform().transformRect(viewRect);
+    const sf::FloatRect visibleTiles(visible.left / m_tileSize.x - 1.0f, visible.top / m_tileSize.y - 1.0f,
+        visible.width / m_tileSize.x + 2.0f, visible.height / m_tileSize.y + 2.0f);
+
+    const sf::Color emptyColor = GameGrid::getColorFromTileValue(GameGrid::TileValue::Empty);
+    const sf::Color bodyColor = GameGrid::getColorFromTileValue(GameGrid::TileValue::SnakeBody);
+    const sf::Color headColor = GameGrid::getColorFromTileValue(GameGrid::TileValue::SnakeHead);
+    sf::Vector2f position;
+    sf::Vector2f size;
+
+    for (const SnakeMotion& snake : m_snakes)
+    {
+        // The tail is pulled out of the tile it left, which the grid already shows empty
+        if (snake.tailMovement != sf::Vector2i() && visibleTiles.contains(sf::Vector2f(snake.tail)))
+        {
+            getRemainingPart(snake.tail - snake.tailMovement, snake.tailMovement, m_progress, &position, &size);
+            addQuad(position, size, bodyColor);
+        }
+
+        // The head slides from its old tile into the new one, the part of the new one it hasn't reached yet is empty
+        if (snake.headMovement != sf::Vector2i() && visibleTiles.contains(sf::Vector2f(snake.head)))
+        {
+            getRemainingPart(snake.head, snake.headMovement, m_progress, &position, &size);
+            addQuad(position, size, emptyColor);
+            addQuad(sf::Vector2f(snake.head - snake.headMovement) + sf::Vector2f(snake.headMovement) * m_progress,
+                sf::Vector2f(1.0f, 1.0f), headColor);
+        }
+    }
+
+    if (m_vertices.getVertexCount() > 0)
+        target.draw(m_vertices, states);
+}
+
+void SnakeMotionLayer::addQuad(sf::Vector2f tilePosition, sf::Vector2f size, sf::Color color) const
+{
+    const sf::Vector2f topLeft(tilePosition.x * m_tileSize.x, tilePosition.y * m_tileSize.y);
+    const sf::Vector2f bottomRight((tilePosition.x + size.x) * m_tileSize.x, (tilePosition.y + size.y) * m_tileSize.y);
+    m_vertices.append(sf::Vertex(topLeft, color));
+    m_vertices.append(sf::Vertex(sf::Vector2f(bottomRight.x, topLeft.y), color));
+    m_vertices.append(sf::Vertex(bottomRight, color));
+    m_vertices.append(sf::Vertex(sf::Vector2f(topLeft.x, bottomRight.y), color));
+}
@@ -0,0 +1,392 @@
+#include "TextBatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const std::size_t VERTICES_PER_QUAD = 6;
+    // sf::Text leans italic glyphs by 12 degrees
+    const float ITALIC_SHEAR = 0.209f;
+
+    // The same quad as sf::Text, two triangles with a pixel of padding around the glyph
+    void setGlyphQuad(sf::Vertex* quad, sf::Vector2f position, sf::Color color, const GlyphAtlas::Glyph& glyph, float italicShear, float outlineThickness)
+    {
+        const float padding = 1.0f;
+        const float left = glyph.bounds.left - padding;
+        const float top = glyph.bounds.top - padding;
+        const float right = glyph.bounds.left + glyph.bounds.width + padding;
+        const float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+        const float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        const float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        const float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        const float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        const float x = position.x - outlineThickness;
+        const float y = position.y - outlineThickness;
+        quad[0] = sf::Vertex(sf::Vector2f(x + left - italicShear * top, y + top), color, sf::Vector2f(u1, v1));
+        quad[1] = sf::Vertex(sf::Vector2f(x + right - italicShear * top, y + top), color, sf::Vector2f(u2, v1));
+        quad[2] = sf::Vertex(sf::Vector2f(x + left - italicShear * bottom, y + bottom), color, sf::Vector2f(u1, v2));
+        quad[3] = quad[2];
+        quad[4] = quad[1];
+        quad[5] = sf::Vertex(sf::Vector2f(x + right - italicShear * bottom, y + bottom), color, sf::Vector2f(u2, v2));
+    }
+
+    void appendGlyphQuad(std::vector<sf::Vertex>& vertices, sf::Vector2f position, sf::Color color, const GlyphAtlas::Glyph& glyph, float italicShear, float outlineThickness)
+    {
+        vertices.resize(vertices.size() + VERTICES_PER_QUAD);
+        setGlyphQuad(&vertices[vertices.size() - VERTICES_PER_QUAD], position, color, glyph, italicShear, outlineThickness);
+    }
+
+    // Strike-through line of a text line, drawn with a white pixel of the atlas
+    void appendLine(std::vector<sf::Vertex>& vertices, float lineLength, float lineTop, sf::Color color, float offset, float thickness,
+        sf::Vector2f whitePixel, float outlineThickness)
+    {
+        const float top = std::floor(lineTop + offset - thickness / 2.0f + 0.5f);
+        const float bottom = top + std::floor(thickness + 0.5f);
+
+        const sf::Vertex topLeft(sf::Vector2f(-outlineThickness, top - outlineThickness), color, whitePixel);
+        const sf::Vertex topRight(sf::Vector2f(lineLength + outlineThickness, top - outlineThickness), color, whitePixel);
+        const sf::Vertex bottomLeft(sf::Vector2f(-outlineThickness, bottom + outlineThickness), color, whitePixel);
+        const sf::Vertex bottomRight(sf::Vector2f(lineLength + outlineThickness, bottom + outlineThickness), color, whitePixel);
+        vertices.insert(vertices.end(), {topLeft, topRight, bottomLeft, bottomLeft, topRight, bottomRight});
+    }
+}
+
+void TextBatch::setAtlas(std::shared_ptr<const GlyphAtlas> atlas)
+{
+    m_atlas = std::move(atlas);
+    for (Text& text : m_texts)
+        layout(text);
+    m_needsRebuild = true;
+}
+
+std::size_t TextBatch::addText(const sf::String& string, const Style& style)
+{
+    m_texts.emplace_back();
+    Text& text = m_texts.back();
+    text.string = string;
+    text.style = style;
+    layout(text);
+    m_needsRebuild = true;
+    return m_texts.size() - 1;
+}
+
+std::size_t TextBatch::addCounter(unsigned int digitCount, const Style& style)
+{
+    m_texts.emplace_back();
+    Text& text = m_texts.back();
+    text.style = style;
+    text.digitCount = std::max(1u, std::min(digitCount, 9u));
+    layout(text);
+    m_needsRebuild = true;
+    return m_texts.size() - 1;
+}
+
+void TextBatch::setString(std::size_t index, const sf::String& string)
+{
+    Text& text = m_texts[index];
+    if (text.string == string)
+        return;
+
+    text.string = string;
+    const std::size_t vertexCount = text.vertices.size();
+    layout(text);
+    if (text.vertices.size() != vertexCount)
+        m_needsRebuild = true;
+    else
+        updateVertices(text);
+}
+
+void TextBatch::setCounter(std::size_t index, unsigned int value)
+{
+    // Only the digit quads change, they keep their place in the vertex array
+    Text& text = m_texts[index];
+    text.value = value;
+    setDigitQuads(text);
+    updateVertices(text);
+}
+
+void TextBatch::setPosition(std::size_t index, sf::Vector2f position)
+{
+    Text& text = m_texts[index];
+    text.position = position;
+    updateVertices(text);
+}
+
+void TextBatch::setFillColor(std::size_t index, sf::Color color)
+{
+    Text& text = m_texts[index];
+    text.style.fillColor = color;
+    for (std::size_t i = text.outlineVertexCount; i < text.vertices.size(); ++i)
+        text.vertices[i].color = color;
+    updateVertices(text);
+}
+
+void TextBatch::setStrikeThrough(std::size_t index, bool isStrikeThrough)
+{
+    Text& text = m_texts[index];
+    if (text.style.isStrikeThrough == isStrikeThrough)
+        return;
+
+    text.style.isStrikeThrough = isStrikeThrough;
+    layout(text);
+    m_needsRebuild = true;
+}
+
+void TextBatch::setVisible(std::size_t index, bool isVisible)
+{
+    Text& text = m_texts[index];
+    if (text.isVisible == isVisible)
+        return;
+
+    text.isVisible = isVisible;
+    m_needsRebuild = true;
+}
+
+sf::FloatRect TextBatch::getBounds(std::size_t index) const
+{
+    const Text& text = m_texts[index];
+    return sf::FloatRect(text.bounds.left + text.position.x, text.bounds.top + text.position.y, text.bounds.width, text.bounds.height);
+}
+
+sf::FloatRect TextBatch::measure(const sf::String& string, const Style& style) const
+{
+    std::vector<sf::Vertex> vertices;
+    std::size_t outlineVertexCount = 0;
+    return layout(string, style, &vertices, &outlineVertexCount);
+}
+
+void TextBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if (!m_atlas)
+        return;
+    if (m_needsRebuild)
+        rebuild();
+    if (m_vertices.empty())
+        return;
+
+    states.texture = &m_atlas->getTexture();
+    target.draw(m_vertices.data(), m_vertices.size(), sf::Triangles, states);
+}
+
+void TextBatch::layout(Text& text) const
+{
+    if (text.digitCount == 0)
+    {
+        text.bounds = layout(text.string, text.style, &text.vertices, &text.outlineVertexCount);
+        return;
+    }
+
+    // A counter takes the space of all its digits, '0' has the same width as every other digit in a monospaced font
+    text.bounds = layout(sf::String(std::string(text.digitCount, '0')), text.style, &text.vertices, &text.outlineVertexCount);
+    const GlyphAtlas::Glyph* space = m_atlas ? m_atlas->getGlyph(L' ', text.style.characterSize, 0.0f) : nullptr;
+    if (!space || text.vertices.empty())
+    {
+        text.vertices.clear();
+        text.outlineVertexCount = 0;
+        return;
+    }
+
+    const bool hasOutline = text.outlineVertexCount > 0;
+    text.digitSpacing = (space->advance / 3.0f) * (text.style.letterSpacing - 1.0f);
+    for (int digit = 0; digit < 10; ++digit)
+    {
+        text.digitGlyphs[digit] = m_atlas->getGlyph(static_cast<sf::Uint32>('0' + digit), text.style.characterSize, 0.0f);
+        text.digitOutlineGlyphs[digit] = hasOutline ? m_atlas->getGlyph(static_cast<sf::Uint32>('0' + digit), text.style.characterSize, text.style.outlineThickness) : nullptr;
+    }
+    // One quad per digit and one per outline, strike-through is not supported
+    text.outlineVertexCount = hasOutline ? text.digitCount * VERTICES_PER_QUAD : 0;
+    text.vertices.assign(text.outlineVertexCount + text.digitCount * VERTICES_PER_QUAD, sf::Vertex());
+    setDigitQuads(text);
+}
+
+void TextBatch::setDigitQuads(Text& text) const
+{
+    if (text.vertices.empty())
+        return;
+
+    unsigned int maxValue = 9;
+    for (unsigned int i = 1; i < text.digitCount; ++i)
+        maxValue = maxValue * 10 + 9;
+    unsigned int value = std::min(text.value, maxValue);
+
+    std::array<int, 10> digits;
+    unsigned int digitCount = 0;
+    do
+    {
+        digits[digitCount++] = static_cast<int>(value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    // Centered in the space of all digits, the unused quads are collapsed
+    float width = 0.0f;
+    for (unsigned int i = 0; i < digitCount; ++i)
+        width += text.digitGlyphs[digits[i]]->advance + text.digitSpacing;
+    const float fieldWidth = text.digitCount * (text.digitGlyphs[0]->advance + text.digitSpacing);
+
+    sf::Vector2f position((fieldWidth - width) / 2.0f, static_cast<float>(text.style.characterSize));
+    sf::Vertex* outlineQuads = text.vertices.data();
+    sf::Vertex* fillQuads = text.vertices.data() + text.outlineVertexCount;
+    const float italicShear = text.style.isItalic ? ITALIC_SHEAR : 0.0f;
+    for (unsigned int i = 0; i < text.digitCount; ++i)
+    {
+        sf::Vertex* fillQuad = fillQuads + i * VERTICES_PER_QUAD;
+        sf::Vertex* outlineQuad = text.outlineVertexCount > 0 ? outlineQuads + i * VERTICES_PER_QUAD : nullptr;
+        if (i >= digitCount)
+        {
+            std::fill(fillQuad, fillQuad + VERTICES_PER_QUAD, sf::Vertex());
+            if (outlineQuad)
+                std::fill(outlineQuad, outlineQuad + VERTICES_PER_QUAD, sf::Vertex());
+            continue;
+        }
+
+        // The most significant digit first
+        const int digit = digits[digitCount - 1 - i];
+        if (outlineQuad)
+            setGlyphQuad(outlineQuad, position, text.style.outlineColor, *text.digitOutlineGlyphs[digit], italicShear, text.style.outlineThickness);
+        setGlyphQuad(fillQuad, position, text.style.fillColor, *text.digitGlyphs[digit], italicShear, 0.0f);
+        position.x += text.digitGlyphs[digit]->advance + text.digitSpacing;
+    }
+}
+
+sf::FloatRect TextBatch::layout(const sf::String& string, const Style& style, std::vector<sf::Vertex>* vertices, std::size_t* outlineVertexCount) const
+{
+    vertices->clear();
+    *outlineVertexCount = 0;
+    if (!m_atlas || string.isEmpty())
+        return sf::FloatRect();
+
+    const unsigned int characterSize = style.characterSize;
+    const GlyphAtlas::SizeMetrics* metrics = m_atlas->getSizeMetrics(characterSize);
+    const GlyphAtlas::Glyph* space = m_atlas->getGlyph(L' ', characterSize, 0.0f);
+    if (!metrics || !space)
+    {
+        std::cerr << "TextBatch::layout(): character size " << characterSize << " is not in the glyph atlas!" << std::endl;
+        return sf::FloatRect();
+    }
+    const bool hasOutline = style.outlineThickness != 0.0f && m_atlas->getGlyph(L' ', characterSize, style.outlineThickness);
+    if (style.outlineThickness != 0.0f && !hasOutline)
+        std::cerr << "TextBatch::layout(): outline " << style.outlineThickness << " of size " << characterSize << " is not in the glyph atlas!" << std::endl;
+
+    // Laid out like sf::Text, without kerning, the font is monospaced
+    const float italicShear = style.isItalic ? ITALIC_SHEAR : 0.0f;
+    float whitespaceWidth = space->advance;
+    const float letterSpacing = (whitespaceWidth / 3.0f) * (style.letterSpacing - 1.0f);
+    whitespaceWidth += letterSpacing;
+    const sf::Vector2f whitePixel = m_atlas->getWhitePixel();
+
+    // Outlines go first into vertices, the fill is appended after them
+    std::vector<sf::Vertex> fillVertices;
+    float x = 0.0f;
+    float y = static_cast<float>(characterSize);
+    float minX = static_cast<float>(characterSize);
+    float minY = static_cast<float>(characterSize);
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+
+    auto addStrikeThrough = [&]()
+    {
+        if (!style.isStrikeThrough || x <= 0.0f)
+            return;
+        appendLine(fillVertices, x, y, style.fillColor, metrics->strikeThroughOffset, metrics->underlineThickness, whitePixel, 0.0f);
+        if (hasOutline)
+            appendLine(*vertices, x, y, style.outlineColor, metrics->strikeThroughOffset, metrics->underlineThickness, whitePixel, style.outlineThickness);
+    };
+
+    for (std::size_t i = 0; i < string.getSize(); ++i)
+    {
+        const sf::Uint32 codePoint = string[i];
+        if (codePoint == L'\r')
+            continue;
+
+        if (codePoint == L' ' || codePoint == L'\n' || codePoint == L'\t')
+        {
+            if (codePoint == L'\n')
+                addStrikeThrough();
+
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            if (codePoint == L' ')
+                x += whitespaceWidth;
+            else if (codePoint == L'\t')
+                x += whitespaceWidth * 4.0f;
+            else
+            {
+                y += metrics->lineSpacing;
+                x = 0.0f;
+            }
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+
+        // Characters missing from the atlas are shown as question marks
+        const GlyphAtlas::Glyph* glyph = m_atlas->getGlyph(codePoint, characterSize, 0.0f);
+        const sf::Uint32 atlasCodePoint = glyph ? codePoint : L'?';
+        if (!glyph)
+            glyph = m_atlas->getGlyph(atlasCodePoint, characterSize, 0.0f);
+
+        if (hasOutline)
+            appendGlyphQuad(*vertices, sf::Vector2f(x, y), style.outlineColor, *m_atlas->getGlyph(atlasCodePoint, characterSize, style.outlineThickness),
+                italicShear, style.outlineThickness);
+        appendGlyphQuad(fillVertices, sf::Vector2f(x, y), style.fillColor, *glyph, italicShear, 0.0f);
+
+        const float left = glyph->bounds.left;
+        const float top = glyph->bounds.top;
+        const float right = glyph->bounds.left + glyph->bounds.width;
+        const float bottom = glyph->bounds.top + glyph->bounds.height;
+        minX = std::min(minX, x + left - italicShear * bottom);
+        maxX = std::max(maxX, x + right - italicShear * top);
+        minY = std::min(minY, y + top);
+        maxY = std::max(maxY, y + bottom);
+
+        x += glyph->advance + letterSpacing;
+    }
+    addStrikeThrough();
+
+    *outlineVertexCount = vertices->size();
+    vertices->insert(vertices->end(), fillVertices.begin(), fillVertices.end());
+
+    sf::FloatRect bounds(minX, minY, maxX - minX, maxY - minY);
+    if (hasOutline)
+    {
+        bounds.left -= style.outlineThickness;
+        bounds.top -= style.outlineThickness;
+        bounds.width += 2.0f * style.outlineThickness;
+        bounds.height += 2.0f * style.outlineThickness;
+    }
+    return bounds;
+}
+
+void TextBatch::updateVertices(const Text& text) const
+{
+    if (m_needsRebuild || !text.isVisible)
+        return;
+
+    for (std::size_t i = 0; i < text.vertices.size(); ++i)
+    {
+        sf::Vertex& vertex = m_vertices[text.firstVertex + i];
+        vertex = text.vertices[i];
+        vertex.position += text.position;
+    }
+}
+
+void TextBatch::rebuild() const
+{
+    m_vertices.clear();
+    for (const Text& text : m_texts)
+    {
+        if (!text.isVisible)
+            continue;
+
+        text.firstVertex = m_vertices.size();
+        for (sf::Vertex vertex : text.vertices)
+        {
+            vertex.position += text.position;
+            m_vertices.push_back(vertex);
+        }
+    }
+    m_needsRebuild = false;
+}
@@ -1,9 +1,86 @@
 #include "Application.hpp"
 
-int main()
+#include <string>
+
+// Usage: Snake [--replay <file> [--speed <factor>]] [--level <number>] [--ai-snakes <count>]
+//              [--host <port> [--players <count>] | --join <host> <port>]
+//              [--spectate-port <port>] [--spectate <host> <port>]
+//              [--tick-rate <ticks per second>] [--max-catch-up <steps>]
+//              [--check-allocations <frames>]
+// --host starts a network game for the given number of players, the host included, and waits for the
+// others to --join. The host's level and AI snakes are played.
+// --spectate-port lets any number of others --spectate the games played on this instance.
+// --tick-rate runs the games from 1 up to 4096 ticks per second instead of 4, --max-catch-up sets how many
+// steps a frame may run on top of its own before the rest is dropped.
+// --check-allocations runs the chosen scene for that many frames instead of playing and exits with 1 if any
+// of them allocated, only in the Allocations configuration.
+int main(int argc, char* argv[])
 {
 	Application app {"Snake"};
+
+	std::string replayPath;
+	float replaySpeed = 1.0f;
+	int levelIndex = -1;
+	int hostPort = -1;
+	int playerCount = 2;
+	std::string joinHost;
+	int joinPort = -1;
+	int servePort = -1;
+	std::string spectateHost;
+	int spectatePort = -1;
+	int checkedFrames = 0;
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		const std::string argument = argv[i];
+		if (argument == "--replay")
+			replayPath = argv[++i];
+		else if (argument == "--speed")
+			replaySpeed = std::stof(argv[++i]);
+		else if (argument == "--level")
+			levelIndex = std::stoi(argv[++i]) - 1;
+		else if (argument == "--ai-snakes")
+			app.setAISnakeCount(std::stoi(argv[++i]));
+		else if (argument == "--host")
+			hostPort = std::stoi(argv[++i]);
+		else if (argument == "--players")
+			playerCount = std::stoi(argv[++i]);
+		else if (argument == "--join" && i + 2 < argc)
+		{
+			joinHost = argv[++i];
+			joinPort = std::stoi(argv[++i]);
+		}
+		else if (argument == "--spectate-port")
+			servePort = std::stoi(argv[++i]);
+		else if (argument == "--spectate" && i + 2 < argc)
+		{
+			spectateHost = argv[++i];
+			spectatePort = std::stoi(argv[++i]);
+		}
+		else if (argument == "--tick-rate")
+			app.setTickRate(std::stoi(argv[++i]));
+		else if (argument == "--max-catch-up")
+			app.setMaxCatchUpSteps(std::stoi(argv[++i]));
+		else if (argument == "--check-allocations")
+			checkedFrames = std::stoi(argv[++i]);
+	}
+	if (servePort >= 0)
+		app.serveSpectators(static_cast<std::uint16_t>(servePort));
+
+	if (hostPort >= 0)
+		app.hostNetworkGame(static_cast<std::uint16_t>(hostPort), playerCount, levelIndex);
+	else if (!joinHost.empty())
+		app.joinNetworkGame(joinHost, static_cast<std::uint16_t>(joinPort));
+	else if (!spectateHost.empty())
+		app.spectateGame(spectateHost, static_cast<std::uint16_t>(spectatePort));
+	else if (!replayPath.empty())
+		app.playReplay(replayPath, replaySpeed);
+	else if (levelIndex >= 0)
+		app.startLevel(levelIndex);
+
+	if (checkedFrames > 0)
+		return app.checkAllocations(static_cast<unsigned int>(checkedFrames)) ? 0 : 1;
+
 	app.run();
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -4,35 +4,27 @@
 GameOverState::GameOverState(std::shared_ptr<sf::RenderWindow> window, std::weak_ptr<StateManager> stateManager, std::shared_ptr<ResourceManager> resourceManager)
 	:State(window, stateManager, resourceManager)
 {
-	auto font = resourceManager->getFont("font_menu");
-	if (font)
-	{
-        m_textListMenus[0].setString("play again");
-        m_textListMenus[1].setString("exit");
-
-        m_textScore.setFont(*font);
-        m_textScore.setCharacterSize(22);
-        m_textScore.setFillColor(sf::Color::White);
-        m_textScore.setStyle(sf::Text::Style::Italic);
-
-        int i = 1;
-        for (auto& text : m_textListMenus)
-        {
-            text.setFont(*font);
-            text.setCharacterSize(20);
-            text.setFillColor(sf::Color::White);
-            text.setPosition(400.0f - text.getGlobalBounds().width / 2.0f,
-                300.0f + i++ * 50.0f - text.getGlobalBounds().height / 2.0f);
-        }
-
-        m_textInfo.setFont(*font);
-        m_textInfo.setCharacterSize(38);
-        m_textInfo.setFillColor(sf::Color::White);
-        m_textInfo.setOutlineColor(sf::Color(0, 120, 0));
-        m_textInfo.setString("GAME OVER");
-        m_textInfo.setPosition(400.0f - m_textInfo.getGlobalBounds().width / 2.0f,
-            180.0f);
-	}
+	m_texts.setAtlas(resourceManager->getGlyphAtlas("font_menu"));
+
+    TextBatch::Style infoStyle;
+    infoStyle.characterSize = 38;
+    m_textInfo = m_texts.addText("GAME OVER", infoStyle);
+    m_texts.setPosition(m_textInfo, sf::Vector2f(400.0f - m_texts.getBounds(m_textInfo).width / 2.0f, 180.0f));
+
+    TextBatch::Style scoreStyle;
+    scoreStyle.characterSize = 22;
+    scoreStyle.isItalic = true;
+    m_textScore = m_texts.addText("", scoreStyle);
+
+    const char* const menuStrings[] = {"play again", "exit"};
+    TextBatch::Style menuStyle;
+    menuStyle.characterSize = 20;
+    for (std::size_t i = 0; i < m_textListMenus.size(); ++i)
+    {
+        m_textListMenus[i] = m_texts.addText(menuStrings[i], menuStyle);
+        const sf::FloatRect bounds = m_texts.getBounds(m_textListMenus[i]);
+        m_texts.setPosition(m_textListMenus[i], sf::Vector2f(400.0f - bounds.width / 2.0f, 350.0f + i * 50.0f - bounds.height / 2.0f));
+    }
 
 	m_backgroundLayer.setSize(sf::Vector2f(800, 600));
 	m_backgroundLayer.setFillColor(sf::Color(25, 0, 0, 220));
@@ -131,11 +123,7 @@ void GameOverState::render()
 void GameOverState::renderAsNonTopState()
 {
 	m_window->draw(m_backgroundLayer);
-    m_window->draw(m_textInfo);
-    m_window->draw(m_textScore);
-
-    for (const auto& text : m_textListMenus)
-        m_window->draw(text);
+    m_window->draw(m_texts);
 }
 
 void GameOverState::exit()
@@ -145,9 +133,9 @@ void GameOverState::exit()
 void GameOverState::setScore(int score)
 {
 	m_score = score;
-	m_textScore.setString("Your score: " + std::to_string(score));
-    m_textScore.setPosition(400.0f - m_textScore.getGlobalBounds().width / 2.0f,
-        290.0f - m_textScore.getGlobalBounds().height / 2.0f);
+	m_texts.setString(m_textScore, "Your score: " + std::to_string(score));
+    const sf::FloatRect bounds = m_texts.getBounds(m_textScore);
+    m_texts.setPosition(m_textScore, sf::Vector2f(400.0f - bounds.width / 2.0f, 290.0f - bounds.height / 2.0f));
 }
 
 bool GameOverState::setMenuItemSelection(int index)
@@ -155,9 +143,9 @@ bool GameOverState::setMenuItemSelection(int index)
     if (index < 0 || index > 1)
         return false;
 
-    m_textListMenus[m_currentSelection].setFillColor(sf::Color::White);
+    m_texts.setFillColor(m_textListMenus[m_currentSelection], sf::Color::White);
     m_currentSelection = index;
-    m_textListMenus[m_currentSelection].setFillColor(sf::Color::Green);
+    m_texts.setFillColor(m_textListMenus[m_currentSelection], sf::Color::Green);
 
     return true;
 }
@@ -1,29 +1,47 @@
 #include "states/GameState.hpp"
 #include "states/StateManager.hpp"
+#include "FrameProfiler.hpp"
+#include "ResourceList.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <chrono>
+#include <filesystem>
 
 using std::cout;
 using std::endl;
 using std::cerr;
 
 GameState::GameState(std::shared_ptr<sf::RenderWindow> window, std::weak_ptr<StateManager> stateManager, std::shared_ptr<ResourceManager> resourceManager)
-    :State(window, stateManager, resourceManager),
-    m_superFoodDistribution(0, 99)
+    :State(window, stateManager, resourceManager)
 {
-    buildLevels();
-
-    auto font = resourceManager->getFont("font_menu");
-    if (font)
-    {
-        m_scoreText.setFont(*font);
-        m_scoreText.setString("0000");
-        m_scoreText.setCharacterSize(26);
-        m_scoreText.setOutlineThickness(3.0f);
-	    m_scoreText.setPosition(400.0f - m_scoreText.getGlobalBounds().width / 2.0f, 25.0f);
-    }
-    else
-        std::cerr << "GameState ctor: error getting font!" << std::endl;
+    // Without the level pack the builtin levels are still playable
+    if (!m_levelPack.open(LEVEL_PACK_PATH))
+        cerr << "GameState ctor: " << LEVEL_PACK_PATH << " could not be read, only the " << BUILTIN_LEVEL_COUNT << " builtin levels can be played!" << endl;
+
+    auto atlas = resourceManager->getGlyphAtlas("font_menu");
+    if (!atlas)
+        std::cerr << "GameState ctor: error getting the glyph atlas!" << std::endl;
+    m_texts.setAtlas(atlas);
+
+    // The score box fits four digits, longer scores grow out of it
+    TextBatch::Style scoreStyle;
+    scoreStyle.characterSize = 26;
+    scoreStyle.outlineThickness = 3.0f;
+    const sf::FloatRect scoreBounds = m_texts.measure("0000", scoreStyle);
+    m_scoreText = m_texts.addCounter(SCORE_DIGIT_COUNT, scoreStyle);
+    m_texts.setPosition(m_scoreText, sf::Vector2f(400.0f - m_texts.getBounds(m_scoreText).width / 2.0f, 25.0f));
+
+    TextBatch::Style infoStyle;
+    infoStyle.characterSize = 14;
+    infoStyle.outlineThickness = 2.0f;
+    m_replayText = m_texts.addText("", infoStyle);
+    m_texts.setPosition(m_replayText, sf::Vector2f(20.0f, 570.0f));
+    m_autopilotText = m_texts.addText("", infoStyle);
+    m_networkText = m_texts.addText("", infoStyle);
+    m_texts.setPosition(m_networkText, sf::Vector2f(20.0f, 570.0f));
+    m_tickRateText = m_texts.addText("", infoStyle);
+    m_texts.setPosition(m_tickRateText, sf::Vector2f(20.0f, 20.0f));
 
     auto soundBuffer = resourceManager->getSoundBuffer("sound_food");
     if (soundBuffer)
@@ -65,17 +83,15 @@ GameState::GameState(std::shared_ptr<sf::RenderWindow> window, std::weak_ptr<Sta
 	m_scoreUIShape.setSize(sf::Vector2f(120.0f, 50.f));
 	m_scoreUIShape.setOutlineThickness(8.0f);
 	m_scoreUIShape.setOutlineColor(sf::Color::Black);
-	sf::Vector2f pos = m_scoreText.getPosition();
+	sf::Vector2f pos(400.0f - scoreBounds.width / 2.0f, 25.0f);
 	pos.x -= m_scoreUIShape.getSize().x / 2.0f;
-	pos.x += m_scoreText.getGlobalBounds().width / 2.0f;
+	pos.x += scoreBounds.width / 2.0f;
 	pos.y -= m_scoreUIShape.getSize().y / 2.0f;
-	pos.y += m_scoreText.getGlobalBounds().height / 2.0f - m_scoreUIShape.getOutlineThickness() / 4.0f;
+	pos.y += scoreBounds.height / 2.0f - m_scoreUIShape.getOutlineThickness() / 4.0f;
 	m_scoreUIShape.setPosition(pos);
 
     m_gameOverEffect.setFillColor(sf::Color(255, 0, 0, 64));
     m_gameOverEffect.setSize(sf::Vector2f(800, 600));
-
-    m_randomGenerator.seed(std::chrono::system_clock::now().time_since_epoch().count());
 }
 
 GameState::~GameState()
@@ -92,32 +108,79 @@ void GameState::processEvents()
         switch (event.type)
         {
         case sf::Event::LostFocus:
+            // A paused network game stalls the others, only Escape pauses it
+            if (m_isNetworkGame)
+                break;
             tmpStateManager = m_stateManager.lock();
             if (tmpStateManager)
                 tmpStateManager->pushState(StateManager::StateID::Pause, true);
             break;
         case sf::Event::KeyPressed:
+            // During a replay the arrow keys change the playback speed instead of steering
+            if (m_isPlayingReplay)
+            {
+                switch (event.key.code)
+                {
+                case sf::Keyboard::Up:
+                case sf::Keyboard::Right:
+                    setReplaySpeed(m_replaySpeed * 2.0f);
+                    break;
+                case sf::Keyboard::Down:
+                case sf::Keyboard::Left:
+                    setReplaySpeed(m_replaySpeed / 2.0f);
+                    break;
+                default: ;
+                }
+                if (event.key.code != sf::Keyboard::Escape)
+                    break;
+            }
+
             switch(event.key.code)
             {
+            case sf::Keyboard::P:
+                // The AI snakes keep the arena busy enough, the autopilots only steer the single snake
+                if (m_isArenaGame || m_isSpectating)
+                    break;
+                setController(m_controller == Controller::Player ? Controller::Autopilot
+                    : m_controller == Controller::Autopilot ? Controller::Cycle : Controller::Player);
+                break;
+            case sf::Keyboard::I:
+                m_isSmoothMotion = !m_isSmoothMotion;
+                break;
+            case sf::Keyboard::PageUp:
+                setTickRate(m_tickRate * 2);
+                break;
+            case sf::Keyboard::PageDown:
+                setTickRate(m_tickRate / 2);
+                break;
+            case sf::Keyboard::T:
+                if (m_tickRate < TURBO_TICK_RATE)
+                {
+                    m_tickRateBeforeTurbo = m_tickRate;
+                    setTickRate(TURBO_TICK_RATE);
+                }
+                else
+                    setTickRate(m_tickRateBeforeTurbo);
+                break;
             case sf::Keyboard::W:
             case sf::Keyboard::Up:
-                if (m_lastMovement != PlayerInput::Down)
-                    m_lastInput = PlayerInput::Up;
+                if (isPlayerSteering())
+                    m_inputQueue.push(PlayerInput::Up, getInputTime());
                 break;
             case sf::Keyboard::S:
             case sf::Keyboard::Down:
-                if (m_lastMovement != PlayerInput::Up)
-                    m_lastInput = PlayerInput::Down;
+                if (isPlayerSteering())
+                    m_inputQueue.push(PlayerInput::Down, getInputTime());
                 break;
             case sf::Keyboard::A:
             case sf::Keyboard::Left:
-                if (m_lastMovement != PlayerInput::Right)
-                    m_lastInput = PlayerInput::Left;
+                if (isPlayerSteering())
+                    m_inputQueue.push(PlayerInput::Left, getInputTime());
                 break;
             case sf::Keyboard::D:
             case sf::Keyboard::Right:
-                if (m_lastMovement != PlayerInput::Left)
-                    m_lastInput = PlayerInput::Right;
+                if (isPlayerSteering())
+                    m_inputQueue.push(PlayerInput::Right, getInputTime());
                 break;
             case sf::Keyboard::Escape:
 				tmpStateManager = m_stateManager.lock();
@@ -144,56 +207,140 @@ void GameState::processInput()
 void GameState::enter()
 {
     setScore(0);
-    loadLevel(m_nextLevelIndex);
 
-    m_lastInput = PlayerInput::Up;
-    m_lastMovement = PlayerInput::Up;
-    m_snakeIsDead = false;
-    m_remainingFoodSpawnCooldown = 0;
-    m_foodInLevel = 0;
-    m_remainingGrowthTicks = 0;
+    m_isPlayingReplay = m_replayPending;
+    m_replayPending = false;
+    m_replayTick = 0;
+
+    if (!m_isPlayingReplay)
+    {
+        // Start recording a new game
+        m_replay = Replay();
+        m_replay.seed = static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count());
+        m_replay.levelIndex = m_nextLevelIndex;
+        m_replay.inputs.reserve(4096);
+    }
+
+    m_isArenaGame = (m_aiSnakeCount > 0 || m_isNetworkGame) && !m_isPlayingReplay;
+    m_localSnakeIndex = 0;
+    if (m_spectatorClient)
+    {
+        // The grid comes with the first keyframe
+        m_isSpectating = true;
+        m_isArenaGame = false;
+        m_spectatorKeyframeCount = 0;
+        m_spectatorFocus = sf::Vector2i(-1, -1);
+        m_texts.setString(m_networkText, "Waiting for the game");
+        return;
+    }
+    if (m_isNetworkGame)
+    {
+        // The level is loaded when the server sends the settings
+        m_isNetworkGameLoaded = false;
+        m_inputQueue.clear(PlayerInput::Up);
+        m_inputQueue.resetStatistics();
+        if (m_controller != Controller::Player)
+            setController(Controller::Player);
+        m_texts.setString(m_networkText, "Waiting for players");
+        return;
+    }
 
+    m_simulation.seed(m_replay.seed);
+    m_arena.seed(m_replay.seed);
+    m_aiRandomGenerator.seed(m_replay.seed);
+    if (!loadLevel(m_replay.levelIndex))
+        cerr << "GameState::enter(): level " << m_replay.levelIndex << " could not be loaded!" << endl;
+
+    m_inputQueue.clear(getPlayerLastMovement());
+    m_inputQueue.resetStatistics();
+    m_autopilot.reset();
+    if (m_isArenaGame && m_controller != Controller::Player)
+        setController(Controller::Player);
+    else if (m_controller == Controller::Cycle && !m_isPlayingReplay)
+        setController(Controller::Cycle);
+
+    m_tickCount = 0;
+    m_droppedTickCount = 0;
+    m_playTime = sf::Time::Zero;
     m_snakeClock.restart();
 }
 
 void GameState::update(sf::Time elapsedTime)
 {
-    if (m_snakeIsDead)
+    // Viewers that joined get the game as it is now, the ticks of this frame follow as deltas
+    if (m_spectatorServer && getTileGrid().getWidth() > 0)
+        m_spectatorServer->update(getTileGrid(), m_isSpectating ? m_spectatorClient->getDecoder().getTileSize() : m_level.tileSize,
+            m_spectatorTick, m_score);
+
+    if (m_isSpectating)
+    {
+        updateSpectating();
+        return;
+    }
+    if (m_isNetworkGame)
+    {
+        updateNetworkGame(elapsedTime);
+        return;
+    }
+
+    if (isPlayerDead())
         return;
 
 	m_snakeTime += elapsedTime;
+    m_playTime += elapsedTime;
 
-    while (m_snakeTime >= TIME_PER_SNAKE_MOVEMENT)
+    if (m_controller == Controller::Autopilot && !m_isPlayingReplay)
     {
-    	moveSnake();
-    	m_snakeTime -= TIME_PER_SNAKE_MOVEMENT;
+        SNAKE_PROFILE_SCOPE("Autopilot::think");
+        m_autopilot.think(m_simulation, AUTOPILOT_BUDGET_PER_FRAME);
+    }
 
-        // Spawn food every x ticks up to a certain maximum
-        if (0 < m_remainingFoodSpawnCooldown)
-            --m_remainingFoodSpawnCooldown;
+    const sf::Time timePerMovement = getTimePerMovement();
+    // The ticks this update's time is worth and a few more to catch up. After the tick rate went up the
+    // leftover time of the old rate would otherwise be stepped all at once
+    const long long maxTicks = elapsedTime.asMicroseconds() / timePerMovement.asMicroseconds() + 1 + m_maxCatchUpTicks;
+    long long ticks = 0;
 
-        if(0 >= m_remainingFoodSpawnCooldown && m_foodInLevel < m_maxFoodInLevel)
+    while (m_snakeTime >= timePerMovement && !isPlayerDead() && ticks < maxTicks)
+    {
+        if (m_isArenaGame)
         {
-            std::vector<sf::Vector2i> listOfEmptyTiles;
-            m_gameGrid.getListOfEmptyTiles(&listOfEmptyTiles);
-            if(!listOfEmptyTiles.empty())
-            {
-                // Get random tile to spawn the food on
-                std::uniform_int_distribution<int> distribution(0, listOfEmptyTiles.size()-1);
-                sf::Vector2i chosenTile = listOfEmptyTiles[distribution(m_randomGenerator)];
-                ++m_foodInLevel;
-
-                // 5 % chance for spawning a super food
-                if(m_superFoodDistribution(m_randomGenerator) < 95)
-                    m_gameGrid.updateTile(chosenTile, GameGrid::TileValue::Food);
-                else
-                    m_gameGrid.updateTile(chosenTile, GameGrid::TileValue::SuperFood);
-
-                // Reset cooldown only in case of successful spawn
-                m_remainingFoodSpawnCooldown = m_foodSpawnCooldown;
+            stepArena();
+            m_snakeTime -= timePerMovement;
+            ++ticks;
+            continue;
+        }
 
-            }
+        PlayerInput input = PlayerInput::Up;
+        if (m_isPlayingReplay)
+        {
+            if (m_replayTick >= m_replay.inputs.size())
+                break;
+            input = m_replay.inputs[m_replayTick++];
+        }
+        else
+        {
+            if (m_controller == Controller::Autopilot)
+                input = m_autopilot.getInput(m_simulation);
+            else if (m_controller == Controller::Cycle)
+                input = m_cycleFollower.getInput(m_simulation);
+            else
+                input = m_inputQueue.pop(getInputTime());
+            m_replay.inputs.push_back(input);
         }
+
+        Simulation::Events events = m_simulation.step(input);
+    	m_snakeTime -= timePerMovement;
+        ++ticks;
+
+        applySimulationEvents(events);
+    }
+
+    m_tickCount += ticks;
+    if (ticks == maxTicks && m_snakeTime >= timePerMovement)
+    {
+        m_droppedTickCount += m_snakeTime.asMicroseconds() / timePerMovement.asMicroseconds();
+        m_snakeTime %= timePerMovement;
     }
 }
 
@@ -206,25 +353,83 @@ void GameState::render()
 
 void GameState::renderAsNonTopState()
 {
-	m_window->draw(m_gameGrid);
+    // The time since the last tick says how far the snakes are on their way to the next tile
+    const bool drawSnakeMotion = m_isSmoothMotion && !m_isSpectating;
+    if (drawSnakeMotion)
+        m_snakeMotion.setProgress(m_snakeTime / getTimePerMovement());
+
+    if (m_useCamera)
+    {
+        updateCamera();
+        m_window->setView(m_camera);
+        m_window->draw(m_gameGrid);
+        if (drawSnakeMotion)
+            m_window->draw(m_snakeMotion);
+        m_window->setView(m_window->getDefaultView());
+    }
+    else
+    {
+	    m_window->draw(m_gameGrid);
+        if (drawSnakeMotion)
+            m_window->draw(m_snakeMotion);
+    }
 	m_window->draw(m_scoreUIShape);
-	m_window->draw(m_scoreText);
+    // All texts in one draw call, they only change when they are shown or hidden
+    m_texts.setVisible(m_replayText, m_isPlayingReplay);
+    m_texts.setVisible(m_autopilotText, !m_isPlayingReplay && m_controller != Controller::Player);
+    m_texts.setVisible(m_tickRateText, m_tickRate != DEFAULT_TICK_RATE && !m_isNetworkGame && !m_isSpectating);
+    m_texts.setVisible(m_networkText, (m_isNetworkGame && !m_isNetworkGameLoaded) || (m_isSpectating && m_spectatorKeyframeCount == 0));
+	m_window->draw(m_texts);
 }
 
 void GameState::exit()
 {
+    reportInputLatency();
+    reportTickRate();
+    if (m_isNetworkGame)
+        endNetworkGame();
+    if (m_isSpectating)
+        endSpectating();
+}
+
+void GameState::setAISnakeCount(int count)
+{
+    m_aiSnakeCount = std::max(0, count);
+}
+
+void GameState::setMaxCatchUpTicks(int ticks)
+{
+    m_maxCatchUpTicks = std::max(0, ticks);
+}
+
+void GameState::setTickRate(int ticksPerSecond)
+{
+    m_tickRate = std::max(MIN_TICK_RATE, std::min(ticksPerSecond, MAX_TICK_RATE));
+    m_texts.setString(m_tickRateText, (m_tickRate >= TURBO_TICK_RATE ? "Turbo " : "") + std::to_string(m_tickRate) + " ticks/s");
 }
 
 void GameState::setNextLevel(int levelIndex)
 {
-    if (levelIndex < 0 || levelIndex > 2)
+    if (levelIndex < 0 || levelIndex >= getLevelCount())
     {
-        std::cerr << "GameState::setNexLevel(): " << levelIndex << " is no valid level!" << std::endl;
+        std::cerr << "GameState::setNextLevel(): " << levelIndex << " is no valid level!" << std::endl;
         return;
     }
     m_nextLevelIndex = levelIndex;
 }
 
+int GameState::getLevelCount() const
+{
+    return m_levelPack.isOpen() ? m_levelPack.getLevelCount() : BUILTIN_LEVEL_COUNT;
+}
+
+void GameState::playReplay(const Replay& replay, float speed)
+{
+    m_replay = replay;
+    m_replayPending = true;
+    setReplaySpeed(speed);
+}
+
 void GameState::setEffectsVolume(float volume)
 {
     m_soundFood.setVolume(volume);
@@ -235,335 +440,164 @@ void GameState::setEffectsVolume(float volume)
     m_soundCollision.setVolume(volume);
 }
 
-void GameState::buildLevels()
-{
-    // Level 1
-    m_levels[0].tileSize = sf::Vector2u(25, 25);
-	m_levels[0].width = 32;
-	m_levels[0].height = 24;
-    m_levels[0].startPosition = sf::Vector2i(17, 18);
-    m_levels[0].gridData = {
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
-    };
-
-    // Level 2
-    m_levels[1].tileSize = sf::Vector2u(20, 20);
-	m_levels[1].width = 40;
-	m_levels[1].height = 30;
-    m_levels[1].startPosition = sf::Vector2i(10, 20);
-    m_levels[1].gridData = {
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-		1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1,
-        1, 0, 0, 0, 8, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 7, 0, 0, 0, 1,
-        1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1,
-        1, 0, 0, 0, 7, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 8, 0, 0, 0, 1,
-        1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
-    };
-
-    // Level 3
-    m_levels[2].tileSize = sf::Vector2u(20, 20);
-	m_levels[2].width = 40;
-	m_levels[2].height = 30;
-    m_levels[2].startPosition = sf::Vector2i(6, 18);
-    m_levels[2].gridData = {
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 9, 9, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 1, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 1, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 1, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 1, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 1, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 1, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 1, 1, 1, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 1, 1, 1, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 7, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 7, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 0, 0, 1, 9, 9, 1, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 9, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
-    };
-}
-
-void GameState::loadLevel(int levelIndex)
-{
-	m_snake.clear();
-
-    m_gameGrid.loadFromArray(m_levels[levelIndex].gridData, m_levels[levelIndex].width,
-		m_levels[levelIndex].height, m_levels[levelIndex].tileSize);
-       
-    m_snake.emplace_back(m_levels[levelIndex].startPosition);
-    m_snake.emplace_back(m_levels[levelIndex].startPosition + sf::Vector2i(0, 1));
-    m_snake.emplace_back(m_levels[levelIndex].startPosition + sf::Vector2i(0, 2));
-
-	m_gameGrid.updateTile(m_snake[0].x, m_snake[0].y, GameGrid::TileValue::SnakeHead);
-	m_gameGrid.updateTile(m_snake[1].x, m_snake[1].y, GameGrid::TileValue::SnakeBody);
-	m_gameGrid.updateTile(m_snake[2].x, m_snake[2].y, GameGrid::TileValue::SnakeBody);
-}
-
-void GameState::moveSnake()
-{
-    // Only move if snake is at least 2 parts long and is not dead
-    if (!isSnakeValid() || m_snakeIsDead)
-        return;
+bool GameState::loadLevel(int levelIndex)
+{
+    // Replaying the same level again skips decoding
+    if (levelIndex != m_loadedLevelIndex)
+    {
+        m_loadedLevelIndex = -1;
+        if (!m_levelPack.isOpen() && levelIndex >= 0 && levelIndex < BUILTIN_LEVEL_COUNT)
+            m_level = buildBuiltinLevel(levelIndex);
+        else if (!m_levelPack.loadLevel(levelIndex, &m_level))
+            return false;
+        m_loadedLevelIndex = levelIndex;
+    }
+
+    // Arena games leave the single snake simulation alone
+    if (m_isArenaGame ? !loadArenaLevel() : !m_simulation.loadLevel(m_level))
+        return false;
+
+    m_gameGrid.loadFromTileGrid(getTileGrid(), m_level.tileSize);
+    setupCamera();
+    m_snakeMotion.setTileSize(m_level.tileSize);
+    m_snakeMotion.reset(m_isArenaGame ? m_arena.getSnakeCount() : 1);
+    updateSnakeMotion();
+
+    if (m_spectatorServer)
+        m_spectatorServer->resync();
+    return true;
+}
 
-    sf::Vector2i movement;
-    GameGrid::TileValue tileValue;
-    bool isValidTileValue = false;
-    bool snakeDied = false;
-    int snakeGrowth = 0;
+void GameState::setupCamera()
+{
+    const sf::Vector2f windowSize(m_window->getSize());
+    const sf::Vector2f levelSize = m_gameGrid.getSize();
+    m_useCamera = levelSize.x > windowSize.x || levelSize.y > windowSize.y;
+    m_camera.setSize(windowSize);
+}
+
+const TileGrid& GameState::getTileGrid() const
+{
+    if (m_isSpectating)
+        return m_spectatorClient->getDecoder().getGrid();
+    return m_isArenaGame ? m_arena.getGrid() : m_simulation.getGrid();
+}
 
-    switch (m_lastInput)
+bool GameState::isPlayerDead() const
+{
+    return m_isArenaGame ? !m_arena.isSnakeAlive(m_localSnakeIndex) : m_simulation.isSnakeDead();
+}
+
+int GameState::getPlayerScore() const
+{
+    return m_isArenaGame ? m_arena.getScore(m_localSnakeIndex) : m_simulation.getScore();
+}
+
+GameState::PlayerInput GameState::getPlayerLastMovement() const
+{
+    // A network game has no snakes until the server sent the settings
+    if (m_isArenaGame)
+        return m_localSnakeIndex < m_arena.getSnakeCount() ? m_arena.getLastMovement(m_localSnakeIndex) : PlayerInput::Up;
+    return m_simulation.getLastMovement();
+}
+
+void GameState::applySimulationEvents(const Simulation::Events& events)
+{
+    syncGameGrid();
+    updateSnakeMotion();
+
+    if (events.growing)
+        m_soundMovementGrowing.play();
+    if (events.teleported)
+        m_soundTeleport.play();
+    if (events.ateFood)
+        m_soundFood.play();
+    if (events.ateSuperFood)
+        m_soundFoodBig.play();
+
+    if (getPlayerScore() != m_score)
+        setScore(getPlayerScore());
+
+    if (events.collided)
     {
-    case PlayerInput::Up:
-        --movement.y;
-        break;
-    case PlayerInput::Down:
-        ++movement.y;
-        break;
-
-    case PlayerInput::Left:
-        --movement.x;
-        break;
-
-    case PlayerInput::Right:
-        ++movement.x;
-        break;
-
-    default:
-        // invalid state, do nothing
-        return;
+        m_soundCollision.play();
+        if (!m_isNetworkGame)
+            triggerSnakeDeath();
     }
+}
 
-    // Only move if next position is valid
-    if (m_gameGrid.getTileValueAt(m_snake[0] + movement, &tileValue))
+void GameState::syncGameGrid()
+{
+    // Only redraw the tiles the last simulation step touched
+    const TileGrid& tileGrid = getTileGrid();
+    for (const auto& position : tileGrid.getChangedTiles())
     {
-        // Snake grows x ticks after eating food
-        if (m_remainingGrowthTicks > 0)
-        {
-            m_soundMovementGrowing.play();
-            --m_remainingGrowthTicks;
-        }
-
-        // Check for next position's tile value
-        switch (tileValue)
-        {
-        case GameGrid::TileValue::Empty:
-            // Do nothing, only move snake
-            break;
-        case GameGrid::TileValue::Wall:
-        case GameGrid::TileValue::SnakeBody:
-            snakeDied = true;
-            m_soundCollision.play();
-            break;
-        case GameGrid::TileValue::SnakeHead:
-            snakeDied = true;
-            m_soundCollision.play();
-            // Note: this shouldn't be possible with only one snake on the board
-            // -> possible multiplayer extension
-            break;
-        case GameGrid::TileValue::Food:
-            m_soundFood.play();
-            --m_foodInLevel;
-            setScore(m_score + 1);
-            snakeGrowth = 1;
-            break;
-        case GameGrid::TileValue::SuperFood:
-            m_soundFoodBig.play();
-            --m_foodInLevel;
-            setScore(m_score + 5);
-            snakeGrowth = 5;
-            break;
-        case GameGrid::TileValue::Poison:
-            // Trigger posion effects (changed controls, other effects)
-            break;
-        case GameGrid::TileValue::Teleport1:
-            {
-                auto otherTeleporter = m_gameGrid.getPositionOfOtherTeleporter1(m_snake[0] + movement);
-                if (otherTeleporter)
-                {
-                    m_soundTeleport.play();
-
-                    // Teleport the snake by adding an offset
-                    movement += *otherTeleporter - m_snake[0];
-
-                    // Check for collision on other telporter's side
-                    if (m_gameGrid.getTileValueAt(m_snake[0] + movement, &tileValue))
-                    {
-                        switch (tileValue)
-                        {
-                        case GameGrid::TileValue::Wall:
-                        case GameGrid::TileValue::SnakeBody:
-                        case GameGrid::TileValue::SnakeHead:
-                        case GameGrid::TileValue::NoPlayArea:
-                            snakeDied = true;
-                            m_soundCollision.play();
-                            break;
-                        case GameGrid::TileValue::Food:
-                            --m_foodInLevel;
-                            m_soundFood.play();
-                            setScore(m_score + 1);
-                            snakeGrowth = 1;
-                            break;
-                        case GameGrid::TileValue::SuperFood:
-                            --m_foodInLevel;
-                            m_soundFoodBig.play();
-                            setScore(m_score + 5);
-                            snakeGrowth = 5;
-                            break;
-                        }
-                    }
-                }
-            }
-            break;
-        case GameGrid::TileValue::Teleport2:
-            {
-                auto otherTeleporter = m_gameGrid.getPositionOfOtherTeleporter2(m_snake[0] + movement);
-                if (otherTeleporter)
-                {
-                    m_soundTeleport.play();
-
-                    // Teleport the snake by adding an offset
-                    movement += *otherTeleporter - m_snake[0];
-
-                    // Check for collision on other telporter's side
-                    if (m_gameGrid.getTileValueAt(m_snake[0] + movement, &tileValue))
-                    {
-                        switch (tileValue)
-                        {
-                        case GameGrid::TileValue::Wall:
-                        case GameGrid::TileValue::SnakeBody:
-                        case GameGrid::TileValue::SnakeHead:
-                        case GameGrid::TileValue::NoPlayArea:
-                            snakeDied = true;
-                            m_soundCollision.play();
-                            break;
-                        case GameGrid::TileValue::Food:
-                            --m_foodInLevel;
-                            m_soundFood.play();
-                            snakeGrowth = 1;
-                            setScore(m_score + 1);
-                            break;
-                        case GameGrid::TileValue::SuperFood:
-                            --m_foodInLevel;
-                            m_soundFoodBig.play();
-                            setScore(m_score + 5);
-                            snakeGrowth = 1;
-                            break;
-                        }
-                    }
-                }
-            }
-            break;
-        case GameGrid::TileValue::NoPlayArea:
-            snakeDied = true;
-            m_soundCollision.play();
-            // Note: this shouldn't be possible, trigger death for safety reasons
-            break;
-        default: ;
-        }
+        GameGrid::TileValue tileValue;
+        if (tileGrid.getTileValueAt(position, &tileValue))
+            m_gameGrid.updateTile(position, tileValue);
+    }
 
-        if (!m_snakeIsDead)
-        {
-            // Clear the tail's previous tile
-            m_gameGrid.updateTile(m_snake[m_snake.size() - 1], GameGrid::TileValue::Empty);
+    // A spectated game is passed on, so a viewer can serve more viewers
+    if (m_spectatorServer)
+        m_spectatorServer->broadcastTick(tileGrid, ++m_spectatorTick, m_isSpectating ? m_spectatorClient->getDecoder().getScore() : getPlayerScore());
+}
 
-            // Move the snake parts from tail to head
-            for (std::size_t i = m_snake.size() - 1; i > 0; --i)
-            {
-                m_snake[i] = m_snake[i - 1];
-                m_gameGrid.updateTile(m_snake[i], GameGrid::TileValue::SnakeBody);
-            }
-            m_snake[0] += movement;
-            m_gameGrid.updateTile(m_snake[0], GameGrid::TileValue::SnakeHead);
-        }
+void GameState::updateSnakeMotion()
+{
+    if (!m_isArenaGame)
+    {
+        m_snakeMotion.setSnake(0, m_simulation.getSnake().getHead(), m_simulation.getSnake().getTail(), !m_simulation.isSnakeDead());
+        return;
     }
+    for (int i = 0; i < m_arena.getSnakeCount(); ++i)
+        m_snakeMotion.setSnake(i, m_arena.getHead(i), m_arena.getTail(i), m_arena.isSnakeAlive(i));
+}
 
-    if (snakeDied)
-        triggerSnakeDeath();
-
-    if (snakeGrowth > 0)
-        snakeGrows(snakeGrowth);
+sf::Time GameState::getTimePerMovement() const
+{
+    // All players of a lockstep game have to tick at the same rate
+    if (m_isNetworkGame)
+        return TIME_PER_SNAKE_MOVEMENT;
 
-    m_lastMovement = m_lastInput;
+    const sf::Time timePerMovement = sf::microseconds(1000000 / m_tickRate);
+    return m_isPlayingReplay ? std::max(sf::microseconds(1), timePerMovement / m_replaySpeed) : timePerMovement;
 }
 
-bool GameState::isSnakeValid() const
+void GameState::updateCamera()
 {
-    return m_snake.size() > 1;
+    const sf::Vector2i head = m_isSpectating ? m_spectatorFocus
+        : m_isArenaGame ? m_arena.getHead(m_localSnakeIndex) : m_simulation.getSnake().getHead();
+    if (!getTileGrid().isValidPosition(head))
+        return;
+
+    const sf::Vector2f tileSize(m_gameGrid.getTileSize());
+    const sf::Vector2f levelSize = m_gameGrid.getSize();
+    const sf::Vector2f halfView = m_camera.getSize() / 2.0f;
+
+    // Center on the head but never show the area outside of the level, unless the level is smaller than the view
+    sf::Vector2f center((head.x + 0.5f) * tileSize.x, (head.y + 0.5f) * tileSize.y);
+    center.x = levelSize.x > 2.0f * halfView.x ? std::max(halfView.x, std::min(center.x, levelSize.x - halfView.x)) : levelSize.x / 2.0f;
+    center.y = levelSize.y > 2.0f * halfView.y ? std::max(halfView.y, std::min(center.y, levelSize.y - halfView.y)) : levelSize.y / 2.0f;
+    m_camera.setCenter(center);
 }
 
 void GameState::triggerSnakeDeath()
 {
-    m_snakeIsDead = true;
-    if (m_snake.size() > 1)
+    reportInputLatency();
+    reportTickRate();
+    if (m_isArenaGame)
+        cout << "Arena game over, " << m_arena.getAliveSnakeCount() << " of " << m_arena.getSnakeCount() << " snakes alive" << endl;
+    else if (m_isPlayingReplay)
     {
-        for (auto it = m_snake.begin() + 1; it != m_snake.end(); ++it)
-            m_gameGrid.updateTile(*it, GameGrid::TileValue::DeadSnakeBody);
-
-		// Update snake head at last element to show head on top when colliding with snake
-        m_gameGrid.updateTile(m_snake[0], GameGrid::TileValue::DeadSnakeHead);
+        const bool matches = m_simulation.getScore() == m_replay.finalScore
+            && m_simulation.computeStateHash() == m_replay.finalStateHash;
+        cout << "Replay finished after " << m_replayTick << " ticks, " << (matches ? "matches the recording" : "diverged from the recording!") << endl;
+    }
+    else
+    {
+        m_replay.finalScore = m_simulation.getScore();
+        m_replay.finalStateHash = m_simulation.computeStateHash();
+        writeReplayFile();
     }
 
 	std::shared_ptr<StateManager> tmpStateManager = m_stateManager.lock();
@@ -574,24 +608,97 @@ void GameState::triggerSnakeDeath()
 	}
 }
 
-void GameState::snakeGrows(int growth)
+std::int64_t GameState::getInputTime() const
 {
-    // If there is no existing snake it's not possible to grow
-    if (m_snake.empty())
+    return m_inputClock.getElapsedTime().asMicroseconds();
+}
+
+bool GameState::isPlayerSteering() const
+{
+    // Nothing takes turns out of the queue while an autopilot steers or a game is watched
+    return m_controller == Controller::Player && !m_isSpectating && !m_isPlayingReplay;
+}
+
+void GameState::reportInputLatency()
+{
+    const InputQueue::LatencyStats stats = m_inputQueue.getLatencyStats();
+    if (stats.count == 0)
         return;
 
-    // As long as all snake parts look the same, just stack
-    // the new snake parts at the tail's position
-    for (int i = 0; i < growth; ++i)
-    {
-        m_snake.push_back(m_snake.back());
-    }
-    m_remainingGrowthTicks += growth;
+    // From polling the key event to the tick that took the turn. Network games apply it the input delay later
+    cout << "Input latency over " << stats.count << " turns: p50 " << stats.p50 << " ms, p95 " << stats.p95
+        << " ms, max " << stats.max << " ms, " << m_inputQueue.getDroppedCount() << " turns dropped" << endl;
+    m_inputQueue.resetStatistics();
+}
+
+void GameState::reportTickRate()
+{
+    if (m_tickCount == 0 || (m_tickRate == DEFAULT_TICK_RATE && m_droppedTickCount == 0))
+        return;
+
+    // Mostly for turbo runs, how fast the game really ticked
+    const float seconds = std::max(m_playTime.asSeconds(), 0.001f);
+    cout << m_tickCount << " ticks in " << seconds << " s, " << static_cast<long long>(m_tickCount / seconds)
+        << " per second at " << m_tickRate << " ticks/s, " << m_droppedTickCount << " ticks dropped" << endl;
+    m_tickCount = 0;
+    m_droppedTickCount = 0;
+    m_playTime = sf::Time::Zero;
 }
 
 void GameState::setScore(int score)
 {
     m_score = score;
-    m_scoreText.setString(std::to_string(m_score));
-	m_scoreText.setPosition(400.0f - m_scoreText.getGlobalBounds().width / 2.0f, 25.0f);
+    // Only the digit quads are replaced, nothing is laid out
+    m_texts.setCounter(m_scoreText, static_cast<unsigned int>(std::max(0, m_score)));
+}
+
+void GameState::setReplaySpeed(float speed)
+{
+    m_replaySpeed = std::max(0.25f, std::min(speed, 1024.0f));
+    if (m_replaySpeed >= 1.0f)
+        m_texts.setString(m_replayText, "Replay x" + std::to_string(static_cast<int>(m_replaySpeed)));
+    else
+        m_texts.setString(m_replayText, "Replay x1/" + std::to_string(static_cast<int>(1.0f / m_replaySpeed)));
+}
+
+void GameState::setController(Controller controller)
+{
+    if (controller == Controller::Cycle && !prepareCycle())
+        controller = Controller::Player;
+
+    m_controller = controller;
+    m_autopilot.reset();
+    m_cycleFollower.reset(&m_cycle);
+    // The player continues in the direction the autopilot steered last
+    m_inputQueue.clear(getPlayerLastMovement());
+
+    m_texts.setString(m_autopilotText, controller == Controller::Cycle ? "Cycle autopilot" : "Autopilot");
+    m_texts.setPosition(m_autopilotText, sf::Vector2f(780.0f - m_texts.getBounds(m_autopilotText).width, 570.0f));
+}
+
+bool GameState::prepareCycle()
+{
+    // Solving a level only happens the first time it is played with the cycle, later it is read from the cache
+    if (m_cycleLevelIndex == m_loadedLevelIndex && !m_cycle.isEmpty())
+        return true;
+
+    m_cycleLevelIndex = -1;
+    if (m_loadedLevelIndex < 0 || !m_cycle.loadOrSolve(m_level, CYCLE_CACHE_DIRECTORY))
+    {
+        cerr << "GameState::prepareCycle(): no cycle for level " << m_loadedLevelIndex << "!" << endl;
+        return false;
+    }
+    m_cycleLevelIndex = m_loadedLevelIndex;
+    cout << "Cycle over " << m_cycle.getLength() << " of " << m_cycle.getPlayableTileCount() << " tiles" << endl;
+    return true;
+}
+
+void GameState::writeReplayFile()
+{
+    std::error_code error;
+    std::filesystem::create_directories("replays", error);
+
+    const std::string path = "replays/snake_" + std::to_string(m_replay.seed) + ".replay";
+    if (saveReplay(m_replay, path))
+        cout << "Replay saved to " << path << endl;
 }
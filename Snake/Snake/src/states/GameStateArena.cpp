@@ -0,0 +1,53 @@
+#include "states/GameState.hpp"
+
+// Games with AI snakes and network games, every snake on one SnakeArena
+
+bool GameState::loadArenaLevel()
+{
+    // Snakes that don't fit into the level are left out, the game still starts
+    if (m_isNetworkGame)
+    {
+        // Every player needs the same snakes or the games go apart
+        const LockstepSettings& settings = m_lockstepClient.getSettings();
+        if (!m_arena.loadLevel(m_level, settings.playerCount + settings.aiSnakeCount))
+            return false;
+    }
+    else
+        m_arena.loadLevel(m_level, 1 + m_aiSnakeCount);
+
+    m_arenaInputs.assign(m_arena.getSnakeCount(), PlayerInput::Up);
+    m_respawnTicks.assign(m_arena.getSnakeCount(), 0);
+    return true;
+}
+
+void GameState::stepArena()
+{
+    int firstAISnake = 1;
+    if (m_isNetworkGame)
+    {
+        // Fills in the inputs of all players, the own input is sent for a later tick
+        m_lockstepClient.advanceTick(m_inputQueue.pop(getInputTime()), m_arena, m_arenaInputs.data(), getNetworkTime());
+        firstAISnake = m_lockstepClient.getSettings().playerCount;
+    }
+    else
+        m_arenaInputs[0] = m_inputQueue.pop(getInputTime());
+
+    for (int i = firstAISnake; i < m_arena.getSnakeCount(); ++i)
+        m_arenaInputs[i] = m_arena.getWanderInput(i, m_aiRandomGenerator());
+
+    m_arena.step(m_arenaInputs.data());
+
+    // Dead AI snakes start over after a while, the tiles they leave are part of the next sync.
+    // In network games the players' snakes too, nobody waits for the others to restart
+    for (int i = m_isNetworkGame ? 0 : 1; i < m_arena.getSnakeCount(); ++i)
+    {
+        if (m_arena.isSnakeAlive(i))
+            continue;
+        if (m_respawnTicks[i] == 0)
+            m_respawnTicks[i] = AI_SNAKE_RESPAWN_TICKS;
+        else if (--m_respawnTicks[i] == 0 && m_arena.respawnSnake(i) && i == m_localSnakeIndex)
+            m_inputQueue.clear(getPlayerLastMovement()); // The turns were meant for the old snake
+    }
+
+    applySimulationEvents(m_arena.getEvents(m_localSnakeIndex));
+}
@@ -0,0 +1,118 @@
+#include "states/GameState.hpp"
+#include "states/StateManager.hpp"
+#include <chrono>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::cerr;
+
+// Lockstep network games, they run on the arena with the inputs of every player from the server
+
+bool GameState::hostNetworkGame(std::uint16_t port, int playerCount)
+{
+    if (playerCount < 1)
+        return false;
+
+    LockstepSettings settings;
+    settings.playerCount = playerCount;
+    settings.aiSnakeCount = m_aiSnakeCount;
+    settings.levelIndex = m_nextLevelIndex;
+    settings.seed = static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count());
+
+    m_serverTransport = std::make_unique<UdpTransport>();
+    if (!m_serverTransport->bind(port) || !m_lockstepServer.start(m_serverTransport.get(), settings)
+        || !joinNetworkGame("127.0.0.1", port))
+    {
+        m_serverTransport.reset();
+        return false;
+    }
+    cout << "Hosting a game for " << playerCount << " players on port " << port << endl;
+    return true;
+}
+
+bool GameState::joinNetworkGame(const std::string& host, std::uint16_t port)
+{
+    const auto server = UdpTransport::resolve(host, port);
+    if (!server)
+    {
+        cerr << "GameState::joinNetworkGame(): unknown host " << host << "!" << endl;
+        return false;
+    }
+
+    m_clientTransport = std::make_unique<UdpTransport>();
+    if (!m_clientTransport->bind(0) || !m_lockstepClient.connect(m_clientTransport.get(), *server))
+    {
+        m_clientTransport.reset();
+        return false;
+    }
+
+    m_isNetworkGame = true;
+    m_networkClock.restart();
+    return true;
+}
+
+void GameState::updateNetworkGame(sf::Time elapsedTime)
+{
+    const std::chrono::microseconds now = getNetworkTime();
+    if (m_serverTransport)
+        m_lockstepServer.update(now);
+    m_lockstepClient.update(now);
+
+    if (!m_lockstepClient.isStarted())
+        return;
+    if (!m_isNetworkGameLoaded && !loadNetworkGame())
+    {
+        endNetworkGame();
+        std::shared_ptr<StateManager> tmpStateManager = m_stateManager.lock();
+        if (tmpStateManager)
+            tmpStateManager->replaceCurrentState(StateManager::StateID::MainMenu);
+        return;
+    }
+
+    m_snakeTime += elapsedTime;
+    while (m_snakeTime >= TIME_PER_SNAKE_MOVEMENT && m_lockstepClient.hasTickInputs())
+    {
+        stepArena();
+        m_snakeTime -= TIME_PER_SNAKE_MOVEMENT;
+    }
+
+    // Waiting for the inputs of the others delays the game instead of building up ticks to catch up on
+    if (m_snakeTime > TIME_PER_SNAKE_MOVEMENT)
+        m_snakeTime = TIME_PER_SNAKE_MOVEMENT;
+}
+
+bool GameState::loadNetworkGame()
+{
+    const LockstepSettings& settings = m_lockstepClient.getSettings();
+    m_localSnakeIndex = m_lockstepClient.getPlayerIndex();
+    m_arena.seed(settings.seed);
+    m_aiRandomGenerator.seed(settings.seed);
+    if (!loadLevel(settings.levelIndex))
+    {
+        cerr << "GameState::loadNetworkGame(): level " << settings.levelIndex << " could not be loaded for "
+            << settings.playerCount + settings.aiSnakeCount << " snakes!" << endl;
+        return false;
+    }
+
+    m_inputQueue.clear(getPlayerLastMovement());
+    cout << "Network game started, player " << m_localSnakeIndex + 1 << " of " << settings.playerCount << endl;
+    m_isNetworkGameLoaded = true;
+    m_snakeTime = sf::Time::Zero;
+    return true;
+}
+
+void GameState::endNetworkGame()
+{
+    m_isNetworkGame = false;
+    m_isNetworkGameLoaded = false;
+    m_isArenaGame = false;
+    m_localSnakeIndex = 0;
+    m_clientTransport.reset();
+    m_serverTransport.reset();
+}
+
+std::chrono::microseconds GameState::getNetworkTime() const
+{
+    return std::chrono::microseconds(m_networkClock.getElapsedTime().asMicroseconds());
+}
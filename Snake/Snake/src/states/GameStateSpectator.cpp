@@ -0,0 +1,91 @@
+#include "states/GameState.hpp"
+#include "states/StateManager.hpp"
+#include <cstdlib>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+// Watching a game from a spectator server and serving the own games to viewers
+
+bool GameState::serveSpectators(std::uint16_t port)
+{
+    m_spectatorServer = std::make_unique<SpectatorServer>();
+    if (!m_spectatorServer->listen(port))
+    {
+        m_spectatorServer.reset();
+        return false;
+    }
+    cout << "Spectators can watch on port " << port << endl;
+    return true;
+}
+
+bool GameState::spectateGame(const std::string& host, std::uint16_t port)
+{
+    m_spectatorClient = std::make_unique<SpectatorClient>();
+    if (!m_spectatorClient->connect(host, port))
+    {
+        m_spectatorClient.reset();
+        return false;
+    }
+    return true;
+}
+
+void GameState::updateSpectating()
+{
+    if (!m_spectatorClient->update())
+    {
+        cout << "The watched game ended" << endl;
+        endSpectating();
+        std::shared_ptr<StateManager> tmpStateManager = m_stateManager.lock();
+        if (tmpStateManager)
+            tmpStateManager->replaceCurrentState(StateManager::StateID::MainMenu);
+        return;
+    }
+
+    SpectatorDecoder& decoder = m_spectatorClient->getDecoder();
+    if (!decoder.hasKeyframe())
+        return;
+
+    const TileGrid& tileGrid = decoder.getGrid();
+    if (decoder.getKeyframeCount() != m_spectatorKeyframeCount)
+    {
+        // A new level or the server had to resync, everything is drawn again
+        m_spectatorKeyframeCount = decoder.getKeyframeCount();
+        m_gameGrid.loadFromTileGrid(tileGrid, decoder.getTileSize());
+        setupCamera();
+        if (m_spectatorServer)
+            m_spectatorServer->resync();
+    }
+    else if (!tileGrid.getChangedTiles().empty())
+    {
+        // The camera stays on its snake, the head closest to the last one after it moved
+        TileGrid::TileValue focusValue = TileGrid::TileValue::Empty;
+        if (!tileGrid.getTileValueAt(m_spectatorFocus, &focusValue) || focusValue != TileGrid::TileValue::SnakeHead)
+        {
+            int closestDistance = -1;
+            for (const auto& position : tileGrid.getChangedTiles())
+            {
+                TileGrid::TileValue value = TileGrid::TileValue::Empty;
+                tileGrid.getTileValueAt(position, &value);
+                const int distance = std::abs(position.x - m_spectatorFocus.x) + std::abs(position.y - m_spectatorFocus.y);
+                if (value == TileGrid::TileValue::SnakeHead && (closestDistance < 0 || distance < closestDistance))
+                {
+                    closestDistance = distance;
+                    m_spectatorFocus = position;
+                }
+            }
+        }
+        syncGameGrid();
+    }
+    decoder.getGrid().clearChangedTiles();
+
+    if (decoder.getScore() != m_score)
+        setScore(decoder.getScore());
+}
+
+void GameState::endSpectating()
+{
+    m_isSpectating = false;
+    m_spectatorClient.reset();
+}
@@ -4,51 +4,23 @@
 LevelSelectionState::LevelSelectionState(std::shared_ptr<sf::RenderWindow> window, std::weak_ptr<StateManager> stateManager, std::shared_ptr<ResourceManager> resourceManager)
 	:State(window, stateManager, resourceManager)
 {
-	auto font = resourceManager->getFont("font_menu");
-	if (font)
-	{
-		m_textTitle.setFont(*font);
-		m_textTitle.setString("Select Level");
-		m_textTitle.setCharacterSize(28);
-		m_textTitle.setFillColor(sf::Color::White);
-		m_textTitle.setLetterSpacing(1.5f);
-		m_textTitle.setPosition(400.0f - m_textTitle.getGlobalBounds().width / 2.0f, 120.0f);
-
-		m_textEscape.setFont(*font);
-		m_textEscape.setString("ESC to return");
-		m_textEscape.setCharacterSize(14);
-		m_textEscape.setFillColor(sf::Color::White);
-		m_textEscape.setPosition(400.0f - m_textEscape.getGlobalBounds().width / 2.0f, 520.0f);
-	}
+	m_texts.setAtlas(resourceManager->getGlyphAtlas("font_menu"));
 
-    // Setup sprites
-    auto tex1 = m_resourceManager->getTexture("level1");
-    auto tex2 = m_resourceManager->getTexture("level2");
-    auto tex3 = m_resourceManager->getTexture("level3");
+	TextBatch::Style titleStyle;
+	titleStyle.characterSize = 28;
+	titleStyle.letterSpacing = 1.5f;
+	m_textTitle = m_texts.addText("Select Level", titleStyle);
+	m_texts.setPosition(m_textTitle, sf::Vector2f(400.0f - m_texts.getBounds(m_textTitle).width / 2.0f, 120.0f));
 
-    if (tex1)
-        m_selectionSprites[0].setTexture(*tex1);
-    if (tex2)
-        m_selectionSprites[1].setTexture(*tex2);
-    if (tex3)
-        m_selectionSprites[2].setTexture(*tex3);
+	TextBatch::Style escapeStyle;
+	escapeStyle.characterSize = 14;
+	m_textEscape = m_texts.addText("ESC to return", escapeStyle);
+	m_texts.setPosition(m_textEscape, sf::Vector2f(400.0f - m_texts.getBounds(m_textEscape).width / 2.0f, 520.0f));
 
     m_selectionSprites[0].setPosition(54.0f, 230.0f);
     m_selectionSprites[1].setPosition(302.0f, 230.0f);
     m_selectionSprites[2].setPosition(550.0f, 230.0f);
 
-    // Setup selected sprites
-    auto tex1Selected = m_resourceManager->getTexture("level1_selected");
-    auto tex2Selected = m_resourceManager->getTexture("level2_selected");
-    auto tex3Selected = m_resourceManager->getTexture("level3_selected");
-
-    if (tex1Selected)
-        m_selectionSpritesSelected[0].setTexture(*tex1Selected);
-    if (tex2Selected)
-        m_selectionSpritesSelected[1].setTexture(*tex2Selected);
-    if (tex3Selected)
-        m_selectionSpritesSelected[2].setTexture(*tex3Selected);
-
     m_selectionSpritesSelected[0].setPosition(54.0f, 230.0f);
     m_selectionSpritesSelected[1].setPosition(302.0f, 230.0f);
     m_selectionSpritesSelected[2].setPosition(550.0f, 230.0f);
@@ -60,6 +32,16 @@ LevelSelectionState::~LevelSelectionState()
 
 void LevelSelectionState::enter()
 {
+    // The textures are loaded in the background, usually they are done long before this
+    const std::string textureNames[3] = {"level1", "level2", "level3"};
+    for (int i = 0; i < 3; ++i)
+    {
+        if (m_resourceManager->waitForResource(textureNames[i]))
+            m_selectionSprites[i].setTexture(*m_resourceManager->getTexture(textureNames[i]), true);
+        if (m_resourceManager->waitForResource(textureNames[i] + "_selected"))
+            m_selectionSpritesSelected[i].setTexture(*m_resourceManager->getTexture(textureNames[i] + "_selected"), true);
+    }
+
     setMenuItemSelection(0);
 }
 
@@ -153,8 +135,6 @@ void LevelSelectionState::render()
 
 void LevelSelectionState::renderAsNonTopState()
 {
-	m_window->draw(m_textTitle);
-
     if (m_currentSelection == 0)
     {
         m_window->draw(m_selectionSpritesSelected[0]);
@@ -174,7 +154,7 @@ void LevelSelectionState::renderAsNonTopState()
         m_window->draw(m_selectionSpritesSelected[2]);
     }
 
-	m_window->draw(m_textEscape);
+	m_window->draw(m_texts);
 }
 
 void LevelSelectionState::exit()
@@ -4,37 +4,28 @@
 MainMenuState::MainMenuState(std::shared_ptr<sf::RenderWindow> window, std::weak_ptr<StateManager> stateManager, std::shared_ptr<ResourceManager> resourceManager)
     :State(window, stateManager, resourceManager)
 {
-    auto font = resourceManager->getFont("font_menu");
-    if (font)
+    m_texts.setAtlas(resourceManager->getGlyphAtlas("font_menu"));
+
+    TextBatch::Style titleStyle;
+    titleStyle.characterSize = 52;
+    titleStyle.letterSpacing = 1.5f;
+    m_textTitle = m_texts.addText("SNAKE", titleStyle);
+    m_texts.setPosition(m_textTitle, sf::Vector2f(400.0f - m_texts.getBounds(m_textTitle).width / 2.0f, 140.0f));
+
+    const char* const menuStrings[] = {"play", "options", "exit"};
+    TextBatch::Style menuStyle;
+    menuStyle.characterSize = 20;
+    for (std::size_t i = 0; i < m_textListMenus.size(); ++i)
     {
-        m_textTitle.setFont(*font);
-        m_textTitle.setString("SNAKE");
-        m_textTitle.setCharacterSize(52);
-        m_textTitle.setFillColor(sf::Color::White);
-        m_textTitle.setLetterSpacing(1.5f);
-        m_textTitle.setPosition(400.0f - m_textTitle.getGlobalBounds().width / 2.0f, 140.0f);
-
-        m_textListMenus[0].setString("play");
-        m_textListMenus[1].setString("options");
-        m_textListMenus[2].setString("exit");
-
-        int i = 0;
-        for (auto& text : m_textListMenus)
-        {
-            text.setFont(*font);
-            text.setCharacterSize(20);
-            text.setFillColor(sf::Color::White);
-            text.setOutlineColor(sf::Color(0, 180, 0));
-            text.setPosition(400.0f - text.getGlobalBounds().width / 2.0f,
-                280.0f + i++ * 50.0f - text.getGlobalBounds().height / 2.0f);
-        }
-
-        m_textCopyright.setFont(*font);
-        m_textCopyright.setString(" tobias heiles");
-        m_textCopyright.setCharacterSize(14);
-        m_textCopyright.setFillColor(sf::Color::White);
-        m_textCopyright.setPosition(400.0f - m_textCopyright.getGlobalBounds().width / 2.0f, 550.0f);
+        m_textListMenus[i] = m_texts.addText(menuStrings[i], menuStyle);
+        const sf::FloatRect bounds = m_texts.getBounds(m_textListMenus[i]);
+        m_texts.setPosition(m_textListMenus[i], sf::Vector2f(400.0f - bounds.width / 2.0f, 280.0f + i * 50.0f - bounds.height / 2.0f));
     }
+
+    TextBatch::Style copyrightStyle;
+    copyrightStyle.characterSize = 14;
+    m_textCopyright = m_texts.addText(" tobias heiles", copyrightStyle);
+    m_texts.setPosition(m_textCopyright, sf::Vector2f(400.0f - m_texts.getBounds(m_textCopyright).width / 2.0f, 550.0f));
 }
 
 MainMenuState::~MainMenuState()
@@ -135,10 +126,7 @@ void MainMenuState::render()
 
 void MainMenuState::renderAsNonTopState()
 {
-	m_window->draw(m_textTitle);
-	for (const auto& text : m_textListMenus)
-		m_window->draw(text);
-	m_window->draw(m_textCopyright);
+	m_window->draw(m_texts);
 }
 
 void MainMenuState::exit()
@@ -150,9 +138,9 @@ bool MainMenuState::setMenuItemSelection(int index)
     if (index < 0 || index > 2/* || index == m_currentSelection*/)
         return false;
 
-    m_textListMenus[m_currentSelection].setFillColor(sf::Color::White);
+    m_texts.setFillColor(m_textListMenus[m_currentSelection], sf::Color::White);
     m_currentSelection = index;
-    m_textListMenus[m_currentSelection].setFillColor(sf::Color::Green);
+    m_texts.setFillColor(m_textListMenus[m_currentSelection], sf::Color::Green);
 
     return true;
 }
\ No newline at end of file
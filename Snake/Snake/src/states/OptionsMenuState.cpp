@@ -8,62 +8,59 @@
 OptionsMenuState::OptionsMenuState(std::shared_ptr<sf::RenderWindow> window, std::weak_ptr<StateManager> stateManager, std::shared_ptr<ResourceManager> resourceManager)
     :State(window, stateManager, resourceManager)
 {
-    auto font = resourceManager->getFont("font_menu");
-    if (font)
-    {
-        m_textTitle.setFont(*font);
-        m_textTitle.setString("Options");
-        m_textTitle.setCharacterSize(44);
-        m_textTitle.setLetterSpacing(1.5f);
-        m_textTitle.setPosition(400.0f - m_textTitle.getGlobalBounds().width / 2.0f, 140.0f);
-
-		m_textMusic.setFont(*font);
-		m_textMusic.setString("music");
-		m_textMusic.setCharacterSize(20);
-		m_textMusic.setPosition(400.0f - (m_textMusic.getGlobalBounds().width + 188.0f) / 2.0f,
-            140.0f + 3.0f * 50.0f - m_textMusic.getGlobalBounds().height / 2.0f);
-
-		m_textEffects.setFont(*font);
-		m_textEffects.setString("effects");
-		m_textEffects.setCharacterSize(20);
-		m_textEffects.setPosition(400.0f - (m_textEffects.getGlobalBounds().width + 188.0f) / 2.0f,
-			200.0f + 3.0f * 50.0f - m_textEffects.getGlobalBounds().height / 2.0f);
-
-        m_textReturn.setFont(*font);
-        m_textReturn.setString("return");
-        m_textReturn.setCharacterSize(20);
-        m_textReturn.setPosition(400.0f - m_textReturn.getGlobalBounds().width / 2.0f,
-            270.0f + 3.0f * 50.0f - m_textReturn.getGlobalBounds().height / 2.0f);
-
-        // Necessary to calculate the position of the volume shapes
-        sf::Vector2f effectTextPosition = m_textEffects.getPosition();
-        sf::Vector2f musicTextPosition = m_textMusic.getPosition();
-        float effectTextWidth = m_textEffects.getGlobalBounds().width;
-        float effectTextHeight = m_textEffects.getGlobalBounds().height;
-
-		for (int i = 0; i < 10; ++i)
-		{
-			m_effectVolumeShapes[i].setSize(sf::Vector2f(8, 20));
-            m_effectVolumeShapes[i].setPosition(effectTextPosition);
-			m_effectVolumeShapes[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
-			m_effectVolumeShapes[i].setFillColor(sf::Color::Transparent);
-			m_effectVolumeShapes[i].setOutlineThickness(2.0f);
-
-            m_effectVolumeShapesActive[i].setSize(sf::Vector2f(8, 20));
-            m_effectVolumeShapesActive[i].setPosition(effectTextPosition);
-            m_effectVolumeShapesActive[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
-
-            m_musicVolumeShapes[i].setSize(sf::Vector2f(8, 20));
-            m_musicVolumeShapes[i].setPosition(effectTextPosition.x, musicTextPosition.y);
-            m_musicVolumeShapes[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
-            m_musicVolumeShapes[i].setFillColor(sf::Color::Transparent);
-            m_musicVolumeShapes[i].setOutlineThickness(2.0f);
-
-            m_musicVolumeShapesActive[i].setSize(sf::Vector2f(8, 20));
-            m_musicVolumeShapesActive[i].setPosition(effectTextPosition.x, musicTextPosition.y);
-            m_musicVolumeShapesActive[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
-		}
-    }
+    m_texts.setAtlas(resourceManager->getGlyphAtlas("font_menu"));
+
+    TextBatch::Style titleStyle;
+    titleStyle.characterSize = 44;
+    titleStyle.letterSpacing = 1.5f;
+    m_textTitle = m_texts.addText("Options", titleStyle);
+    m_texts.setPosition(m_textTitle, sf::Vector2f(400.0f - m_texts.getBounds(m_textTitle).width / 2.0f, 140.0f));
+
+    TextBatch::Style menuStyle;
+    menuStyle.characterSize = 20;
+	m_textMusic = m_texts.addText("music", menuStyle);
+    const sf::FloatRect musicBounds = m_texts.getBounds(m_textMusic);
+    const sf::Vector2f musicTextPosition(400.0f - (musicBounds.width + 188.0f) / 2.0f,
+        140.0f + 3.0f * 50.0f - musicBounds.height / 2.0f);
+	m_texts.setPosition(m_textMusic, musicTextPosition);
+
+	m_textEffects = m_texts.addText("effects", menuStyle);
+    const sf::FloatRect effectsBounds = m_texts.getBounds(m_textEffects);
+    const sf::Vector2f effectTextPosition(400.0f - (effectsBounds.width + 188.0f) / 2.0f,
+		200.0f + 3.0f * 50.0f - effectsBounds.height / 2.0f);
+	m_texts.setPosition(m_textEffects, effectTextPosition);
+
+    m_textReturn = m_texts.addText("return", menuStyle);
+    const sf::FloatRect returnBounds = m_texts.getBounds(m_textReturn);
+    m_texts.setPosition(m_textReturn, sf::Vector2f(400.0f - returnBounds.width / 2.0f,
+        270.0f + 3.0f * 50.0f - returnBounds.height / 2.0f));
+
+    // Necessary to calculate the position of the volume shapes
+    float effectTextWidth = effectsBounds.width;
+    float effectTextHeight = effectsBounds.height;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		m_effectVolumeShapes[i].setSize(sf::Vector2f(8, 20));
+        m_effectVolumeShapes[i].setPosition(effectTextPosition);
+		m_effectVolumeShapes[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
+		m_effectVolumeShapes[i].setFillColor(sf::Color::Transparent);
+		m_effectVolumeShapes[i].setOutlineThickness(2.0f);
+
+        m_effectVolumeShapesActive[i].setSize(sf::Vector2f(8, 20));
+        m_effectVolumeShapesActive[i].setPosition(effectTextPosition);
+        m_effectVolumeShapesActive[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
+
+        m_musicVolumeShapes[i].setSize(sf::Vector2f(8, 20));
+        m_musicVolumeShapes[i].setPosition(effectTextPosition.x, musicTextPosition.y);
+        m_musicVolumeShapes[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
+        m_musicVolumeShapes[i].setFillColor(sf::Color::Transparent);
+        m_musicVolumeShapes[i].setOutlineThickness(2.0f);
+
+        m_musicVolumeShapesActive[i].setSize(sf::Vector2f(8, 20));
+        m_musicVolumeShapesActive[i].setPosition(effectTextPosition.x, musicTextPosition.y);
+        m_musicVolumeShapesActive[i].move(effectTextWidth + 50.0f + i * 16.0f, static_cast<int>(effectTextHeight / 2.0f) - 10.0f);
+	}
 
     auto soundBuffer = resourceManager->getSoundBuffer("sound_volume_up");
     if (soundBuffer)
@@ -166,8 +163,6 @@ void OptionsMenuState::render()
 
 void OptionsMenuState::renderAsNonTopState()
 {
-	m_window->draw(m_textTitle);
-
     // Draw all inactive shapes since the
     // active shapes "fill" the inactive ones
 	for (const auto& shape : m_musicVolumeShapes)
@@ -180,9 +175,7 @@ void OptionsMenuState::renderAsNonTopState()
 	for (int i = 0; i < m_effectVolume; ++i)
 		m_window->draw(m_effectVolumeShapesActive[i]);
 
-	m_window->draw(m_textMusic);
-	m_window->draw(m_textEffects);
-	m_window->draw(m_textReturn);
+	m_window->draw(m_texts);
 }
 
 void OptionsMenuState::exit()
@@ -211,9 +204,9 @@ bool OptionsMenuState::setMenuItemSelection(int index)
             m_effectVolumeShapes[i].setOutlineColor(sf::Color::White);
             m_effectVolumeShapesActive[i].setFillColor(sf::Color::White);
 		}
-		m_textMusic.setFillColor(sf::Color::Green);
-		m_textEffects.setFillColor(sf::Color::White);
-		m_textReturn.setFillColor(sf::Color::White);
+		m_texts.setFillColor(m_textMusic, sf::Color::Green);
+		m_texts.setFillColor(m_textEffects, sf::Color::White);
+		m_texts.setFillColor(m_textReturn, sf::Color::White);
 	}
     // Effects
 	else if (index == 1)
@@ -226,9 +219,9 @@ bool OptionsMenuState::setMenuItemSelection(int index)
             m_effectVolumeShapes[i].setOutlineColor(sf::Color::Green);
             m_effectVolumeShapesActive[i].setFillColor(sf::Color::Green);
 		}
-		m_textMusic.setFillColor(sf::Color::White);
-		m_textEffects.setFillColor(sf::Color::Green);
-		m_textReturn.setFillColor(sf::Color::White);
+		m_texts.setFillColor(m_textMusic, sf::Color::White);
+		m_texts.setFillColor(m_textEffects, sf::Color::Green);
+		m_texts.setFillColor(m_textReturn, sf::Color::White);
 	}
     // Return
 	else if (index == 2)
@@ -240,9 +233,9 @@ bool OptionsMenuState::setMenuItemSelection(int index)
 			m_effectVolumeShapes[i].setOutlineColor(sf::Color::White);
 			m_effectVolumeShapesActive[i].setFillColor(sf::Color::White);
 		}
-		m_textMusic.setFillColor(sf::Color::White);
-		m_textEffects.setFillColor(sf::Color::White);
-		m_textReturn.setFillColor(sf::Color::Green);
+		m_texts.setFillColor(m_textMusic, sf::Color::White);
+		m_texts.setFillColor(m_textEffects, sf::Color::White);
+		m_texts.setFillColor(m_textReturn, sf::Color::Green);
 	}
 
     m_currentSelection = index;
@@ -256,7 +249,7 @@ void OptionsMenuState::lowerVolume()
 	{
 		--m_musicVolume;
         if (m_musicVolume == 0)
-            m_textMusic.setStyle(sf::Text::Style::StrikeThrough);
+            m_texts.setStrikeThrough(m_textMusic, true);
 
         std::shared_ptr<StateManager> tmpStateManager = m_stateManager.lock();
         if (tmpStateManager)
@@ -268,7 +261,7 @@ void OptionsMenuState::lowerVolume()
         m_soundVolumeDown.play();
 		--m_effectVolume;
         if (m_effectVolume == 0)
-            m_textEffects.setStyle(sf::Text::Style::StrikeThrough);
+            m_texts.setStrikeThrough(m_textEffects, true);
 
         std::shared_ptr<StateManager> tmpStateManager = m_stateManager.lock();
         if (tmpStateManager)
@@ -282,7 +275,7 @@ void OptionsMenuState::raiseVolume()
 	if (m_currentSelection == 0 && m_musicVolume < 10)
 	{
         if (m_musicVolume == 0)
-            m_textMusic.setStyle(sf::Text::Style::Regular);
+            m_texts.setStrikeThrough(m_textMusic, false);
 		++m_musicVolume;
 
         std::shared_ptr<StateManager> tmpStateManager = m_stateManager.lock();
@@ -294,7 +287,7 @@ void OptionsMenuState::raiseVolume()
 	{
         m_soundVolumeUp.play();
         if (m_effectVolume == 0)
-            m_textEffects.setStyle(sf::Text::Style::Regular);
+            m_texts.setStrikeThrough(m_textEffects, false);
 		++m_effectVolume;
 
         std::shared_ptr<StateManager> tmpStateManager = m_stateManager.lock();
@@ -4,32 +4,22 @@
 PauseState::PauseState(std::shared_ptr<sf::RenderWindow> window, std::weak_ptr<StateManager> stateManager, std::shared_ptr<ResourceManager> resourceManager)
 	:State(window, stateManager, resourceManager)
 {
-	auto font = resourceManager->getFont("font_menu");
-	if (font)
-	{
-        m_textListMenus[0].setString("resume");
-        m_textListMenus[1].setString("options");
-        m_textListMenus[2].setString("exit");
+	m_texts.setAtlas(resourceManager->getGlyphAtlas("font_menu"));
 
-        int i = 0;
-        for (auto& text : m_textListMenus)
-        {
-            text.setFont(*font);
-            text.setCharacterSize(20);
-            text.setFillColor(sf::Color::White);
-            text.setOutlineColor(sf::Color(0, 180, 0));
-            text.setPosition(400.0f - text.getGlobalBounds().width / 2.0f,
-                280.0f + i++ * 50.0f - text.getGlobalBounds().height / 2.0f);
-        }
-	}
+    TextBatch::Style infoStyle;
+    infoStyle.characterSize = 38;
+    m_textInfo = m_texts.addText("PAUSED", infoStyle);
+	m_texts.setPosition(m_textInfo, sf::Vector2f(400.0f - m_texts.getBounds(m_textInfo).width / 2.0f, 180.0f));
 
-    m_textInfo.setFont(*font);
-    m_textInfo.setCharacterSize(38);
-    m_textInfo.setFillColor(sf::Color::White);
-    m_textInfo.setOutlineColor(sf::Color(0, 120, 0));
-    m_textInfo.setString("PAUSED");
-	m_textInfo.setPosition(400.0f - m_textInfo.getGlobalBounds().width / 2.0f,
-		180.0f);
+    const char* const menuStrings[] = {"resume", "options", "exit"};
+    TextBatch::Style menuStyle;
+    menuStyle.characterSize = 20;
+    for (std::size_t i = 0; i < m_textListMenus.size(); ++i)
+    {
+        m_textListMenus[i] = m_texts.addText(menuStrings[i], menuStyle);
+        const sf::FloatRect bounds = m_texts.getBounds(m_textListMenus[i]);
+        m_texts.setPosition(m_textListMenus[i], sf::Vector2f(400.0f - bounds.width / 2.0f, 280.0f + i * 50.0f - bounds.height / 2.0f));
+    }
     
     m_backgroundLayer.setSize(sf::Vector2f(800, 600));
     m_backgroundLayer.setFillColor(sf::Color(0, 0, 0, 220));
@@ -143,9 +133,7 @@ void PauseState::render()
 void PauseState::renderAsNonTopState()
 {
     m_window->draw(m_backgroundLayer);
-    m_window->draw(m_textInfo);
-    for (const auto& text : m_textListMenus)
-        m_window->draw(text);
+    m_window->draw(m_texts);
 }
 
 void PauseState::exit()
@@ -157,9 +145,9 @@ bool PauseState::setMenuItemSelection(int index)
     if (index < 0 || index > 2/* || index == m_currentSelection*/)
         return false;
 
-    m_textListMenus[m_currentSelection].setFillColor(sf::Color::White);
+    m_texts.setFillColor(m_textListMenus[m_currentSelection], sf::Color::White);
     m_currentSelection = index;
-    m_textListMenus[m_currentSelection].setFillColor(sf::Color::Green);
+    m_texts.setFillColor(m_textListMenus[m_currentSelection], sf::Color::Green);
 
     return true;
 }
@@ -6,10 +6,28 @@
 #include "states/OptionsMenuState.hpp"
 #include "states/PauseState.hpp"
 #include "states/GameOverState.hpp"
+#include "FrameProfiler.hpp"
+
+namespace
+{
+    // Scope names for the profiler, indexed by StateID
+    const char* const UPDATE_SCOPE_NAMES[] = {
+        "update InvalidState", "update Game", "update HighscoreMenu", "update LevelSelection",
+        "update MainMenu", "update Options", "update Pause", "update GameOver"
+    };
+    const char* const RENDER_SCOPE_NAMES[] = {
+        "render InvalidState", "render Game", "render HighscoreMenu", "render LevelSelection",
+        "render MainMenu", "render Options", "render Pause", "render GameOver"
+    };
+    static_assert(sizeof(UPDATE_SCOPE_NAMES) / sizeof(UPDATE_SCOPE_NAMES[0]) == static_cast<std::size_t>(StateManager::StateID::Count)
+        && sizeof(RENDER_SCOPE_NAMES) / sizeof(RENDER_SCOPE_NAMES[0]) == static_cast<std::size_t>(StateManager::StateID::Count),
+        "every state needs a profiler scope name");
+}
 
 StateManager::StateManager()
 {
     // Necessary to compile the unique_ptr<State>
+    m_infoStack.reserve(STATE_COUNT);
 }
 
 StateManager::~StateManager()
@@ -19,12 +37,12 @@ StateManager::~StateManager()
 
 void StateManager::init(std::shared_ptr<sf::RenderWindow> window, std::shared_ptr<ResourceManager> resourceManager)
 {
-    m_states.emplace(StateID::Game, std::make_unique<GameState>(window, shared_from_this(),resourceManager));
-    m_states.emplace(StateID::MainMenu, std::make_unique<MainMenuState>(window, shared_from_this(), resourceManager));
-	m_states.emplace(StateID::Options, std::make_unique<OptionsMenuState>(window, shared_from_this(), resourceManager));
-	m_states.emplace(StateID::GameOver, std::make_unique<GameOverState>(window, shared_from_this(), resourceManager));
-	m_states.emplace(StateID::Pause, std::make_unique<PauseState>(window, shared_from_this(), resourceManager));
-	m_states.emplace(StateID::LevelSelection, std::make_unique<LevelSelectionState>(window, shared_from_this(), resourceManager));
+    m_states[static_cast<std::size_t>(StateID::Game)] = std::make_unique<GameState>(window, shared_from_this(),resourceManager);
+    m_states[static_cast<std::size_t>(StateID::MainMenu)] = std::make_unique<MainMenuState>(window, shared_from_this(), resourceManager);
+	m_states[static_cast<std::size_t>(StateID::Options)] = std::make_unique<OptionsMenuState>(window, shared_from_this(), resourceManager);
+	m_states[static_cast<std::size_t>(StateID::GameOver)] = std::make_unique<GameOverState>(window, shared_from_this(), resourceManager);
+	m_states[static_cast<std::size_t>(StateID::Pause)] = std::make_unique<PauseState>(window, shared_from_this(), resourceManager);
+	m_states[static_cast<std::size_t>(StateID::LevelSelection)] = std::make_unique<LevelSelectionState>(window, shared_from_this(), resourceManager);
 
     pushState(StateID::MainMenu);
 
@@ -53,24 +71,13 @@ void StateManager::init(std::shared_ptr<sf::RenderWindow> window, std::shared_pt
 
 void StateManager::update(sf::Time elapsedTime)
 {
-	if (m_infoStack.empty())
-		return;
-
-	std::vector<StateID> statesToUpdate;
-
-    // Iterate in reverse since the last pushed state is updated first
-	for (auto it = m_infoStack.rbegin(); it != m_infoStack.rend(); ++it)
-	{
-		statesToUpdate.push_back(it->id);
-
-		// Stop queueing states once a state prohibits updating the state below
-		if (!it->updateStackBelow)
-			break;
-	}
-	for (auto it = statesToUpdate.rbegin(); it != statesToUpdate.rend(); ++it)
-	{
-		m_states[*it]->update(elapsedTime);
-	}
+    // Work on a copy, a state may change the stack while it is updated
+    ActiveStates statesToUpdate = m_statesToUpdate;
+    for (std::size_t i = 0; i < statesToUpdate.count; ++i)
+    {
+        SNAKE_PROFILE_SCOPE(UPDATE_SCOPE_NAMES[static_cast<std::size_t>(statesToUpdate.ids[i])]);
+        statesToUpdate.states[i]->update(elapsedTime);
+    }
 }
 
 void StateManager::processEvents()
@@ -89,9 +96,10 @@ void StateManager::processEvents()
 		}
 		return;
 	}
-	if (m_states.find(m_infoStack.back().id) != m_states.end())
+	State* topState = getState(m_infoStack.back().id);
+	if (topState)
 	{
-		m_states[m_infoStack.back().id]->processEvents();
+		topState->processEvents();
 	}
 }
 
@@ -100,50 +108,43 @@ void StateManager::processInput()
 	if (m_infoStack.empty())
 		return;
 
-	if (m_states.find(m_infoStack.back().id) != m_states.end())
+	State* topState = getState(m_infoStack.back().id);
+	if (topState)
 	{
-		m_states[m_infoStack.back().id]->processInput();
+		topState->processInput();
 	}
 }
 
 void StateManager::render()
 {
+    // Only draws, the application displays the frame so it can draw overlays on top
     m_window->clear();
 
     if (m_infoStack.empty())
         return;
 
-    std::vector<StateID> statesToRender;
-
-    // Iterate in reverse since the last pushed state is rendered on top
-	for (auto it = m_infoStack.rbegin(); it != m_infoStack.rend(); ++it)
-	{
-        statesToRender.push_back(it->id);
-
-        // Stop queueing states once a state does not render the state below
-        if (!it->renderStackBelow)
-            break;
-	}
-    for (auto it = statesToRender.rbegin(); it != statesToRender.rend(); ++it)
+    ActiveStates statesToRender = m_statesToRender;
+    for (std::size_t i = 0; i < statesToRender.count; ++i)
     {
-        m_states[*it]->renderAsNonTopState();
+        SNAKE_PROFILE_SCOPE(RENDER_SCOPE_NAMES[static_cast<std::size_t>(statesToRender.ids[i])]);
+        statesToRender.states[i]->renderAsNonTopState();
     }
-
-    m_window->display();
 }
 
 void StateManager::pushState(StateID stateID, bool renderStateBelow, bool updateStateBelow)
 {
 	m_infoStack.emplace_back(stateID, renderStateBelow, updateStateBelow);
-	m_states[stateID]->enter();
+    rebuildActiveStates();
+	getState(stateID)->enter();
 }
 
 void StateManager::popState()
 {
 	if (!m_infoStack.empty())
 	{
-		m_states[m_infoStack.back().id]->exit();
+		getState(m_infoStack.back().id)->exit();
 		m_infoStack.pop_back();
+        rebuildActiveStates();
 	}
 }
 
@@ -160,17 +161,92 @@ void StateManager::startTheMusic()
 
 void StateManager::setNextLevelForGameState(int levelIndex) const
 {
-    if (m_states.find(StateID::Game) != m_states.end())
+    State* gameState = getState(StateID::Game);
+    if (gameState)
+    {
+        static_cast<GameState*>(gameState)->setNextLevel(levelIndex);
+    }
+}
+
+void StateManager::setAISnakeCountForGameState(int count) const
+{
+    State* gameState = getState(StateID::Game);
+    if (gameState)
+    {
+        static_cast<GameState*>(gameState)->setAISnakeCount(count);
+    }
+}
+
+void StateManager::setMaxCatchUpTicksForGameState(int ticks) const
+{
+    State* gameState = getState(StateID::Game);
+    if (gameState)
     {
-        static_cast<GameState*>(m_states.at(StateID::Game).get())->setNextLevel(levelIndex);
+        static_cast<GameState*>(gameState)->setMaxCatchUpTicks(ticks);
     }
 }
 
+void StateManager::setTickRateForGameState(int ticksPerSecond) const
+{
+    State* gameState = getState(StateID::Game);
+    if (gameState)
+    {
+        static_cast<GameState*>(gameState)->setTickRate(ticksPerSecond);
+    }
+}
+
+void StateManager::playReplay(const Replay& replay, float speed)
+{
+    State* gameState = getState(StateID::Game);
+    if (gameState)
+    {
+        static_cast<GameState*>(gameState)->playReplay(replay, speed);
+        replaceCurrentState(StateID::Game);
+    }
+}
+
+bool StateManager::hostNetworkGame(std::uint16_t port, int playerCount)
+{
+    State* gameState = getState(StateID::Game);
+    if (!gameState || !static_cast<GameState*>(gameState)->hostNetworkGame(port, playerCount))
+        return false;
+
+    replaceCurrentState(StateID::Game);
+    return true;
+}
+
+bool StateManager::joinNetworkGame(const std::string& host, std::uint16_t port)
+{
+    State* gameState = getState(StateID::Game);
+    if (!gameState || !static_cast<GameState*>(gameState)->joinNetworkGame(host, port))
+        return false;
+
+    replaceCurrentState(StateID::Game);
+    return true;
+}
+
+bool StateManager::serveSpectators(std::uint16_t port)
+{
+    State* gameState = getState(StateID::Game);
+    return gameState && static_cast<GameState*>(gameState)->serveSpectators(port);
+}
+
+bool StateManager::spectateGame(const std::string& host, std::uint16_t port)
+{
+    State* gameState = getState(StateID::Game);
+    if (!gameState || !static_cast<GameState*>(gameState)->spectateGame(host, port))
+        return false;
+
+    replaceCurrentState(StateID::Game);
+    return true;
+}
+
 void StateManager::setScoreForGameOverState(int score) const
 {
-	if (m_states.find(StateID::GameOver) != m_states.end())
+	State* gameOverState = getState(StateID::GameOver);
+	if (gameOverState)
 	{
-		static_cast<GameOverState*>(m_states.at(StateID::GameOver).get())->setScore(score);
+		static_cast<GameOverState*>(gameOverState)->setScore(score);
 	}
 }
 
@@ -187,7 +263,8 @@ void StateManager::playSoundUIConfirm()
 void StateManager::setEffectsVolume(float volume)
 {
     for (const auto& state : m_states)
-        state.second->setEffectsVolume(volume);
+        if (state)
+            state->setEffectsVolume(volume);
 
     m_soundUI.setVolume(volume);
     m_soundUIConfirm.setVolume(volume);
@@ -197,3 +274,42 @@ void StateManager::setMusicVolume(float volume)
 {
     m_music.setVolume(volume);
 }
+
+State* StateManager::getState(StateID stateID) const
+{
+    return m_states[static_cast<std::size_t>(stateID)].get();
+}
+
+void StateManager::rebuildActiveStates()
+{
+    m_statesToUpdate.count = 0;
+    m_statesToRender.count = 0;
+
+    // Walk down from the top until a state stops updating or rendering the stack below it
+    std::size_t updateBegin = m_infoStack.size();
+    while (updateBegin > 0)
+    {
+        --updateBegin;
+        if (!m_infoStack[updateBegin].updateStackBelow)
+            break;
+    }
+    std::size_t renderBegin = m_infoStack.size();
+    while (renderBegin > 0)
+    {
+        --renderBegin;
+        if (!m_infoStack[renderBegin].renderStackBelow)
+            break;
+    }
+
+    // Bottom to top, the last pushed state is updated and rendered last
+    for (std::size_t i = updateBegin; i < m_infoStack.size() && m_statesToUpdate.count < STATE_COUNT; ++i)
+    {
+        m_statesToUpdate.ids[m_statesToUpdate.count] = m_infoStack[i].id;
+        m_statesToUpdate.states[m_statesToUpdate.count++] = getState(m_infoStack[i].id);
+    }
+    for (std::size_t i = renderBegin; i < m_infoStack.size() && m_statesToRender.count < STATE_COUNT; ++i)
+    {
+        m_statesToRender.ids[m_statesToRender.count] = m_infoStack[i].id;
+        m_statesToRender.states[m_statesToRender.count++] = getState(m_infoStack[i].id);
+    }
+}
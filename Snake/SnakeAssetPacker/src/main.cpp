@@ -0,0 +1,162 @@
+#include "AssetPack.hpp"
+#include "ResourceList.hpp"
+
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Graphics/Image.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Packs every resource of RESOURCE_LIST into one asset pack.
+// Usage: SnakeAssetPacker <output file> [directory that contains the resources folder]
+
+namespace
+{
+    struct PackedAsset
+    {
+        AssetPackEntry entry;
+        std::vector<char> payload;
+    };
+
+    bool packFont(const std::string& path, PackedAsset& asset)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        asset.payload.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !asset.payload.empty();
+    }
+
+    bool packTexture(const std::string& path, PackedAsset& asset)
+    {
+        sf::Image image;
+        if (!image.loadFromFile(path))
+            return false;
+
+        const sf::Vector2u size = image.getSize();
+        const char* pixels = reinterpret_cast<const char*>(image.getPixelsPtr());
+        asset.entry.widthOrChannelCount = size.x;
+        asset.entry.heightOrSampleRate = size.y;
+        asset.payload.assign(pixels, pixels + static_cast<std::size_t>(size.x) * size.y * 4);
+        return true;
+    }
+
+    bool packSound(const std::string& path, PackedAsset& asset)
+    {
+        sf::InputSoundFile soundFile;
+        if (!soundFile.openFromFile(path))
+            return false;
+
+        std::vector<sf::Int16> samples(static_cast<std::size_t>(soundFile.getSampleCount()));
+        if (soundFile.read(samples.data(), samples.size()) != samples.size())
+            return false;
+
+        const char* bytes = reinterpret_cast<const char*>(samples.data());
+        asset.entry.widthOrChannelCount = soundFile.getChannelCount();
+        asset.entry.heightOrSampleRate = soundFile.getSampleRate();
+        asset.payload.assign(bytes, bytes + samples.size() * sizeof(sf::Int16));
+        return true;
+    }
+
+    std::uint64_t alignOffset(std::uint64_t offset)
+    {
+        return (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " <output file> [resource root]" << endl;
+        return 1;
+    }
+
+    const std::string outputPath = argv[1];
+    const std::string root = argc > 2 ? std::string(argv[2]) + "/" : "";
+
+    std::vector<PackedAsset> assets;
+    assets.reserve(RESOURCE_LIST.size());
+
+    for (const auto& resource : RESOURCE_LIST)
+    {
+        PackedAsset asset {};
+        std::strncpy(asset.entry.identifier, resource.identifier, ASSET_IDENTIFIER_LENGTH - 1);
+        asset.entry.type = resource.type;
+
+        const std::string path = root + resource.path;
+        bool success = false;
+        switch (resource.type)
+        {
+        case AssetType::Font:
+            success = packFont(path, asset);
+            break;
+        case AssetType::Texture:
+            success = packTexture(path, asset);
+            break;
+        case AssetType::SoundBuffer:
+            success = packSound(path, asset);
+            break;
+        }
+
+        if (!success)
+        {
+            cerr << "Error packing " << path << endl;
+            return 1;
+        }
+        assets.push_back(std::move(asset));
+    }
+
+    // Payloads follow the table of contents, each one aligned
+    std::uint64_t offset = sizeof(AssetPackHeader) + assets.size() * sizeof(AssetPackEntry);
+    for (auto& asset : assets)
+    {
+        offset = alignOffset(offset);
+        asset.entry.offset = offset;
+        asset.entry.size = asset.payload.size();
+        offset += asset.payload.size();
+    }
+
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        cerr << "Error opening " << outputPath << endl;
+        return 1;
+    }
+
+    AssetPackHeader header {};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = static_cast<std::uint32_t>(assets.size());
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& asset : assets)
+        output.write(reinterpret_cast<const char*>(&asset.entry), sizeof(asset.entry));
+
+    std::uint64_t written = sizeof(AssetPackHeader) + assets.size() * sizeof(AssetPackEntry);
+    const char padding[ASSET_PACK_ALIGNMENT] = {};
+    for (const auto& asset : assets)
+    {
+        output.write(padding, static_cast<std::streamsize>(asset.entry.offset - written));
+        output.write(asset.payload.data(), static_cast<std::streamsize>(asset.payload.size()));
+        written = asset.entry.offset + asset.payload.size();
+    }
+
+    if (!output)
+    {
+        cerr << "Error writing " << outputPath << endl;
+        return 1;
+    }
+
+    cout << "Packed " << assets.size() << " resources into " << outputPath << " (" << written << " bytes)" << endl;
+    return 0;
+}
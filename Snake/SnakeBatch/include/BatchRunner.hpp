@@ -0,0 +1,43 @@
+#ifndef BATCH_RUNNER_HPP
+#define BATCH_RUNNER_HPP
+
+#include "simulation/HamiltonianCycle.hpp"
+#include "simulation/Simulation.hpp"
+#include <string>
+#include <vector>
+
+enum class InputPolicy
+{
+    Random,     // Turns at random, even into walls
+    SafeRandom, // Keeps going and turns at random, but avoids deadly tiles when it can
+    Scripted,   // Repeats a fixed input sequence
+    Autopilot,  // Follows the shortest path to the nearest food, without a time limit for the search
+    Cycle       // Follows a Hamiltonian cycle of the level with shortcuts, plays until the snake fills the cycle
+};
+
+struct GameConfig
+{
+    int levelIndex {0};
+    unsigned int seed {0};
+    InputPolicy policy {InputPolicy::SafeRandom};
+    std::vector<Simulation::PlayerInput> script; // Only used by InputPolicy::Scripted
+    const HamiltonianCycle* cycle {nullptr};       // Only used by InputPolicy::Cycle, has to belong to the level
+    long long maxTicks {100000};
+};
+
+struct GameResult
+{
+    int levelIndex {0};
+    int score {0};
+    long long ticks {0};
+    bool died {false};
+    int snakeLength {0};
+};
+
+// Plays one complete game without a window, the same config always gives the same result
+GameResult runGame(const LevelData& level, const GameConfig& config);
+
+// Parses a script like "UURDDL", returns false on unknown characters
+bool parseInputScript(const std::string& text, std::vector<Simulation::PlayerInput>* script);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool with one task queue per worker. A worker takes tasks from the back of its own queue
+// and steals from the front of the others once it runs dry, so long games don't leave cores idle.
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(unsigned int threadCount);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Tasks are spread round robin over the worker queues, only submit from one thread
+    void submit(Task task);
+    // Blocks until every submitted task has finished
+    void wait();
+
+    unsigned int getThreadCount() const;
+    std::size_t getStolenTaskCount() const;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned int workerIndex);
+    bool takeTask(unsigned int workerIndex, Task* task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_stateMutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_allTasksDone;
+    std::atomic<std::size_t> m_queuedTaskCount {0};   // Submitted, not yet taken
+    std::atomic<std::size_t> m_unfinishedTaskCount {0}; // Submitted, not yet finished
+    std::atomic<std::size_t> m_stolenTaskCount {0};
+    std::size_t m_nextQueue {0};
+    bool m_stopping {false};
+};
+
+#endif
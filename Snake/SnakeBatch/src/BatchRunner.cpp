@@ -0,0 +1,119 @@
+#include "BatchRunner.hpp"
+#include "simulation/Autopilot.hpp"
+#include "simulation/CycleFollower.hpp"
+#include <random>
+
+namespace
+{
+    bool isSafeInput(const Simulation& simulation, Simulation::PlayerInput input)
+    {
+        if (Simulation::isOppositeDirection(input, simulation.getLastMovement()))
+            return false;
+
+        TileGrid::TileValue tileValue;
+        if (!simulation.getGrid().getTileValueAt(simulation.getSnake().getHead() + Simulation::getDirection(input), &tileValue))
+            return false;
+
+        switch (tileValue)
+        {
+        case TileGrid::TileValue::Empty:
+        case TileGrid::TileValue::Food:
+        case TileGrid::TileValue::SuperFood:
+        case TileGrid::TileValue::Teleport1:
+        case TileGrid::TileValue::Teleport2:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+GameResult runGame(const LevelData& level, const GameConfig& config)
+{
+    GameResult result;
+    result.levelIndex = config.levelIndex;
+
+    Simulation simulation;
+    simulation.seed(config.seed);
+    if (!simulation.loadLevel(level))
+        return result;
+
+    // Separate generator for the inputs, the simulation's own random numbers stay untouched
+    std::mt19937 inputGenerator(config.seed ^ 0x9E3779B9u);
+    Simulation::PlayerInput input = Simulation::PlayerInput::Up;
+    Autopilot autopilot;
+    CycleFollower cycleFollower;
+    cycleFollower.reset(config.cycle);
+
+    while (!simulation.isSnakeDead() && result.ticks < config.maxTicks)
+    {
+        switch (config.policy)
+        {
+        case InputPolicy::Random:
+            if (inputGenerator() % 8 == 0)
+                input = static_cast<Simulation::PlayerInput>(inputGenerator() % 4);
+            break;
+        case InputPolicy::SafeRandom:
+            if (!isSafeInput(simulation, input) || inputGenerator() % 8 == 0)
+            {
+                const unsigned int first = inputGenerator() % 4;
+                for (unsigned int i = 0; i < 4; ++i)
+                {
+                    const auto candidate = static_cast<Simulation::PlayerInput>((first + i) % 4);
+                    if (isSafeInput(simulation, candidate))
+                    {
+                        input = candidate;
+                        break;
+                    }
+                }
+            }
+            break;
+        case InputPolicy::Scripted:
+            if (!config.script.empty())
+                input = config.script[static_cast<std::size_t>(result.ticks % config.script.size())];
+            break;
+        case InputPolicy::Autopilot:
+            // A budget that is never used up, so the result doesn't depend on the machine
+            autopilot.think(simulation, std::chrono::hours(1));
+            input = autopilot.getInput(simulation);
+            break;
+        case InputPolicy::Cycle:
+            input = cycleFollower.getInput(simulation);
+            break;
+        }
+
+        simulation.step(input);
+        ++result.ticks;
+    }
+
+    result.score = simulation.getScore();
+    result.died = simulation.isSnakeDead();
+    result.snakeLength = static_cast<int>(simulation.getSnake().size());
+    return result;
+}
+
+bool parseInputScript(const std::string& text, std::vector<Simulation::PlayerInput>* script)
+{
+    script->clear();
+    for (char character : text)
+    {
+        switch (character)
+        {
+        case 'U': case 'u':
+            script->push_back(Simulation::PlayerInput::Up);
+            break;
+        case 'D': case 'd':
+            script->push_back(Simulation::PlayerInput::Down);
+            break;
+        case 'L': case 'l':
+            script->push_back(Simulation::PlayerInput::Left);
+            break;
+        case 'R': case 'r':
+            script->push_back(Simulation::PlayerInput::Right);
+            break;
+        default:
+            return false;
+        }
+    }
+    return !script->empty();
+}
@@ -0,0 +1,112 @@
+#include "WorkStealingPool.hpp"
+
+WorkStealingPool::WorkStealingPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = 1;
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    {
+        // Counted before the task is visible, so a worker can't finish it before it is counted
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        ++m_unfinishedTaskCount;
+        ++m_queuedTaskCount;
+    }
+
+    const std::size_t queueIndex = m_nextQueue++ % m_queues.size();
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queueIndex]->mutex);
+        m_queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    m_workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_stateMutex);
+    m_allTasksDone.wait(lock, [this] { return m_unfinishedTaskCount == 0; });
+}
+
+unsigned int WorkStealingPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(m_threads.size());
+}
+
+std::size_t WorkStealingPool::getStolenTaskCount() const
+{
+    return m_stolenTaskCount;
+}
+
+void WorkStealingPool::workerLoop(unsigned int workerIndex)
+{
+    for (;;)
+    {
+        Task task;
+        if (takeTask(workerIndex, &task))
+        {
+            task();
+
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            if (--m_unfinishedTaskCount == 0)
+                m_allTasksDone.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_stateMutex);
+        m_workAvailable.wait(lock, [this] { return m_stopping || m_queuedTaskCount > 0; });
+        if (m_stopping && m_queuedTaskCount == 0)
+            return;
+    }
+}
+
+bool WorkStealingPool::takeTask(unsigned int workerIndex, Task* task)
+{
+    // Own queue first, newest task first
+    {
+        WorkerQueue& queue = *m_queues[workerIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            *task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --m_queuedTaskCount;
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker
+    for (std::size_t offset = 1; offset < m_queues.size(); ++offset)
+    {
+        WorkerQueue& queue = *m_queues[(workerIndex + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            *task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --m_queuedTaskCount;
+            ++m_stolenTaskCount;
+            return true;
+        }
+    }
+    return false;
+}
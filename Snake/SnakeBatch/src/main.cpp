@@ -0,0 +1,233 @@
+#include "BatchRunner.hpp"
+#include "WorkStealingPool.hpp"
+#include "simulation/LevelPack.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Plays many headless games on all cores and reports throughput and score distributions.
+// Usage: SnakeBatch [--games N] [--threads N] [--levels <level pack>] [--level N|all] [--policy random|safe|script|autopilot|cycle]
+//                   [--script UDLR...] [--seed N] [--max-ticks N] [--min-ticks-per-second N]
+// Without --levels the builtin levels are played. The cycle policy solves each played level once and caches
+// the cycles in CYCLE_CACHE_DIRECTORY.
+
+namespace
+{
+    const std::string CYCLE_CACHE_DIRECTORY = "cycles";
+
+    struct Options
+    {
+        long long games {1000};
+        unsigned int threads {0};
+        std::string levelPackPath;
+        int level {-1}; // -1 cycles through all levels
+        InputPolicy policy {InputPolicy::SafeRandom};
+        std::vector<Simulation::PlayerInput> script;
+        unsigned int seed {1};
+        long long maxTicks {100000};
+        double minTicksPerSecond {0.0};
+    };
+
+    bool parseOptions(int argc, char* argv[], Options* options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const std::string value = argv[++i];
+
+            if (argument == "--games")
+                options->games = std::stoll(value);
+            else if (argument == "--threads")
+                options->threads = static_cast<unsigned int>(std::stoul(value));
+            else if (argument == "--levels")
+                options->levelPackPath = value;
+            else if (argument == "--level")
+                options->level = value == "all" ? -1 : std::stoi(value) - 1;
+            else if (argument == "--policy" && value == "random")
+                options->policy = InputPolicy::Random;
+            else if (argument == "--policy" && value == "safe")
+                options->policy = InputPolicy::SafeRandom;
+            else if (argument == "--policy" && value == "script")
+                options->policy = InputPolicy::Scripted;
+            else if (argument == "--policy" && value == "autopilot")
+                options->policy = InputPolicy::Autopilot;
+            else if (argument == "--policy" && value == "cycle")
+                options->policy = InputPolicy::Cycle;
+            else if (argument == "--script")
+            {
+                if (!parseInputScript(value, &options->script))
+                    return false;
+            }
+            else if (argument == "--seed")
+                options->seed = static_cast<unsigned int>(std::stoul(value));
+            else if (argument == "--max-ticks")
+                options->maxTicks = std::stoll(value);
+            else if (argument == "--min-ticks-per-second")
+                options->minTicksPerSecond = std::stod(value);
+            else
+                return false;
+        }
+
+        if (options->level < -1 || options->games <= 0)
+            return false;
+        if (options->policy == InputPolicy::Scripted && options->script.empty())
+            return false;
+        return true;
+    }
+
+    void printScoreDistribution(const std::string& name, std::vector<GameResult> results)
+    {
+        if (results.empty())
+            return;
+
+        std::sort(results.begin(), results.end(), [](const GameResult& a, const GameResult& b) { return a.score < b.score; });
+
+        long long scoreSum = 0;
+        long long tickSum = 0;
+        long long deaths = 0;
+        int maxSnakeLength = 0;
+        for (const auto& result : results)
+        {
+            maxSnakeLength = std::max(maxSnakeLength, result.snakeLength);
+            scoreSum += result.score;
+            tickSum += result.ticks;
+            deaths += result.died ? 1 : 0;
+        }
+
+        const auto percentile = [&results](double fraction) {
+            return results[static_cast<std::size_t>(fraction * (results.size() - 1))].score;
+        };
+
+        cout << std::left << std::setw(8) << name << std::right
+            << std::setw(8) << results.size()
+            << std::setw(8) << deaths
+            << std::setw(8) << results.front().score
+            << std::setw(10) << std::fixed << std::setprecision(2) << static_cast<double>(scoreSum) / results.size()
+            << std::setw(8) << percentile(0.5)
+            << std::setw(8) << percentile(0.9)
+            << std::setw(8) << results.back().score
+            << std::setw(12) << std::setprecision(1) << static_cast<double>(tickSum) / results.size()
+            << std::setw(12) << maxSnakeLength << endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, &options))
+    {
+        cerr << "Usage: " << argv[0] << " [--games N] [--threads N] [--levels <level pack>] [--level N|all] [--policy random|safe|script|autopilot|cycle]" << endl
+            << "       [--script UDLR...] [--seed N] [--max-ticks N] [--min-ticks-per-second N]" << endl;
+        return 1;
+    }
+
+    // Levels that are not played are never decoded
+    std::vector<LevelData> levels;
+    if (options.levelPackPath.empty())
+    {
+        for (int i = 0; i < BUILTIN_LEVEL_COUNT; ++i)
+            levels.push_back(buildBuiltinLevel(i));
+    }
+    else
+    {
+        LevelPack levelPack;
+        if (!levelPack.open(options.levelPackPath))
+            return 1;
+
+        levels.resize(levelPack.getLevelCount());
+        for (int i = 0; i < levelPack.getLevelCount(); ++i)
+        {
+            if ((options.level < 0 || options.level == i) && !levelPack.loadLevel(i, &levels[i]))
+                return 1;
+        }
+    }
+    const int levelCount = static_cast<int>(levels.size());
+
+    if (options.level >= levelCount || levelCount == 0)
+    {
+        cerr << "Level " << options.level + 1 << " does not exist, there are " << levelCount << " levels" << endl;
+        return 1;
+    }
+
+    std::vector<HamiltonianCycle> cycles(levels.size());
+    if (options.policy == InputPolicy::Cycle)
+    {
+        for (int i = 0; i < levelCount; ++i)
+        {
+            if ((options.level < 0 || options.level == i) && !cycles[i].loadOrSolve(levels[i], CYCLE_CACHE_DIRECTORY))
+                return 1;
+        }
+    }
+
+    std::vector<GameResult> results(static_cast<std::size_t>(options.games));
+    const unsigned int threadCount = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    const auto begin = std::chrono::steady_clock::now();
+    std::size_t stolenTasks = 0;
+    {
+        WorkStealingPool pool(threadCount);
+        for (long long game = 0; game < options.games; ++game)
+        {
+            // Each game only depends on its index, the results don't change with the thread count
+            pool.submit([&, game] {
+                GameConfig config;
+                config.levelIndex = options.level >= 0 ? options.level : static_cast<int>(game % levelCount);
+                config.seed = options.seed + static_cast<unsigned int>(game);
+                config.policy = options.policy;
+                config.script = options.script;
+                config.cycle = &cycles[config.levelIndex];
+                config.maxTicks = options.maxTicks;
+                results[static_cast<std::size_t>(game)] = runGame(levels[config.levelIndex], config);
+            });
+        }
+        pool.wait();
+        stolenTasks = pool.getStolenTaskCount();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    long long totalTicks = 0;
+    for (const auto& result : results)
+        totalTicks += result.ticks;
+    const double ticksPerSecond = totalTicks / seconds;
+
+    cout << "Games:        " << options.games << " on " << threadCount << " threads (" << stolenTasks << " stolen)" << endl;
+    cout << "Wall time:    " << std::fixed << std::setprecision(3) << seconds << " s" << endl;
+    cout << "Ticks:        " << totalTicks << endl;
+    cout << "Ticks/s:      " << std::setprecision(0) << ticksPerSecond << endl;
+    cout << "Games/s:      " << std::setprecision(1) << options.games / seconds << endl << endl;
+
+    cout << std::left << std::setw(8) << "Level" << std::right << std::setw(8) << "Games" << std::setw(8) << "Died"
+        << std::setw(8) << "Min" << std::setw(10) << "Mean" << std::setw(8) << "Median" << std::setw(8) << "P90"
+        << std::setw(8) << "Max" << std::setw(12) << "Mean ticks" << std::setw(12) << "Max length" << endl;
+
+    for (int level = 0; level < levelCount; ++level)
+    {
+        std::vector<GameResult> levelResults;
+        for (const auto& result : results)
+        {
+            if (result.levelIndex == level)
+                levelResults.push_back(result);
+        }
+        printScoreDistribution(std::to_string(level + 1), levelResults);
+    }
+    if (options.level < 0)
+        printScoreDistribution("All", results);
+
+    if (options.minTicksPerSecond > 0.0 && ticksPerSecond < options.minTicksPerSecond)
+    {
+        cerr << "Throughput " << static_cast<long long>(ticksPerSecond) << " ticks/s is below the required "
+            << static_cast<long long>(options.minTicksPerSecond) << endl;
+        return 2;
+    }
+    return 0;
+}
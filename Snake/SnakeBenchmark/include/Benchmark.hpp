@@ -0,0 +1,79 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+struct BenchmarkResult
+{
+    std::string name;
+    long long iterations;
+    double nanosecondsPerIteration;
+};
+
+// Only benchmarks whose name contains the filter run, an empty filter runs everything
+void setBenchmarkFilter(const std::string& filter);
+bool isBenchmarkEnabled(const std::string& name);
+void setBenchmarkMinimumTime(double seconds);
+double getBenchmarkMinimumTime();
+
+// Calls function iterations times and returns the average wall time per call
+template<typename Function>
+BenchmarkResult runBenchmark(const std::string& name, long long iterations, Function function)
+{
+    if (!isBenchmarkEnabled(name))
+        return BenchmarkResult {name, 0, 0.0};
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; ++i)
+        function();
+    auto end = std::chrono::steady_clock::now();
+
+    double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+    return BenchmarkResult {name, iterations, nanoseconds / iterations};
+}
+
+// Picks the iteration count like Google Benchmark: grows it until one run lasts the minimum time
+template<typename Function>
+BenchmarkResult runBenchmark(const std::string& name, Function function)
+{
+    if (!isBenchmarkEnabled(name))
+        return BenchmarkResult {name, 0, 0.0};
+
+    const double minimumNanoseconds = getBenchmarkMinimumTime() * 1e9;
+    long long iterations = 1;
+    for (;;)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i)
+            function();
+        auto end = std::chrono::steady_clock::now();
+
+        double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+        if (nanoseconds >= minimumNanoseconds || iterations >= 1000000000LL)
+            return BenchmarkResult {name, iterations, nanoseconds / iterations};
+
+        // Aim a bit past the minimum time, but never grow more than 10x at once
+        double predicted = nanoseconds > 0.0 ? iterations * minimumNanoseconds * 1.4 / nanoseconds : iterations * 10.0;
+        iterations = std::max(iterations + 1, std::min(iterations * 10, static_cast<long long>(predicted)));
+    }
+}
+
+// Prints the result and keeps it for the JSON report, skipped benchmarks are ignored
+void printBenchmarkResult(const BenchmarkResult& result);
+// Writes all kept results in the JSON layout of Google Benchmark
+bool writeBenchmarkJson(const std::string& path);
+
+void runSnakeMovementBenchmarks();
+void runFoodSpawnBenchmarks();
+void runGridStorageBenchmarks();
+void runTileGridBenchmarks();
+void runSimulationBenchmarks();
+void runHamiltonianCycleBenchmarks();
+void runVectorEnvironmentBenchmarks();
+void runSnakeArenaBenchmarks();
+void runRollbackBenchmarks();
+void runSpectatorStreamBenchmarks();
+
+#endif
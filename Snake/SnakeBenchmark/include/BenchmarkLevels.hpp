@@ -0,0 +1,36 @@
+#ifndef BENCHMARK_LEVELS_HPP
+#define BENCHMARK_LEVELS_HPP
+
+#include "simulation/Simulation.hpp"
+#include <string>
+#include <vector>
+
+// Walled level whose inner area is covered by one closed path. The snake lies on the path and
+// never dies as long as it follows nextInput, so any snake length can be stepped forever.
+struct CycleLevel
+{
+    LevelData level;
+    std::vector<Simulation::PlayerInput> nextInput; // Per tile, the direction along the path
+    std::string name;
+};
+
+// width and height include the walls, height - 2 has to be even. snakeFill is the share of the inner area
+CycleLevel buildCycleLevel(int width, int height, double snakeFill, int maxFood);
+
+// Walled maze with corridors and walls of two tiles, every corridor is reachable from every other one.
+// width and height should be 3 * n + 1 to use the whole area
+LevelData buildMazeLevel(int width, int height, unsigned int seed);
+
+// Empty level with walls only around the border, the snake starts in the top left corner
+LevelData buildOpenLevel(int width, int height);
+
+// One tile wide corridor with the snake lying in the lower part and freeTiles empty tiles above its head
+LevelData buildCorridorLevel(int snakeLength, int freeTiles);
+
+// Random mix of tiles, roughly 60 % empty, 10 % walls, 25 % snake and 5 % food. The same for every run
+std::vector<int> buildMixedGrid(int width, int height);
+
+// Grid data of the level with the snake written into it, for benchmarks that only need a TileGrid
+std::vector<int> buildGridDataWithSnake(const LevelData& level);
+
+#endif
@@ -0,0 +1,96 @@
+#include "Benchmark.hpp"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::string benchmarkFilter;
+    double benchmarkMinimumTime {0.2};
+    std::vector<BenchmarkResult> benchmarkResults;
+
+    std::string escapeJson(const std::string& text)
+    {
+        std::string escaped;
+        for (char character : text)
+        {
+            if (character == '"' || character == '\\')
+                escaped += '\\';
+            escaped += character;
+        }
+        return escaped;
+    }
+}
+
+void setBenchmarkFilter(const std::string& filter)
+{
+    benchmarkFilter = filter;
+}
+
+bool isBenchmarkEnabled(const std::string& name)
+{
+    return benchmarkFilter.empty() || name.find(benchmarkFilter) != std::string::npos;
+}
+
+void setBenchmarkMinimumTime(double seconds)
+{
+    benchmarkMinimumTime = seconds;
+}
+
+double getBenchmarkMinimumTime()
+{
+    return benchmarkMinimumTime;
+}
+
+void printBenchmarkResult(const BenchmarkResult& result)
+{
+    if (result.iterations == 0)
+        return;
+
+    benchmarkResults.push_back(result);
+
+    std::cout << std::left << std::setw(56) << result.name
+        << std::right << std::setw(12) << result.iterations << " iterations"
+        << std::setw(14) << std::fixed << std::setprecision(1) << result.nanosecondsPerIteration << " ns" << std::endl;
+}
+
+bool writeBenchmarkJson(const std::string& path)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "writeBenchmarkJson(): error opening " << path << std::endl;
+        return false;
+    }
+
+#ifdef NDEBUG
+    const char* buildType = "release";
+#else
+    const char* buildType = "debug";
+#endif
+
+    file << "{\n";
+    file << "  \"context\": {\n";
+    file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    file << "    \"library_build_type\": \"" << buildType << "\"\n";
+    file << "  },\n";
+    file << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < benchmarkResults.size(); ++i)
+    {
+        const BenchmarkResult& result = benchmarkResults[i];
+        file << "    {\n";
+        file << "      \"name\": \"" << escapeJson(result.name) << "\",\n";
+        file << "      \"run_type\": \"iteration\",\n";
+        file << "      \"iterations\": " << result.iterations << ",\n";
+        file << "      \"real_time\": " << std::setprecision(3) << std::fixed << result.nanosecondsPerIteration << ",\n";
+        file << "      \"cpu_time\": " << result.nanosecondsPerIteration << ",\n";
+        file << "      \"time_unit\": \"ns\"\n";
+        file << "    }" << (i + 1 < benchmarkResults.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+
+    return static_cast<bool>(file);
+}
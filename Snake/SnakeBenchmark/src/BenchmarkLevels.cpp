@@ -0,0 +1,189 @@
+#include "BenchmarkLevels.hpp"
+#include <algorithm>
+#include <random>
+
+CycleLevel buildCycleLevel(int width, int height, double snakeFill, int maxFood)
+{
+    CycleLevel cycleLevel;
+    LevelData& level = cycleLevel.level;
+    level.tileSize = sf::Vector2u(1, 1);
+    level.width = width;
+    level.height = height;
+    level.maxFood = maxFood;
+    level.gridData.assign(static_cast<std::size_t>(width) * height, static_cast<int>(TileGrid::TileValue::Wall));
+
+    const int innerWidth = width - 2;
+    const int innerHeight = height - 2;
+
+    // Rows are walked as a zigzag over the columns 1 and up, column 0 leads back to the start
+    std::vector<sf::Vector2i> path;
+    path.reserve(static_cast<std::size_t>(innerWidth) * innerHeight);
+    for (int y = 0; y < innerHeight; ++y)
+    {
+        if (y % 2 == 0)
+        {
+            for (int x = (y == 0 ? 0 : 1); x < innerWidth; ++x)
+                path.emplace_back(x + 1, y + 1);
+        }
+        else
+        {
+            for (int x = innerWidth - 1; x >= 1; --x)
+                path.emplace_back(x + 1, y + 1);
+        }
+    }
+    for (int y = innerHeight - 1; y >= 1; --y)
+        path.emplace_back(1, y + 1);
+
+    cycleLevel.nextInput.assign(level.gridData.size(), Simulation::PlayerInput::Up);
+    for (std::size_t i = 0; i < path.size(); ++i)
+    {
+        const sf::Vector2i position = path[i];
+        const sf::Vector2i step = path[(i + 1) % path.size()] - position;
+        level.gridData[position.x + position.y * width] = static_cast<int>(TileGrid::TileValue::Empty);
+
+        Simulation::PlayerInput input = Simulation::PlayerInput::Up;
+        if (step.x > 0)
+            input = Simulation::PlayerInput::Right;
+        else if (step.x < 0)
+            input = Simulation::PlayerInput::Left;
+        else if (step.y > 0)
+            input = Simulation::PlayerInput::Down;
+        cycleLevel.nextInput[position.x + position.y * width] = input;
+    }
+
+    // The tail sits at the start of the path, the head snakeLength - 1 tiles further
+    std::size_t snakeLength = static_cast<std::size_t>(snakeFill * path.size());
+    snakeLength = std::max<std::size_t>(2, std::min(snakeLength, path.size() - 1));
+    level.startBody.reserve(snakeLength);
+    for (std::size_t i = snakeLength; i > 0; --i)
+        level.startBody.push_back(path[i - 1]);
+
+    cycleLevel.name = std::to_string(width) + "x" + std::to_string(height) + "/fill:" + std::to_string(static_cast<int>(snakeFill * 100.0 + 0.5));
+    return cycleLevel;
+}
+
+LevelData buildOpenLevel(int width, int height)
+{
+    LevelData level;
+    level.tileSize = sf::Vector2u(1, 1);
+    level.width = width;
+    level.height = height;
+    level.gridData.assign(static_cast<std::size_t>(width) * height, static_cast<int>(TileGrid::TileValue::Empty));
+    for (int x = 0; x < width; ++x)
+    {
+        level.gridData[x] = static_cast<int>(TileGrid::TileValue::Wall);
+        level.gridData[x + (height - 1) * width] = static_cast<int>(TileGrid::TileValue::Wall);
+    }
+    for (int y = 0; y < height; ++y)
+    {
+        level.gridData[y * width] = static_cast<int>(TileGrid::TileValue::Wall);
+        level.gridData[width - 1 + y * width] = static_cast<int>(TileGrid::TileValue::Wall);
+    }
+    level.startPosition = sf::Vector2i(1, 1);
+    return level;
+}
+
+LevelData buildCorridorLevel(int snakeLength, int freeTiles)
+{
+    LevelData level;
+    level.tileSize = sf::Vector2u(1, 1);
+    level.width = 3;
+    level.height = snakeLength + freeTiles + 2;
+    level.startPosition = sf::Vector2i(1, freeTiles + 1);
+    level.startLength = snakeLength;
+    level.maxFood = 0; // Keep food spawning out of the measured tick
+
+    level.gridData.assign(level.width * level.height, static_cast<int>(TileGrid::TileValue::Wall));
+    for (int y = 1; y < level.height - 1; ++y)
+        level.gridData[1 + y * level.width] = static_cast<int>(TileGrid::TileValue::Empty);
+
+    return level;
+}
+
+std::vector<int> buildMixedGrid(int width, int height)
+{
+    std::default_random_engine randomGenerator(42);
+    std::uniform_int_distribution<int> distribution(0, 99);
+
+    std::vector<int> gridData(static_cast<std::size_t>(width) * height);
+    for (auto& tile : gridData)
+    {
+        int roll = distribution(randomGenerator);
+        TileGrid::TileValue value = TileGrid::TileValue::Empty;
+        if (roll >= 95)
+            value = TileGrid::TileValue::Food;
+        else if (roll >= 70)
+            value = TileGrid::TileValue::SnakeBody;
+        else if (roll >= 60)
+            value = TileGrid::TileValue::Wall;
+        tile = static_cast<int>(value);
+    }
+    return gridData;
+}
+
+LevelData buildMazeLevel(int width, int height, unsigned int seed)
+{
+    LevelData level;
+    level.tileSize = sf::Vector2u(1, 1);
+    level.width = width;
+    level.height = height;
+    level.gridData.assign(static_cast<std::size_t>(width) * height, static_cast<int>(TileGrid::TileValue::Wall));
+
+    // Cells of 2x2 tiles with a wall line between them, a depth first search opens the walls of a spanning tree
+    const int cellsPerRow = (width - 1) / 3;
+    const int cellRows = (height - 1) / 3;
+    auto openTiles = [&](int x, int y, int tilesX, int tilesY)
+    {
+        for (int tileY = y; tileY < y + tilesY; ++tileY)
+            for (int tileX = x; tileX < x + tilesX; ++tileX)
+                level.gridData[tileX + tileY * width] = static_cast<int>(TileGrid::TileValue::Empty);
+    };
+
+    std::mt19937 randomGenerator(seed);
+    std::vector<bool> visited(static_cast<std::size_t>(cellsPerRow) * cellRows, false);
+    std::vector<sf::Vector2i> stack {sf::Vector2i(0, 0)};
+    visited[0] = true;
+    openTiles(1, 1, 2, 2);
+    while (!stack.empty())
+    {
+        const sf::Vector2i cell = stack.back();
+        sf::Vector2i unvisited[4];
+        int unvisitedCount = 0;
+        for (sf::Vector2i offset : {sf::Vector2i(1, 0), sf::Vector2i(-1, 0), sf::Vector2i(0, 1), sf::Vector2i(0, -1)})
+        {
+            const sf::Vector2i next = cell + offset;
+            if (next.x >= 0 && next.y >= 0 && next.x < cellsPerRow && next.y < cellRows && !visited[next.x + next.y * cellsPerRow])
+                unvisited[unvisitedCount++] = next;
+        }
+
+        if (unvisitedCount == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        const sf::Vector2i next = unvisited[randomGenerator() % unvisitedCount];
+        visited[next.x + next.y * cellsPerRow] = true;
+        openTiles(next.x * 3 + 1, next.y * 3 + 1, 2, 2);
+        if (next.x != cell.x)
+            openTiles(std::max(next.x, cell.x) * 3, next.y * 3 + 1, 1, 2);
+        else
+            openTiles(next.x * 3 + 1, std::max(next.y, cell.y) * 3, 2, 1);
+        stack.push_back(next);
+    }
+
+    level.startPosition = sf::Vector2i(1, 1);
+    level.startLength = 2;
+    return level;
+}
+
+std::vector<int> buildGridDataWithSnake(const LevelData& level)
+{
+    std::vector<int> gridData = level.gridData;
+    for (std::size_t i = 0; i < level.startBody.size(); ++i)
+    {
+        const sf::Vector2i position = level.startBody[i];
+        gridData[position.x + position.y * level.width] = static_cast<int>(i == 0 ? TileGrid::TileValue::SnakeHead : TileGrid::TileValue::SnakeBody);
+    }
+    return gridData;
+}
@@ -0,0 +1,36 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/TileGrid.hpp"
+#include <array>
+#include <iostream>
+#include <random>
+#include <utility>
+
+void runFoodSpawnBenchmarks()
+{
+    const std::array<std::pair<int, int>, 4> gridSizes {{{40, 30}, {256, 256}, {1024, 1024}, {4096, 4096}}};
+
+    std::cout << "Food spawn, pick a random empty tile and place food on it" << std::endl;
+
+    for (const auto& size : gridSizes)
+    {
+        TileGrid grid;
+        if (!grid.loadFromArray(buildOpenLevel(size.first, size.second).gridData, size.first, size.second))
+            continue;
+
+        std::default_random_engine randomGenerator;
+        std::string name = "FoodSpawn/" + std::to_string(size.first) + "x" + std::to_string(size.second);
+        BenchmarkResult result = runBenchmark(name, 1000000, [&grid, &randomGenerator]()
+        {
+            std::uniform_int_distribution<std::size_t> distribution(0, grid.getEmptyTileCount() - 1);
+            sf::Vector2i chosenTile = grid.getEmptyTile(distribution(randomGenerator));
+            grid.updateTile(chosenTile, TileGrid::TileValue::Food);
+
+            // Eat it right away so the amount of empty tiles stays the same
+            grid.updateTile(chosenTile, TileGrid::TileValue::Empty);
+            grid.clearChangedTiles();
+        });
+
+        printBenchmarkResult(result);
+    }
+}
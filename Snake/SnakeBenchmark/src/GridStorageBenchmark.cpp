@@ -0,0 +1,82 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/TileGrid.hpp"
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <utility>
+
+void runGridStorageBenchmarks()
+{
+    const std::array<std::pair<int, int>, 3> gridSizes {{{40, 30}, {1024, 1024}, {8192, 8192}}};
+
+    std::cout << "Grid storage, memory and whole grid queries" << std::endl;
+
+    for (const auto& size : gridSizes)
+    {
+        const int width = size.first;
+        const int height = size.second;
+        const std::size_t tileCount = static_cast<std::size_t>(width) * height;
+        const std::string suffix = "/" + std::to_string(width) + "x" + std::to_string(height);
+
+        TileGrid grid;
+        if (!grid.loadFromArray(buildMixedGrid(width, height), width, height))
+            continue;
+
+        // The previous layout stored an int per tile in a vector sized width * height * 4
+        std::size_t previousBytes = tileCount * 4 * sizeof(int);
+        std::size_t withoutBitPlanes = grid.getMemoryUsage();
+        grid.setBitPlanesEnabled(true);
+        std::size_t withBitPlanes = grid.getMemoryUsage();
+
+        std::cout << "memory " << width << "x" << height << ": tiles " << tileCount * sizeof(TileGrid::TileValue) / 1024
+            << " KiB (previously " << previousBytes / 1024 << " KiB), with empty tile index " << withoutBitPlanes / 1024
+            << " KiB, with bit planes " << withBitPlanes / 1024 << " KiB" << std::endl;
+
+        // Keep the whole run in the same time range for all sizes
+        const long long iterations = std::max<long long>(1, 200000000 / static_cast<long long>(tileCount));
+        std::size_t sink = 0;
+
+        printBenchmarkResult(runBenchmark("GridStorage/countFreeTiles/lookup" + suffix, iterations, [&grid, &sink]()
+        {
+            TileGrid::TileValue value;
+            for (int y = 0; y < grid.getHeight(); ++y)
+                for (int x = 0; x < grid.getWidth(); ++x)
+                    if (grid.getTileValueAt(x, y, &value) && value == TileGrid::TileValue::Empty)
+                        ++sink;
+        }));
+
+        printBenchmarkResult(runBenchmark("GridStorage/countFreeTiles/popcount" + suffix, iterations, [&grid, &sink]()
+        {
+            sink += grid.countTiles(TileGrid::BitPlane::Free);
+        }));
+
+        std::vector<std::uint8_t> byteMask(tileCount);
+        printBenchmarkResult(runBenchmark("GridStorage/collisionMask/lookup" + suffix, iterations, [&grid, &byteMask]()
+        {
+            TileGrid::TileValue value;
+            for (int y = 0; y < grid.getHeight(); ++y)
+                for (int x = 0; x < grid.getWidth(); ++x)
+                {
+                    grid.getTileValueAt(x, y, &value);
+                    byteMask[x + y * grid.getWidth()] = value == TileGrid::TileValue::Wall
+                        || value == TileGrid::TileValue::NoPlayArea || value == TileGrid::TileValue::SnakeBody
+                        || value == TileGrid::TileValue::SnakeHead;
+                }
+        }));
+
+        std::vector<std::uint64_t> wordMask;
+        printBenchmarkResult(runBenchmark("GridStorage/collisionMask/bitPlanes" + suffix, iterations, [&grid, &wordMask]()
+        {
+            grid.getCollisionMask(&wordMask);
+        }));
+
+        printBenchmarkResult(runBenchmark("GridStorage/blockedNeighbourMask/bitPlanes" + suffix, iterations, [&grid, &wordMask]()
+        {
+            grid.getBlockedNeighbourMask(&wordMask);
+        }));
+
+        if (sink == 0 && isBenchmarkEnabled("GridStorage/countFreeTiles/lookup" + suffix))
+            std::cerr << "runGridStorageBenchmarks(): no free tiles counted!" << std::endl;
+    }
+}
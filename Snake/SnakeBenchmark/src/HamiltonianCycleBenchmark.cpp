@@ -0,0 +1,46 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/HamiltonianCycle.hpp"
+#include <cstdio>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+void runHamiltonianCycleBenchmarks()
+{
+    std::vector<std::pair<std::string, LevelData>> levels;
+    for (int i = 0; i < BUILTIN_LEVEL_COUNT; ++i)
+        levels.emplace_back("level:" + std::to_string(i + 1), buildBuiltinLevel(i));
+    for (unsigned int seed = 1; seed <= 3; ++seed)
+        levels.emplace_back("maze:256x256/seed:" + std::to_string(seed), buildMazeLevel(256, 256, seed));
+
+    std::cout << "HamiltonianCycle solving and loading the cached cycle" << std::endl;
+
+    const std::string cachePath = "benchmark.cycle";
+    for (const auto& namedLevel : levels)
+    {
+        HamiltonianCycle cycle;
+        BenchmarkResult result = runBenchmark("HamiltonianCycle::solve/" + namedLevel.first, [&]()
+        {
+            cycle.solve(namedLevel.second);
+        });
+        printBenchmarkResult(result);
+        if (result.iterations > 0)
+            std::cout << "    cycle over " << cycle.getLength() << " of " << cycle.getPlayableTileCount() << " tiles" << std::endl;
+
+        if (!isBenchmarkEnabled("HamiltonianCycle::loadFromFile/" + namedLevel.first))
+            continue;
+        if (!cycle.solve(namedLevel.second) || !cycle.saveToFile(cachePath))
+        {
+            std::cerr << "runHamiltonianCycleBenchmarks(): no cycle to cache for " << namedLevel.first << "!" << std::endl;
+            continue;
+        }
+
+        printBenchmarkResult(runBenchmark("HamiltonianCycle::loadFromFile/" + namedLevel.first, [&]()
+        {
+            cycle.loadFromFile(cachePath, namedLevel.second);
+        }));
+    }
+
+    std::remove(cachePath.c_str());
+}
@@ -0,0 +1,92 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/Levels.hpp"
+#include "simulation/Rollback.hpp"
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    const int ROLLBACK_TICKS = 8;
+
+    struct RollbackSetup
+    {
+        std::string name;
+        LevelData level;
+        int aiSnakeCount;
+    };
+}
+
+void runRollbackBenchmarks()
+{
+    std::vector<RollbackSetup> setups;
+    setups.push_back(RollbackSetup {"level1", buildBuiltinLevel(0), 0});
+    setups.push_back(RollbackSetup {"open:64x64", buildOpenLevel(64, 64), 30});
+    setups.push_back(RollbackSetup {"open:256x256", buildOpenLevel(256, 256), 200});
+    setups.push_back(RollbackSetup {"open:1024x1024", buildOpenLevel(1024, 1024), 2000});
+
+    std::cout << "Rollback with 2 players, the second player's inputs arrive " << ROLLBACK_TICKS
+        << " ticks late and are never predicted right" << std::endl;
+
+    for (const RollbackSetup& setup : setups)
+    {
+        const std::string name = setup.name + "/snakes:" + std::to_string(2 + setup.aiSnakeCount);
+
+        RollbackSession session;
+        if (!session.start(setup.level, 2, setup.aiSnakeCount, 42, ROLLBACK_TICKS))
+            continue;
+
+        // What a snapshot costs compared to copying the whole arena
+        SnakeArena::Snapshot snapshot;
+        printBenchmarkResult(runBenchmark("SnakeArena::saveSnapshot/" + name, [&]()
+        {
+            session.getArena().saveSnapshot(&snapshot);
+        }));
+
+        SnakeArena arenaCopy = session.getArena();
+        printBenchmarkResult(runBenchmark("SnakeArena copy/" + name, [&]()
+        {
+            arenaCopy = session.getArena();
+        }));
+
+        // Both players' inputs on time, every tick is simulated once
+        int direction = 0;
+        BenchmarkResult onTime = runBenchmark("RollbackSession::advance no rollback/" + name, [&]()
+        {
+            const int tick = session.getTick();
+            session.addInput(0, tick, Simulation::PlayerInput::Up);
+            session.addInput(1, tick, static_cast<Simulation::PlayerInput>(direction));
+            direction = (direction + 1) % 4;
+            session.advance();
+        });
+        printBenchmarkResult(onTime);
+
+        // Every tick the second player's input for ROLLBACK_TICKS ago arrives and differs from the prediction,
+        // so every tick restores the snapshot from back then and simulates ROLLBACK_TICKS + 1 ticks
+        RollbackSession lateSession;
+        lateSession.start(setup.level, 2, setup.aiSnakeCount, 42, ROLLBACK_TICKS);
+        for (int tick = 0; tick < ROLLBACK_TICKS; ++tick)
+        {
+            lateSession.addInput(0, tick, Simulation::PlayerInput::Up);
+            lateSession.advance();
+        }
+
+        BenchmarkResult late = runBenchmark("RollbackSession::advance " + std::to_string(ROLLBACK_TICKS) + " tick rollback/" + name, [&]()
+        {
+            const int tick = lateSession.getTick();
+            lateSession.addInput(0, tick, Simulation::PlayerInput::Up);
+            lateSession.addInput(1, tick - ROLLBACK_TICKS, static_cast<Simulation::PlayerInput>(direction));
+            direction = (direction + 1) % 4;
+            lateSession.advance();
+        });
+        printBenchmarkResult(late);
+
+        if (onTime.iterations > 0 && late.iterations > 0)
+        {
+            const double resimulatedTicks = static_cast<double>(lateSession.getResimulatedTickCount()) / lateSession.getRollbackCount();
+            std::cout << "    " << resimulatedTicks << " ticks simulated again per rollback, "
+                << (late.nanosecondsPerIteration - onTime.nanosecondsPerIteration) / resimulatedTicks
+                << " ns per tick simulated again with its share of the restore" << std::endl;
+        }
+    }
+}
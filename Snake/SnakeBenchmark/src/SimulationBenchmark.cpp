@@ -0,0 +1,58 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include <array>
+#include <iostream>
+#include <utility>
+
+void runSimulationBenchmarks()
+{
+    // 32x24 and 40x30 are the sizes of the shipped levels
+    const std::array<std::pair<int, int>, 5> sizes {{{32, 24}, {40, 30}, {256, 256}, {1024, 1024}, {4096, 4096}}};
+    const std::array<double, 3> snakeFills {0.1, 0.5, 0.9};
+
+    std::cout << "Simulation::step with the snake following a path through the whole level" << std::endl;
+
+    for (const auto& size : sizes)
+    {
+        for (double snakeFill : snakeFills)
+        {
+            // Without food only the movement is measured
+            CycleLevel cycleLevel = buildCycleLevel(size.first, size.second, snakeFill, 0);
+            Simulation simulation;
+            simulation.seed(42);
+            if (!simulation.loadLevel(cycleLevel.level))
+                continue;
+
+            printBenchmarkResult(runBenchmark("Simulation::step/move/" + cycleLevel.name, [&]()
+            {
+                const sf::Vector2i head = simulation.getSnake().getHead();
+                simulation.step(cycleLevel.nextInput[head.x + head.y * cycleLevel.level.width]);
+            }));
+
+            if (simulation.isSnakeDead())
+                std::cerr << "runSimulationBenchmarks(): snake died on " << cycleLevel.name << "!" << std::endl;
+
+            // With the food limit of the shipped levels: spawning, eating and growing.
+            // A snake that grew into its own tail starts over, the reload is part of the measurement
+            cycleLevel.level.maxFood = 20;
+            if (!simulation.loadLevel(cycleLevel.level))
+                continue;
+
+            long long restarts = 0;
+            BenchmarkResult result = runBenchmark("Simulation::step/food/" + cycleLevel.name, [&]()
+            {
+                const sf::Vector2i head = simulation.getSnake().getHead();
+                simulation.step(cycleLevel.nextInput[head.x + head.y * cycleLevel.level.width]);
+                if (simulation.isSnakeDead())
+                {
+                    simulation.loadLevel(cycleLevel.level);
+                    ++restarts;
+                }
+            });
+            printBenchmarkResult(result);
+
+            if (restarts > 0 && result.iterations > 0)
+                std::cout << "    " << restarts << " restarts, one every " << result.iterations / restarts << " ticks" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/SnakeArena.hpp"
+#include <array>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+void runSnakeArenaBenchmarks()
+{
+    const std::array<std::pair<int, int>, 5> setups {{{64, 16}, {256, 100}, {256, 1000}, {1024, 1000}, {1024, 10000}}};
+
+    std::cout << "SnakeArena::step with every snake wandering and dead snakes respawning right away" << std::endl;
+
+    for (const auto& setup : setups)
+    {
+        const int size = setup.first;
+        const int snakeCount = setup.second;
+        const std::string name = "open:" + std::to_string(size) + "x" + std::to_string(size) + "/snakes:" + std::to_string(snakeCount);
+
+        SnakeArena arena;
+        arena.seed(42);
+        if (!arena.loadLevel(buildOpenLevel(size, size), snakeCount))
+            continue;
+
+        std::vector<SnakeArena::PlayerInput> inputs(snakeCount);
+        std::mt19937 randomGenerator(42);
+        long long deaths = 0;
+
+        // Choosing the inputs is measured on its own, it is about as expensive as the step itself
+        printBenchmarkResult(runBenchmark("SnakeArena::getWanderInput/" + name, [&]()
+        {
+            for (int i = 0; i < snakeCount; ++i)
+                inputs[i] = arena.getWanderInput(i, randomGenerator());
+        }));
+
+        BenchmarkResult result = runBenchmark("SnakeArena::step/" + name, [&]()
+        {
+            arena.step(inputs.data());
+            for (int i = 0; i < snakeCount; ++i)
+            {
+                inputs[i] = arena.getWanderInput(i, randomGenerator());
+                if (!arena.isSnakeAlive(i))
+                {
+                    arena.respawnSnake(i);
+                    ++deaths;
+                }
+            }
+        });
+        printBenchmarkResult(result);
+        if (result.iterations > 0)
+        {
+            std::cout << "    " << result.nanosecondsPerIteration / snakeCount << " ns per snake, "
+                << static_cast<double>(deaths) / result.iterations << " deaths per tick" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/Simulation.hpp"
+#include <array>
+#include <iostream>
+
+void runSnakeMovementBenchmarks()
+{
+    const int ticks = 200000;
+    const std::array<int, 5> snakeLengths {3, 1000, 10000, 100000, 1000000};
+
+    std::cout << "Snake movement, cost per tick by snake length" << std::endl;
+
+    for (int snakeLength : snakeLengths)
+    {
+        Simulation simulation;
+        if (!simulation.loadLevel(buildCorridorLevel(snakeLength, ticks)))
+            continue;
+
+        BenchmarkResult result = runBenchmark("Simulation::step/corridor/length:" + std::to_string(snakeLength), ticks, [&simulation]()
+        {
+            simulation.step(Simulation::PlayerInput::Up);
+        });
+
+        if (simulation.isSnakeDead())
+            std::cerr << "runSnakeMovementBenchmarks(): snake died during the benchmark!" << std::endl;
+
+        printBenchmarkResult(result);
+    }
+}
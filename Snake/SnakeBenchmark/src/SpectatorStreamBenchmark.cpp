@@ -0,0 +1,79 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/SnakeArena.hpp"
+#include "simulation/SpectatorStream.hpp"
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const int SNAKE_COUNT = 32;
+    const int MEASURED_TICKS = 1000;
+}
+
+void runSpectatorStreamBenchmarks()
+{
+    const std::array<int, 4> sizes {{64, 256, 1024, 4096}};
+
+    std::cout << "Spectator stream of " << SNAKE_COUNT << " wandering snakes, the same activity on ever larger levels" << std::endl;
+
+    for (int size : sizes)
+    {
+        const std::string name = "open:" + std::to_string(size) + "x" + std::to_string(size) + "/snakes:" + std::to_string(SNAKE_COUNT);
+        const LevelData level = buildOpenLevel(size, size);
+
+        SnakeArena arena;
+        arena.seed(42);
+        if (!arena.loadLevel(level, SNAKE_COUNT))
+            continue;
+
+        std::vector<SnakeArena::PlayerInput> inputs(SNAKE_COUNT);
+        std::mt19937 randomGenerator(42);
+        auto step = [&]()
+        {
+            for (int i = 0; i < SNAKE_COUNT; ++i)
+                inputs[i] = arena.getWanderInput(i, randomGenerator());
+            arena.step(inputs.data());
+            for (int i = 0; i < SNAKE_COUNT; ++i)
+            {
+                if (!arena.isSnakeAlive(i))
+                    arena.respawnSnake(i);
+            }
+        };
+
+        SpectatorEncoder encoder;
+        std::vector<std::uint8_t> keyframe;
+        printBenchmarkResult(runBenchmark("SpectatorEncoder::encodeKeyframe/" + name, [&]()
+        {
+            encoder.encodeKeyframe(arena.getGrid(), level.tileSize, 0, 0, &keyframe);
+        }));
+
+        // What a viewer receives per tick, averaged over many ticks
+        std::vector<std::uint8_t> delta;
+        long long deltaBytes = 0;
+        for (int tick = 0; tick < MEASURED_TICKS; ++tick)
+        {
+            step();
+            encoder.encodeDelta(arena.getGrid(), static_cast<std::uint32_t>(tick), 0, &delta);
+            deltaBytes += static_cast<long long>(delta.size());
+        }
+
+        // The changed tiles of the last tick stay until the next step, so they can be encoded again and again
+        printBenchmarkResult(runBenchmark("SpectatorEncoder::encodeDelta/" + name, [&]()
+        {
+            encoder.encodeDelta(arena.getGrid(), 0, 0, &delta);
+        }));
+
+        SpectatorDecoder decoder;
+        decoder.apply(keyframe);
+        printBenchmarkResult(runBenchmark("SpectatorDecoder::apply delta/" + name, [&]()
+        {
+            decoder.apply(delta);
+        }));
+
+        std::cout << "    keyframe " << keyframe.size() << " bytes, delta " << static_cast<double>(deltaBytes) / MEASURED_TICKS
+            << " bytes per tick, " << level.gridData.size() << " bytes per tick if the whole grid was sent" << std::endl;
+    }
+}
@@ -0,0 +1,117 @@
+#include "Benchmark.hpp"
+#include "BenchmarkLevels.hpp"
+#include "simulation/TileGrid.hpp"
+#include <array>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    struct GridCase
+    {
+        std::string name;
+        std::vector<int> gridData;
+        int width;
+        int height;
+    };
+
+    void runTileGridKernels(const GridCase& gridCase)
+    {
+        TileGrid grid;
+        if (!grid.loadFromArray(gridCase.gridData, gridCase.width, gridCase.height))
+            return;
+
+        // Fixed random positions, the same for every run
+        const std::size_t positionMask = 4095;
+        std::vector<sf::Vector2i> positions(positionMask + 1);
+        std::vector<TileGrid::TileValue> originalValues(positions.size());
+        std::mt19937 randomGenerator(42);
+        for (std::size_t i = 0; i < positions.size(); ++i)
+        {
+            positions[i] = sf::Vector2i(randomGenerator() % gridCase.width, randomGenerator() % gridCase.height);
+            grid.getTileValueAt(positions[i], &originalValues[i]);
+        }
+
+        std::size_t next = 0;
+        std::size_t sink = 0;
+
+        printBenchmarkResult(runBenchmark("TileGrid::loadFromArray/" + gridCase.name, [&]()
+        {
+            sink += grid.loadFromArray(gridCase.gridData, gridCase.width, gridCase.height);
+        }));
+
+        printBenchmarkResult(runBenchmark("TileGrid::updateTile/" + gridCase.name, [&]()
+        {
+            // Place food and restore the tile, like a spawn followed by eating it
+            const std::size_t i = next++ & positionMask;
+            grid.updateTile(positions[i], TileGrid::TileValue::Food);
+            grid.updateTile(positions[i], originalValues[i]);
+            grid.clearChangedTiles();
+        }));
+
+        printBenchmarkResult(runBenchmark("TileGrid::getTileValueAt/" + gridCase.name, [&]()
+        {
+            TileGrid::TileValue value;
+            if (grid.getTileValueAt(positions[next++ & positionMask], &value))
+                sink += static_cast<std::size_t>(value);
+        }));
+
+        // getListOfEmptyTiles() appends, the vector keeps its capacity between the calls
+        std::vector<sf::Vector2i> emptyTiles;
+        printBenchmarkResult(runBenchmark("TileGrid::getListOfEmptyTiles/" + gridCase.name, [&]()
+        {
+            emptyTiles.clear();
+            grid.getListOfEmptyTiles(&emptyTiles);
+            sink += emptyTiles.size();
+        }));
+
+        // Only grids with a teleporter pair
+        sf::Vector2i teleporter(-1, -1);
+        for (int i = 0; i < gridCase.width * gridCase.height && teleporter.x < 0; ++i)
+        {
+            if (gridCase.gridData[i] == static_cast<int>(TileGrid::TileValue::Teleport1))
+                teleporter = sf::Vector2i(i % gridCase.width, i / gridCase.width);
+        }
+        if (teleporter.x >= 0)
+        {
+            printBenchmarkResult(runBenchmark("TileGrid::getPositionOfOtherTeleporter1/" + gridCase.name, [&]()
+            {
+                auto otherTeleporter = grid.getPositionOfOtherTeleporter1(teleporter);
+                if (otherTeleporter)
+                    sink += otherTeleporter->x;
+            }));
+        }
+
+        if (sink == 0 && isBenchmarkEnabled("TileGrid::getTileValueAt/" + gridCase.name))
+            std::cerr << "runTileGridBenchmarks(): nothing was measured for " << gridCase.name << "!" << std::endl;
+    }
+}
+
+void runTileGridBenchmarks()
+{
+    std::cout << "TileGrid kernels on the shipped levels and synthetic grids" << std::endl;
+
+    const std::array<const char*, BUILTIN_LEVEL_COUNT> levelNames {"level1_32x24", "level2_40x30", "level3_40x30"};
+    for (int i = 0; i < BUILTIN_LEVEL_COUNT; ++i)
+    {
+        LevelData level = buildBuiltinLevel(i);
+        runTileGridKernels(GridCase {levelNames[i], level.gridData, level.width, level.height});
+    }
+
+    const std::array<int, 3> sizes {256, 1024, 4096};
+    const std::array<double, 3> snakeFills {0.1, 0.5, 0.9};
+    for (int size : sizes)
+    {
+        for (double snakeFill : snakeFills)
+        {
+            CycleLevel cycleLevel = buildCycleLevel(size, size, snakeFill, 0);
+            GridCase gridCase {cycleLevel.name, buildGridDataWithSnake(cycleLevel.level), size, size};
+
+            // A teleporter pair in the side walls
+            gridCase.gridData[(size / 2) * size] = static_cast<int>(TileGrid::TileValue::Teleport1);
+            gridCase.gridData[(size / 2) * size + size - 1] = static_cast<int>(TileGrid::TileValue::Teleport1);
+
+            runTileGridKernels(gridCase);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#include "Benchmark.hpp"
+#include "simulation/VectorEnvironment.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+void runVectorEnvironmentBenchmarks()
+{
+    const int gameCount = 1024;
+    // Steps per thread start, keeps the cost of starting the threads out of the measurement
+    const int stepsPerRound = 64;
+    const int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    // Random actions, games end within a few dozen ticks so restarts are part of the measurement
+    std::vector<std::vector<std::uint8_t>> actions(stepsPerRound, std::vector<std::uint8_t>(gameCount));
+    std::mt19937 randomGenerator(42);
+    for (auto& stepActions : actions)
+        for (auto& action : stepActions)
+            action = static_cast<std::uint8_t>(randomGenerator() % 4);
+
+    std::cout << "VectorEnvironment::step over " << gameCount << " games with random actions" << std::endl;
+
+    for (int levelIndex = 0; levelIndex < BUILTIN_LEVEL_COUNT; ++levelIndex)
+    {
+        const std::string levelName = "level:" + std::to_string(levelIndex + 1);
+        VectorEnvironment environment;
+        if (!environment.create(buildBuiltinLevel(levelIndex), gameCount, 42, 10000))
+            continue;
+
+        std::vector<std::uint8_t> observations(environment.getObservationSize() * gameCount);
+        std::vector<float> rewards(gameCount);
+        std::vector<std::uint8_t> dones(gameCount);
+        environment.setBuffers(observations.data(), rewards.data(), dones.data());
+        environment.reset();
+
+        long long episodes = 0;
+        int step = 0;
+        BenchmarkResult result = runBenchmark("VectorEnvironment::step/" + levelName + "/games:" + std::to_string(gameCount), [&]()
+        {
+            environment.step(actions[step].data());
+            step = (step + 1) % stepsPerRound;
+            episodes += std::count(dones.begin(), dones.end(), 1);
+        });
+        printBenchmarkResult(result);
+        if (result.iterations > 0)
+        {
+            std::cout << "    " << gameCount * 1e3 / result.nanosecondsPerIteration << " million env-steps per second, "
+                << episodes * 1e3 / (result.iterations * result.nanosecondsPerIteration) << " million episodes per second" << std::endl;
+        }
+
+        // Every thread steps its own range of games, games never share state so no locking is needed
+        result = runBenchmark("VectorEnvironment::stepRange/" + levelName + "/games:" + std::to_string(gameCount)
+            + "/threads:" + std::to_string(threadCount), [&]()
+        {
+            std::vector<std::thread> threads;
+            for (int i = 0; i < threadCount; ++i)
+            {
+                threads.emplace_back([&, i]()
+                {
+                    const int begin = gameCount * i / threadCount;
+                    const int end = gameCount * (i + 1) / threadCount;
+                    for (int j = 0; j < stepsPerRound; ++j)
+                        environment.stepRange(actions[j].data(), begin, end);
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+        });
+        printBenchmarkResult(result);
+        if (result.iterations > 0)
+            std::cout << "    " << gameCount * stepsPerRound * 1e3 / result.nanosecondsPerIteration << " million env-steps per second" << std::endl;
+    }
+}
@@ -0,0 +1,40 @@
+#include "Benchmark.hpp"
+#include <iostream>
+#include <string>
+
+// Usage: SnakeBenchmark [--filter <text>] [--min-time <seconds>] [--json <file>]
+int main(int argc, char* argv[])
+{
+    std::string jsonPath;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--filter")
+            setBenchmarkFilter(argv[i + 1]);
+        else if (argument == "--min-time")
+            setBenchmarkMinimumTime(std::stod(argv[i + 1]));
+        else if (argument == "--json")
+            jsonPath = argv[i + 1];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--filter <text>] [--min-time <seconds>] [--json <file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    runSnakeMovementBenchmarks();
+    runFoodSpawnBenchmarks();
+    runGridStorageBenchmarks();
+    runTileGridBenchmarks();
+    runSimulationBenchmarks();
+    runHamiltonianCycleBenchmarks();
+    runVectorEnvironmentBenchmarks();
+    runSnakeArenaBenchmarks();
+    runRollbackBenchmarks();
+    runSpectatorStreamBenchmarks();
+
+    if (!jsonPath.empty() && !writeBenchmarkJson(jsonPath))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "simulation/LevelPack.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Packs the builtin levels into a level pack and checks that every level decodes to the same data.
+// --open-level appends an empty level with walls around it, e.g. to try very large maps.
+// Usage: SnakeLevelPacker [--open-level <width> <height>]... <output file>
+
+namespace
+{
+    LevelData buildOpenLevel(int width, int height)
+    {
+        LevelData level;
+        level.tileSize = sf::Vector2u(20, 20);
+        level.width = width;
+        level.height = height;
+        level.startPosition = sf::Vector2i(width / 2, height / 2);
+        level.gridData.assign(static_cast<std::size_t>(width) * height, 0);
+        for (int x = 0; x < width; ++x)
+        {
+            level.gridData[x] = 1;
+            level.gridData[static_cast<std::size_t>(height - 1) * width + x] = 1;
+        }
+        for (int y = 0; y < height; ++y)
+        {
+            level.gridData[static_cast<std::size_t>(y) * width] = 1;
+            level.gridData[static_cast<std::size_t>(y) * width + width - 1] = 1;
+        }
+        return level;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<LevelData> levels;
+    for (int i = 0; i < BUILTIN_LEVEL_COUNT; ++i)
+        levels.push_back(buildBuiltinLevel(i));
+
+    std::string outputPath;
+    bool isUsageError = false;
+    for (int i = 1; i < argc && !isUsageError; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--open-level" && i + 2 < argc)
+        {
+            const int width = std::stoi(argv[++i]);
+            const int height = std::stoi(argv[++i]);
+            if (width < 8 || height < 8 || width > 16384 || height > 16384)
+            {
+                cerr << "Open levels have to be between 8x8 and 16384x16384 tiles" << endl;
+                return 1;
+            }
+            levels.push_back(buildOpenLevel(width, height));
+        }
+        // Unknown options like --help are no file names, neither is a second output file
+        else if (argument.compare(0, 2, "--") != 0 && outputPath.empty())
+            outputPath = argument;
+        else
+            isUsageError = true;
+    }
+
+    if (isUsageError || outputPath.empty())
+    {
+        cerr << "Usage: " << argv[0] << " [--open-level <width> <height>]... <output file>" << endl;
+        return 1;
+    }
+
+    if (!saveLevelPack(levels, outputPath))
+        return 1;
+
+    LevelPack levelPack;
+    if (!levelPack.open(outputPath) || levelPack.getLevelCount() != static_cast<int>(levels.size()))
+    {
+        cerr << "Could not read back " << outputPath << "!" << endl;
+        return 1;
+    }
+
+    for (int i = 0; i < levelPack.getLevelCount(); ++i)
+    {
+        const LevelData& original = levels[i];
+        LevelData decoded;
+        if (!levelPack.loadLevel(i, &decoded)
+            || decoded.gridData != original.gridData || decoded.width != original.width || decoded.height != original.height
+            || decoded.tileSize != original.tileSize || decoded.startPosition != original.startPosition
+            || decoded.startLength != original.startLength || decoded.maxFood != original.maxFood)
+        {
+            cerr << "Level " << i + 1 << " does not match after decoding!" << endl;
+            return 1;
+        }
+
+        cout << "level " << i + 1 << ": " << original.width << "x" << original.height << ", "
+            << encodeLevel(original).size() << " bytes" << endl;
+    }
+
+    cout << "Packed " << levels.size() << " levels into " << outputPath << endl;
+    return 0;
+}
@@ -0,0 +1,384 @@
+#include "simulation/Levels.hpp"
+#include "simulation/Lockstep.hpp"
+#include "simulation/LoopbackNetwork.hpp"
+#include "simulation/UdpTransport.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Runs lockstep multiplayer games without a window. Every player is steered by SnakeArena::getWanderInput().
+// Usage: SnakeLockstep --loopback [--players N] [--ai-snakes N] [--level N] [--seed N] [--delay N] [--ticks N]
+//                      [--latency ms] [--jitter ms] [--loss percent]
+//        SnakeLockstep --server <port> [--players N] [--ai-snakes N] [--level N] [--seed N] [--delay N]
+//        SnakeLockstep --client <host> <port> [--ticks N]
+// --loopback runs the server and all clients in this process on a LoopbackNetwork with its own clock, so
+// a game of many minutes takes a moment and the clients' state hashes can be compared tick by tick.
+
+namespace
+{
+    const std::chrono::microseconds TICK_DURATION {250000}; // TIME_PER_SNAKE_MOVEMENT of the game
+    const std::chrono::microseconds LOOPBACK_TIME_STEP {1000};
+    const int SNAKE_RESPAWN_TICKS = 8;
+    const std::uint16_t LOOPBACK_SERVER_PORT = 5000;
+
+    struct Options
+    {
+        enum class Mode { None, Loopback, Server, Client };
+
+        Mode mode {Mode::None};
+        LockstepSettings settings;
+        int ticks {2000};
+        std::string host;
+        std::uint16_t port {0};
+        LoopbackNetwork::Conditions conditions;
+    };
+
+    // One client with its own copy of the game
+    class ClientGame
+    {
+    public:
+        explicit ClientGame(unsigned int inputSeed)
+            :m_inputRandomGenerator(inputSeed)
+        {
+        }
+
+        bool connect(std::unique_ptr<NetTransport> transport, const NetEndpoint& server)
+        {
+            m_transport = std::move(transport);
+            return m_client.connect(m_transport.get(), server);
+        }
+
+        // Steps the game when a tick is due and its inputs are there, false if the game could not be loaded
+        bool update(std::chrono::microseconds now)
+        {
+            m_client.update(now);
+            if (!m_client.isStarted())
+                return true;
+
+            if (!m_isLoaded)
+            {
+                const LockstepSettings& settings = m_client.getSettings();
+                if (settings.levelIndex >= BUILTIN_LEVEL_COUNT)
+                {
+                    cerr << "Level " << settings.levelIndex + 1 << " does not exist!" << endl;
+                    return false;
+                }
+
+                m_arena.seed(settings.seed);
+                if (!m_arena.loadLevel(buildBuiltinLevel(settings.levelIndex), settings.playerCount + settings.aiSnakeCount))
+                    return false;
+                // Every client draws the same numbers for the AI snakes
+                m_aiRandomGenerator.seed(settings.seed);
+                m_inputs.resize(m_arena.getSnakeCount());
+                m_respawnTicks.assign(m_arena.getSnakeCount(), 0);
+                m_isLoaded = true;
+            }
+
+            // The clock starts with the first tick, the time the first inputs take to arrive is no stall
+            if (!m_isTicking)
+            {
+                if (!m_client.hasTickInputs())
+                    return true;
+                m_nextTickTime = now;
+                m_isTicking = true;
+            }
+
+            if (now < m_nextTickTime || !m_client.hasTickInputs())
+                return true;
+
+            // A late tick delays all the following ones, like a slow frame in the game
+            const std::chrono::microseconds stallTime = now - m_nextTickTime;
+            m_totalStallTime += stallTime;
+            m_maxStallTime = std::max(m_maxStallTime, stallTime);
+            step(now);
+            m_nextTickTime = now + TICK_DURATION;
+            return true;
+        }
+
+        const LockstepClient& getClient() const { return m_client; }
+        const SnakeArena& getArena() const { return m_arena; }
+        const std::vector<std::uint64_t>& getStateHashes() const { return m_stateHashes; }
+        std::chrono::microseconds getMaxStallTime() const { return m_maxStallTime; }
+        std::chrono::microseconds getTotalStallTime() const { return m_totalStallTime; }
+
+    private:
+        void step(std::chrono::microseconds now)
+        {
+            const int playerIndex = m_client.getPlayerIndex();
+            const int playerCount = m_client.getSettings().playerCount;
+            m_client.advanceTick(m_arena.getWanderInput(playerIndex, m_inputRandomGenerator()), m_arena, m_inputs.data(), now);
+
+            for (int i = playerCount; i < m_arena.getSnakeCount(); ++i)
+                m_inputs[i] = m_arena.getWanderInput(i, m_aiRandomGenerator());
+            m_arena.step(m_inputs.data());
+
+            // Respawns only depend on the shared game, so they happen on every client in the same tick
+            for (int i = 0; i < m_arena.getSnakeCount(); ++i)
+            {
+                if (m_arena.isSnakeAlive(i))
+                    continue;
+                if (++m_respawnTicks[i] >= SNAKE_RESPAWN_TICKS)
+                {
+                    m_respawnTicks[i] = 0;
+                    m_arena.respawnSnake(i);
+                }
+            }
+
+            m_stateHashes.push_back(m_arena.computeStateHash());
+        }
+
+        std::unique_ptr<NetTransport> m_transport;
+        LockstepClient m_client;
+        SnakeArena m_arena;
+        bool m_isLoaded {false};
+        bool m_isTicking {false};
+        std::vector<Simulation::PlayerInput> m_inputs;
+        std::vector<int> m_respawnTicks;
+        std::mt19937 m_inputRandomGenerator;
+        std::mt19937 m_aiRandomGenerator;
+        std::chrono::microseconds m_nextTickTime {0};
+        std::chrono::microseconds m_maxStallTime {0};
+        std::chrono::microseconds m_totalStallTime {0};
+        std::vector<std::uint64_t> m_stateHashes;
+    };
+
+    bool parseOptions(int argc, char* argv[], Options* options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            if (argument == "--loopback")
+            {
+                options->mode = Options::Mode::Loopback;
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            const std::string value = argv[++i];
+
+            if (argument == "--server")
+            {
+                options->mode = Options::Mode::Server;
+                options->port = static_cast<std::uint16_t>(std::stoi(value));
+            }
+            else if (argument == "--client" && i + 1 < argc)
+            {
+                options->mode = Options::Mode::Client;
+                options->host = value;
+                options->port = static_cast<std::uint16_t>(std::stoi(argv[++i]));
+            }
+            else if (argument == "--players")
+                options->settings.playerCount = std::stoi(value);
+            else if (argument == "--ai-snakes")
+                options->settings.aiSnakeCount = std::stoi(value);
+            else if (argument == "--level")
+                options->settings.levelIndex = std::stoi(value) - 1;
+            else if (argument == "--seed")
+                options->settings.seed = static_cast<unsigned int>(std::stoul(value));
+            else if (argument == "--delay")
+                options->settings.inputDelay = std::stoi(value);
+            else if (argument == "--ticks")
+                options->ticks = std::stoi(value);
+            else if (argument == "--latency")
+                options->conditions.latency = std::chrono::microseconds(static_cast<long long>(std::stod(value) * 1000.0));
+            else if (argument == "--jitter")
+                options->conditions.jitter = std::chrono::microseconds(static_cast<long long>(std::stod(value) * 1000.0));
+            else if (argument == "--loss")
+                options->conditions.lossRate = std::stod(value) / 100.0;
+            else
+                return false;
+        }
+
+        const LockstepSettings& settings = options->settings;
+        return options->mode != Options::Mode::None && settings.playerCount >= 1 && settings.aiSnakeCount >= 0
+            && settings.levelIndex >= 0 && settings.levelIndex < BUILTIN_LEVEL_COUNT && settings.inputDelay >= 1 && options->ticks > 0;
+    }
+
+    int runLoopback(const Options& options)
+    {
+        LoopbackNetwork network(options.settings.seed);
+        network.setConditions(options.conditions);
+
+        std::unique_ptr<NetTransport> serverTransport = network.createEndpoint(LOOPBACK_SERVER_PORT);
+        LockstepServer server;
+        if (!server.start(serverTransport.get(), options.settings))
+            return 1;
+
+        std::vector<std::unique_ptr<ClientGame>> clients;
+        for (int i = 0; i < options.settings.playerCount; ++i)
+        {
+            clients.push_back(std::make_unique<ClientGame>(options.settings.seed + 1 + static_cast<unsigned int>(i)));
+            clients.back()->connect(network.createEndpoint(static_cast<std::uint16_t>(LOOPBACK_SERVER_PORT + 1 + i)), serverTransport->getLocalEndpoint());
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        std::chrono::microseconds now {0};
+        for (;;)
+        {
+            bool isDone = true;
+            for (const auto& client : clients)
+                isDone = isDone && static_cast<int>(client->getStateHashes().size()) >= options.ticks;
+            if (isDone)
+                break;
+
+            // Gives up if the game doesn't move for a minute of game time
+            if (now > TICK_DURATION * options.ticks + std::chrono::microseconds(60000000) * (1 + options.ticks / 240))
+            {
+                cerr << "The game got stuck at tick " << server.getTickCount() << endl;
+                return 1;
+            }
+
+            network.setTime(now);
+            server.update(now);
+            for (const auto& client : clients)
+            {
+                if (!client->update(now))
+                    return 1;
+            }
+            now += LOOPBACK_TIME_STEP;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        // All clients have to agree on every tick
+        int firstMismatch = -1;
+        const auto& referenceHashes = clients.front()->getStateHashes();
+        for (const auto& client : clients)
+        {
+            for (int tick = 0; tick < options.ticks; ++tick)
+            {
+                if (client->getStateHashes()[tick] != referenceHashes[tick] && (firstMismatch < 0 || tick < firstMismatch))
+                    firstMismatch = tick;
+            }
+        }
+
+        std::chrono::microseconds maxStallTime {0};
+        std::chrono::microseconds maxTotalStallTime {0};
+        for (const auto& client : clients)
+        {
+            maxStallTime = std::max(maxStallTime, client->getMaxStallTime());
+            maxTotalStallTime = std::max(maxTotalStallTime, client->getTotalStallTime());
+        }
+
+        const double gameSeconds = std::chrono::duration<double>(now).count();
+        cout << std::fixed << std::setprecision(2)
+            << options.settings.playerCount << " players, " << options.settings.aiSnakeCount << " AI snakes, "
+            << options.ticks << " ticks, latency " << options.conditions.latency.count() / 1000.0 << " ms, jitter "
+            << options.conditions.jitter.count() / 1000.0 << " ms, loss " << options.conditions.lossRate * 100.0 << " %" << endl
+            << "  game time    " << gameSeconds << " s (" << TICK_DURATION.count() / 1000 * options.ticks / 1000.0 << " s without stalls)" << endl
+            << "  stalls       " << maxTotalStallTime.count() / 1000.0 << " ms in total, longest " << maxStallTime.count() / 1000.0 << " ms" << endl
+            << "  datagrams    " << static_cast<double>(network.getSentDatagramCount()) / options.ticks << " per tick, "
+            << network.getLostDatagramCount() << " lost" << endl
+            << "  bytes        " << static_cast<double>(network.getSentByteCount()) / options.ticks << " per tick" << endl
+            << "  timed out    " << server.getTimedOutInputCount() << " inputs" << endl
+            << "  wall time    " << seconds << " s" << endl;
+
+        if (firstMismatch >= 0)
+        {
+            cout << "  DIVERGED at tick " << firstMismatch << endl;
+            return 1;
+        }
+        cout << "  all clients in sync, final state hash " << std::hex << referenceHashes.back() << std::dec << endl;
+        return 0;
+    }
+
+    std::chrono::microseconds getClockTime(std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+    }
+
+    int runServer(const Options& options)
+    {
+        UdpTransport transport;
+        LockstepServer server;
+        if (!transport.bind(options.port) || !server.start(&transport, options.settings))
+            return 1;
+
+        cout << "Waiting for " << options.settings.playerCount << " players on port " << options.port << endl;
+        const auto begin = std::chrono::steady_clock::now();
+        int joinedPlayerCount = 0;
+        int reportedTick = 0;
+        for (;;)
+        {
+            server.update(getClockTime(begin));
+
+            if (server.getJoinedPlayerCount() != joinedPlayerCount)
+            {
+                joinedPlayerCount = server.getJoinedPlayerCount();
+                cout << joinedPlayerCount << " of " << options.settings.playerCount << " players joined" << endl;
+            }
+            if (server.getTickCount() >= reportedTick + 100)
+            {
+                reportedTick = server.getTickCount() / 100 * 100;
+                cout << "tick " << reportedTick << ", " << server.getTimedOutInputCount() << " inputs timed out" << endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    int runClient(const Options& options)
+    {
+        const auto server = UdpTransport::resolve(options.host, options.port);
+        if (!server)
+        {
+            cerr << "Unknown host " << options.host << endl;
+            return 1;
+        }
+
+        auto transport = std::make_unique<UdpTransport>();
+        if (!transport->bind(0))
+            return 1;
+
+        ClientGame game(static_cast<unsigned int>(std::random_device()()));
+        game.connect(std::move(transport), *server);
+
+        const auto begin = std::chrono::steady_clock::now();
+        std::size_t reportedTickCount = 0;
+        while (static_cast<int>(game.getStateHashes().size()) < options.ticks)
+        {
+            if (!game.update(getClockTime(begin)))
+                return 1;
+
+            // Compare these lines between the clients to see that they are in sync
+            const auto& hashes = game.getStateHashes();
+            if (hashes.size() >= reportedTickCount + 100)
+            {
+                reportedTickCount = hashes.size() / 100 * 100;
+                cout << "player " << game.getClient().getPlayerIndex() + 1 << ", tick " << reportedTickCount << ", score "
+                    << game.getArena().getScore(game.getClient().getPlayerIndex()) << ", state hash " << std::hex
+                    << hashes[reportedTickCount - 1] << std::dec << endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, &options))
+    {
+        cerr << "Usage: " << argv[0] << " --loopback [--players N] [--ai-snakes N] [--level N] [--seed N] [--delay N] [--ticks N]" << endl
+            << "       [--latency ms] [--jitter ms] [--loss percent]" << endl
+            << "   or: " << argv[0] << " --server <port> [--players N] [--ai-snakes N] [--level N] [--seed N] [--delay N]" << endl
+            << "   or: " << argv[0] << " --client <host> <port> [--ticks N]" << endl;
+        return 1;
+    }
+
+    if (options.mode == Options::Mode::Loopback)
+        return runLoopback(options);
+    if (options.mode == Options::Mode::Server)
+        return runServer(options);
+    return runClient(options);
+}
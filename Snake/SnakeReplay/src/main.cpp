@@ -0,0 +1,89 @@
+#include "simulation/LevelPack.hpp"
+#include "simulation/Replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Re-simulates replays without a window as fast as possible and checks them against the recording.
+// Usage: SnakeReplay [--repeat N] [--levels <level pack>] <replay file>...
+// Without --levels the replays are played on the builtin levels.
+int main(int argc, char* argv[])
+{
+    int repeatCount = 1;
+    int replayCount = 0;
+    bool allMatched = true;
+    LevelPack levelPack;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--repeat" && i + 1 < argc)
+        {
+            repeatCount = std::max(1, std::stoi(argv[++i]));
+            continue;
+        }
+        if (argument == "--levels" && i + 1 < argc)
+        {
+            if (!levelPack.open(argv[++i]))
+                return 1;
+            continue;
+        }
+
+        Replay replay;
+        if (!loadReplay(argument, &replay))
+        {
+            allMatched = false;
+            continue;
+        }
+        ++replayCount;
+
+        LevelData level;
+        if (levelPack.isOpen() ? !levelPack.loadLevel(replay.levelIndex, &level)
+            : replay.levelIndex < 0 || replay.levelIndex >= BUILTIN_LEVEL_COUNT)
+        {
+            cerr << argument << ": level " << replay.levelIndex + 1 << " does not exist!" << endl;
+            allMatched = false;
+            continue;
+        }
+        if (!levelPack.isOpen())
+            level = buildBuiltinLevel(replay.levelIndex);
+
+        ReplayPlayer player;
+        bool matched = true;
+        std::size_t ticks = 0;
+        const auto begin = std::chrono::steady_clock::now();
+
+        for (int repeat = 0; repeat < repeatCount; ++repeat)
+        {
+            player.start(replay, level);
+            while (!player.isFinished())
+                player.step();
+
+            ticks += player.getTick();
+            matched = matched && player.matchesRecording();
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        // At 4 ticks per second in the game, realtime factor = ticks per second / 4
+        const double ticksPerSecond = seconds > 0.0 ? ticks / seconds : 0.0;
+
+        cout << argument << ": level " << replay.levelIndex + 1 << ", " << replay.inputs.size() << " ticks, score "
+            << player.getSimulation().getScore() << " (recorded " << replay.finalScore << "), "
+            << (matched ? "matches" : "DIVERGED") << ", " << static_cast<long long>(ticksPerSecond) << " ticks/s" << endl;
+
+        allMatched = allMatched && matched;
+    }
+
+    if (replayCount == 0)
+    {
+        cerr << "Usage: " << argv[0] << " [--repeat N] [--levels <level pack>] <replay file>..." << endl;
+        return 1;
+    }
+    return allMatched ? 0 : 2;
+}
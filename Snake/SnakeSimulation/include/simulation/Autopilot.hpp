@@ -0,0 +1,73 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include "simulation/Simulation.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Steers the snake along a shortest path to the nearest reachable food.
+// The breadth first search runs backwards from all food tiles at once and stores in every tile it reaches
+// the input that leads one step closer to food, so the result doesn't depend on where the head is and
+// stays usable while the snake moves. Walls, NoPlayArea and the snake are blocked, a teleporter is an
+// edge to the tile behind its partner.
+// The search runs in slices: think() works until its time budget is used up and continues where it
+// stopped on the next call, so on huge levels one search is spread over many frames and ticks.
+class Autopilot
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    void reset();
+
+    // Continues the search, call it once per frame
+    void think(const Simulation& simulation, std::chrono::microseconds budget);
+    // Input for the next step of the simulation, call it right before step().
+    // Until the search reached the head the snake keeps going or turns away from whatever would kill it.
+    PlayerInput getInput(const Simulation& simulation);
+
+    bool isSearching() const;
+    bool hasPathFromHead(const Simulation& simulation) const;
+    std::uint64_t getVisitedTileCount() const; // Over all searches since the last reset()
+
+private:
+    enum class Phase
+    {
+        Idle,       // No search yet or a restart is due
+        Clearing,   // Resetting the labels, only after a resize or when the search numbers ran out
+        Scanning,   // Collecting the food tiles as start of the search
+        Expanding,  // Breadth first search from the food tiles
+        Done        // Every reachable tile has its input
+    };
+
+    void startSearch(const Simulation& simulation);
+    void expandTile(const TileGrid& grid, int tile, int headTile);
+    bool getNextTile(const TileGrid& grid, int tile, PlayerInput input, int* nextTile) const;
+    bool isSearchedThisFar() const; // Labels of the current search can be read
+    bool isLabeled(int tile) const;
+    void label(int tile, PlayerInput input);
+    PlayerInput getLabel(int tile) const;
+    PlayerInput getSafeInput(const Simulation& simulation) const;
+
+    static bool isBlocked(TileGrid::TileValue value);
+
+    Phase m_phase {Phase::Idle};
+    int m_width {0};
+    int m_height {0};
+    int m_score {-1}; // Score the current search was started at, eating food restarts the search
+
+    // One byte per tile: the search number in the upper 6 bits and the input in the lower 2 bits.
+    // Tiles with an older search number count as not reached, so a new search doesn't clear anything.
+    // Allocated without initialization and cleared in slices, clearing a huge level at once would take too long
+    std::unique_ptr<std::uint8_t[]> m_labels;
+    std::uint8_t m_searchNumber {0};
+
+    int m_scanTile {0}; // Also the next tile to clear while clearing
+    std::vector<int> m_queue;
+    std::size_t m_queueFront {0};
+
+    std::uint64_t m_visitedTileCount {0};
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef CYCLE_FOLLOWER_HPP
+#define CYCLE_FOLLOWER_HPP
+
+#include "simulation/HamiltonianCycle.hpp"
+
+// Steers the snake along a HamiltonianCycle, which keeps it alive until it fills the whole cycle.
+// While the snake is shorter than half the cycle it cuts ahead towards the next food on the cycle,
+// but only as far as the part of the cycle between the new head and the tail stays free for the
+// growth that is still to come.
+class CycleFollower
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    // The cycle has to belong to the level that is played and outlive the follower or the next reset()
+    void reset(const HamiltonianCycle* cycle);
+    PlayerInput getInput(const Simulation& simulation);
+
+private:
+    int getNextOrder(int order) const;
+    int getDistance(int fromOrder, int toOrder) const; // Steps along the cycle in the direction followed
+    PlayerInput getCycleInput(int order) const;
+    std::optional<PlayerInput> getShortcut(const Simulation& simulation, int headOrder) const;
+    PlayerInput getInputTowardsCycle(const Simulation& simulation) const;
+    bool isBodyAlongCycle(const SnakeBody& snake) const;
+
+    static bool isFree(const TileGrid& grid, sf::Vector2i position);
+
+    const HamiltonianCycle* m_cycle {nullptr};
+    bool m_isDirectionChosen {false};
+    bool m_isReversed {false}; // The snake's start position decides which way the cycle is followed
+    bool m_isBodyAlongCycle {false}; // Cutting ahead is only safe once the whole body lies on the cycle in order
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef HAMILTONIAN_CYCLE_HPP
+#define HAMILTONIAN_CYCLE_HPP
+
+#include "simulation/Simulation.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Closed path over the playable tiles of a level, a snake following it never runs into itself.
+// Walls, NoPlayArea and paired teleporters are not part of it, moving onto a teleporter leads to the tile
+// behind its partner like in the game. Levels with holes don't always have a cycle through every tile,
+// solve() then returns the longest cycle it finds and leaves the rest out.
+class HamiltonianCycle
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    // Greedy: starts with a 2x2 loop in the largest connected area and keeps replacing a step of
+    // the cycle by a detour over two free neighbouring tiles until no detour is left
+    bool solve(const LevelData& level);
+
+    // Cached cycles are kept in cacheDirectory, one file per level named after computeLevelHash()
+    bool loadOrSolve(const LevelData& level, const std::string& cacheDirectory);
+    bool loadFromFile(const std::string& path, const LevelData& level);
+    bool saveToFile(const std::string& path) const;
+
+    bool isEmpty() const;
+    int getLength() const;
+    int getPlayableTileCount() const; // Tiles a cycle could pass, getLength() is at most this
+    int getWidth() const;
+    std::optional<int> getOrder(sf::Vector2i position) const; // Position along the cycle, empty if not on it
+    sf::Vector2i getPosition(int order) const;
+    PlayerInput getInput(int order) const; // Leads from getPosition(order) to getPosition(order + 1)
+
+    // Tile the snake's head reaches from position with input, teleporters included. Empty outside of the grid
+    static std::optional<sf::Vector2i> getNeighbour(const TileGrid& grid, sf::Vector2i position, PlayerInput input);
+
+private:
+    bool buildFromInputs(const TileGrid& grid, int startTile, const std::vector<PlayerInput>& inputs);
+    static bool isPlayable(const TileGrid& grid, sf::Vector2i position);
+
+    std::uint64_t m_levelHash {0};
+    int m_width {0};
+    int m_height {0};
+    int m_playableTileCount {0};
+    std::vector<int> m_orderOfTile;  // Per tile, -1 if the tile is not on the cycle
+    std::vector<int> m_tiles;        // Per position along the cycle
+    std::vector<PlayerInput> m_inputs;
+};
+
+// FNV-1a over the size and the tiles of the level, identifies the level in the cycle cache
+std::uint64_t computeLevelHash(const LevelData& level);
+
+#endif
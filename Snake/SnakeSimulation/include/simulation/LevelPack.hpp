@@ -0,0 +1,47 @@
+#ifndef LEVEL_PACK_HPP
+#define LEVEL_PACK_HPP
+
+#include "simulation/Levels.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary level file holding any number of levels, all values little endian:
+//   "SNKL", version, 3 reserved bytes, uint32 level count,
+//   level index of uint32 offset and uint32 size per level, offsets from the start of the file,
+//   one record per level, see encodeLevel().
+// Opening a pack only reads the index, a level is decoded when it is loaded.
+class LevelPack
+{
+public:
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    int getLevelCount() const;
+    bool loadLevel(int levelIndex, LevelData* level);
+
+private:
+    struct IndexEntry
+    {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    std::ifstream m_file;
+    std::vector<IndexEntry> m_index;
+    std::vector<std::uint8_t> m_record; // Reused so loading a level doesn't reallocate
+};
+
+// Level record: uint16 width, height, tile width, tile height, start x, start y,
+// uint8 start length, uint8 tile encoding, uint16 max food,
+// uint8 teleporter count followed by uint8 tile value, uint16 x, uint16 y per teleporter tile,
+// then the tiles row by row with teleporters stored as empty tiles.
+// Tiles are either one byte each or runs of a tile byte and a varint length, whichever is smaller.
+std::vector<std::uint8_t> encodeLevel(const LevelData& level);
+bool decodeLevel(const std::uint8_t* data, std::size_t size, LevelData* level);
+
+bool saveLevelPack(const std::vector<LevelData>& levels, const std::string& path);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef LEVELS_HPP
+#define LEVELS_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+struct LevelData
+{
+    std::vector<int> gridData;
+    sf::Vector2u tileSize;
+    int width;
+    int height;
+    sf::Vector2i startPosition;
+    int startLength {3}; // Snake parts placed downwards from startPosition, including the head
+    std::vector<sf::Vector2i> startBody; // Head first, replaces startPosition and startLength when not empty
+    int maxFood {20};
+};
+
+const int BUILTIN_LEVEL_COUNT = 3;
+
+// Returns one of the levels shipped with the game, levelIndex has to be in [0, BUILTIN_LEVEL_COUNT)
+LevelData buildBuiltinLevel(int levelIndex);
+
+#endif
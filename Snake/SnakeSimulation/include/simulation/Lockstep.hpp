@@ -0,0 +1,115 @@
+#ifndef LOCKSTEP_HPP
+#define LOCKSTEP_HPP
+
+#include "simulation/NetTransport.hpp"
+#include "simulation/SnakeArena.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Lockstep multiplayer over datagrams. The server only relays inputs: it collects every player's
+// input for a tick, sends the inputs of all players for that tick in one datagram to everybody and
+// every client steps its own SnakeArena with them. Since the arena is deterministic all clients
+// stay in sync without ever sending game state.
+// Inputs are sampled inputDelay ticks ahead of the tick they are applied in, which hides the round
+// trip to the server. Lost datagrams are covered by sending everything that is not confirmed yet again.
+
+struct LockstepSettings
+{
+    int playerCount {2};
+    int aiSnakeCount {0}; // Snakes after the players, every client steers them with the same random numbers
+    int levelIndex {0};
+    unsigned int seed {0};
+    int inputDelay {2};
+    // A player whose input for a tick is missing this long after the first input for it arrived keeps going straight
+    std::chrono::microseconds inputTimeout {500000};
+};
+
+class LockstepServer
+{
+public:
+    bool start(NetTransport* transport, const LockstepSettings& settings);
+    // Receives and sends, has to be called often, every frame or every millisecond
+    void update(std::chrono::microseconds now);
+
+    bool isRunning() const; // All players joined
+    int getJoinedPlayerCount() const;
+    int getTickCount() const; // Ticks whose inputs were sent
+    long long getTimedOutInputCount() const;
+
+private:
+    struct Player
+    {
+        NetEndpoint endpoint;
+        int receivedTickCount {0}; // Ticks the player confirmed to have
+        bool hasSentInputs {false};
+        std::chrono::microseconds lastSendTime {0};
+    };
+
+    void receive(std::chrono::microseconds now);
+    void closeTicks(std::chrono::microseconds now);
+    void sendWelcome(int playerIndex);
+    void sendTicks(int playerIndex, std::chrono::microseconds now);
+    std::uint8_t& getInput(int tick, int playerIndex);
+
+    NetTransport* m_transport {nullptr};
+    LockstepSettings m_settings;
+    std::vector<Player> m_players;
+    bool m_isRunning {false};
+
+    // Inputs of all players per tick, from m_firstStoredTick on. Older ticks are dropped once every player has them
+    std::vector<std::uint8_t> m_inputs;
+    int m_firstStoredTick {0};
+    int m_tickCount {0};
+    bool m_isWaitingForInputs {false};
+    std::chrono::microseconds m_waitingSince {0};
+    long long m_timedOutInputCount {0};
+
+    std::vector<std::uint8_t> m_datagram;
+};
+
+class LockstepClient
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    bool connect(NetTransport* transport, const NetEndpoint& server);
+    // Receives and sends, has to be called often, every frame or every millisecond
+    void update(std::chrono::microseconds now);
+
+    bool isStarted() const;
+    // Only valid once started, the input timeout stays at its default
+    const LockstepSettings& getSettings() const;
+    int getPlayerIndex() const;
+
+    // Next tick to simulate, the game can only step once the inputs of all players for it have arrived
+    int getTick() const;
+    bool hasTickInputs() const;
+    // Writes the inputs of all players for getTick() to inputs, players without an input keep the direction
+    // they have in arena. localInput is sent as the input for getTick() + inputDelay
+    bool advanceTick(PlayerInput localInput, const SnakeArena& arena, PlayerInput* inputs, std::chrono::microseconds now);
+
+private:
+    void receive();
+    void sendInputs(std::chrono::microseconds now);
+
+    NetTransport* m_transport {nullptr};
+    NetEndpoint m_server;
+    bool m_isStarted {false};
+    LockstepSettings m_settings;
+    int m_playerIndex {-1};
+    std::chrono::microseconds m_lastSendTime {0};
+    bool m_hasSent {false};
+
+    // Inputs of all players per tick, from m_tick on. Only the first m_receivedTickCount - m_tick ticks are complete
+    std::vector<std::uint8_t> m_tickInputs;
+    int m_tick {0};
+    int m_receivedTickCount {0};
+    // Own inputs the server hasn't confirmed yet, for the ticks from m_firstLocalTick on
+    std::vector<std::uint8_t> m_localInputs;
+    int m_firstLocalTick {0};
+
+    std::vector<std::uint8_t> m_datagram;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef LOOPBACK_NETWORK_HPP
+#define LOOPBACK_NETWORK_HPP
+
+#include "simulation/NetTransport.hpp"
+#include <chrono>
+#include <memory>
+#include <random>
+
+// In-memory datagram network for tests and benchmarks on one machine. It runs on its own clock,
+// which the caller advances, so latency and loss are simulated without waiting and every run
+// with the same seed delivers the same datagrams at the same times
+class LoopbackNetwork
+{
+public:
+    struct Conditions
+    {
+        std::chrono::microseconds latency {0}; // One way
+        std::chrono::microseconds jitter {0};  // Added to the latency at random, can reorder datagrams
+        double lossRate {0.0};                 // Share of datagrams that are dropped
+    };
+
+    explicit LoopbackNetwork(unsigned int seed = 0);
+
+    void setConditions(const Conditions& conditions);
+    // Endpoints are at 127.0.0.1 with the given port, the network has to outlive them
+    std::unique_ptr<NetTransport> createEndpoint(std::uint16_t port);
+    // A datagram can be received once the time has passed its arrival time
+    void setTime(std::chrono::microseconds now);
+    std::chrono::microseconds getTime() const;
+
+    long long getSentDatagramCount() const;
+    long long getLostDatagramCount() const;
+    long long getSentByteCount() const;
+
+private:
+    class Endpoint;
+
+    struct Datagram
+    {
+        std::chrono::microseconds arrival;
+        long long sequence; // Keeps datagrams with the same arrival time in the order they were sent
+        NetEndpoint from;
+        NetEndpoint to;
+        std::vector<std::uint8_t> data;
+    };
+
+    void post(const NetEndpoint& from, const NetEndpoint& to, const std::vector<std::uint8_t>& data);
+    bool take(const NetEndpoint& to, NetEndpoint* from, std::vector<std::uint8_t>* data);
+
+    Conditions m_conditions;
+    std::chrono::microseconds m_now {0};
+    std::vector<Datagram> m_inFlight;
+    long long m_sentDatagramCount {0};
+    long long m_lostDatagramCount {0};
+    long long m_sentByteCount {0};
+    std::mt19937 m_randomGenerator;
+};
+
+#endif
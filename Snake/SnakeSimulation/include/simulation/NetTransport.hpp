@@ -0,0 +1,37 @@
+#ifndef NET_TRANSPORT_HPP
+#define NET_TRANSPORT_HPP
+
+#include <cstdint>
+#include <vector>
+
+// IPv4 address in host byte order and port of one end of a datagram transport
+struct NetEndpoint
+{
+    std::uint32_t address {0};
+    std::uint16_t port {0};
+};
+
+inline bool operator==(const NetEndpoint& first, const NetEndpoint& second)
+{
+    return first.address == second.address && first.port == second.port;
+}
+
+inline bool operator!=(const NetEndpoint& first, const NetEndpoint& second)
+{
+    return !(first == second);
+}
+
+// Sends and receives datagrams without blocking. Like UDP, datagrams may get lost, duplicated or
+// arrive out of order, the protocols on top have to cope with that
+class NetTransport
+{
+public:
+    virtual ~NetTransport() = default;
+
+    virtual bool send(const NetEndpoint& to, const std::vector<std::uint8_t>& datagram) = 0;
+    // Takes the next datagram that has arrived, false if there is none
+    virtual bool receive(NetEndpoint* from, std::vector<std::uint8_t>* datagram) = 0;
+    virtual NetEndpoint getLocalEndpoint() const = 0;
+};
+
+#endif
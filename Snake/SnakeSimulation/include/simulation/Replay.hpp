@@ -0,0 +1,46 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "simulation/Simulation.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Everything needed to re-simulate one game, together with the level it was played on
+struct Replay
+{
+    unsigned int seed {0};
+    int levelIndex {0}; // Index in the level pack the game was played from
+    std::vector<Simulation::PlayerInput> inputs; // One input per tick
+    int finalScore {0};
+    std::uint64_t finalStateHash {0};
+};
+
+// The input log is stored as runs of equal inputs, each run is one varint of (length << 2 | input)
+std::vector<std::uint8_t> encodeReplay(const Replay& replay);
+bool decodeReplay(const std::vector<std::uint8_t>& data, Replay* replay);
+
+bool saveReplay(const Replay& replay, const std::string& path);
+bool loadReplay(const std::string& path, Replay* replay);
+
+// Re-simulates a replay tick by tick
+class ReplayPlayer
+{
+public:
+    // level has to be the level with the replay's levelIndex
+    bool start(const Replay& replay, const LevelData& level);
+    Simulation::Events step();
+
+    bool isFinished() const;
+    std::size_t getTick() const;
+    // Only meaningful once the replay is finished
+    bool matchesRecording() const;
+    const Simulation& getSimulation() const;
+
+private:
+    Replay m_replay;
+    Simulation m_simulation;
+    std::size_t m_tick {0};
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef ROLLBACK_HPP
+#define ROLLBACK_HPP
+
+#include "simulation/SnakeArena.hpp"
+#include <cstdint>
+#include <vector>
+
+// GGPO style rollback on top of SnakeArena. Ticks are simulated as soon as they are due: inputs that
+// haven't arrived are predicted by repeating the player's last input, so the local input applies right
+// away. When an input arrives that differs from its prediction, the arena goes back to the snapshot
+// before that tick and simulates the ticks since again.
+// The session steers the AI snakes and respawns dead snakes after a while, both only depend on the
+// tick and the arena, so every run with the same inputs ends in the same state no matter when the
+// inputs arrived.
+class RollbackSession
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    // Players are the first snakes, the AI snakes come after them. maxRollbackTicks is how far the
+    // simulation may run ahead of the oldest missing input
+    bool start(const LevelData& level, int playerCount, int aiSnakeCount, unsigned int seed, int maxRollbackTicks = 8);
+    // Inputs for ticks whose inputs were all known already are ignored
+    void addInput(int playerIndex, int tick, PlayerInput input);
+    // Rolls back if an input was mispredicted and simulates the next tick. False without simulating
+    // when the oldest missing input is maxRollbackTicks behind, the game has to wait for it then
+    bool advance();
+
+    const SnakeArena& getArena() const;
+    int getTick() const;               // Ticks simulated so far
+    int getConfirmedTickCount() const; // Ticks from the start whose inputs are all known
+    long long getRollbackCount() const;
+    long long getResimulatedTickCount() const;
+
+private:
+    static constexpr std::uint8_t MISSING_INPUT = 0xFF;
+
+    struct TickSnapshot
+    {
+        SnakeArena::Snapshot arena;
+        std::vector<int> respawnTicks;
+    };
+
+    void simulateTick(int tick);
+    void rollback();
+    // Inputs per tick and player, from m_firstStoredTick on
+    std::uint8_t& getInput(std::vector<std::uint8_t>* inputs, int tick, int playerIndex);
+    std::uint32_t getAIRandomNumber(int tick, int snakeIndex) const;
+
+    SnakeArena m_arena;
+    int m_playerCount {0};
+    int m_maxRollbackTicks {8};
+    unsigned int m_seed {0};
+    std::vector<int> m_respawnTicks;
+    std::vector<PlayerInput> m_stepInputs;
+
+    int m_tick {0};
+    int m_confirmedTickCount {0};
+    int m_rollbackTick {0}; // Oldest simulated tick with a wrong prediction, m_tick if there is none
+
+    std::vector<std::uint8_t> m_confirmedInputs; // MISSING_INPUT until they arrive
+    std::vector<std::uint8_t> m_usedInputs;      // What the simulation used, confirmed or predicted
+    int m_firstStoredTick {0};
+
+    // Ring of the states before the last ticks, the one before tick t is at t % size
+    std::vector<TickSnapshot> m_snapshots;
+
+    long long m_rollbackCount {0};
+    long long m_resimulatedTickCount {0};
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include "simulation/Levels.hpp"
+#include "simulation/SnakeBody.hpp"
+#include "simulation/TileGrid.hpp"
+#include <cstdint>
+#include <random>
+
+// Game rules of a single snake on a TileGrid, independent of window, audio and fonts.
+// One call to step() is one tick of the game.
+class Simulation
+{
+public:
+    enum class PlayerInput
+    {
+        Up, Down, Left, Right
+    };
+
+    // Everything that happened during one step, the presentation layer maps these to sounds and UI
+    struct Events
+    {
+        bool moved {false};
+        bool growing {false};
+        bool ateFood {false};
+        bool ateSuperFood {false};
+        bool teleported {false};
+        bool collided {false};
+        bool spawnedFood {false};
+    };
+
+    Simulation();
+
+    void seed(unsigned int seed);
+    bool loadLevel(const LevelData& level);
+    // Starts over from the state of initial, which has to be a game of the same level.
+    // Unlike loadLevel() nothing is rebuilt and the random numbers continue, so restarting is cheap
+    void restartFrom(const Simulation& initial);
+    void reserveSnakeLength(std::size_t length); // Keeps the snake from allocating until it is this long
+    Events step(PlayerInput input);
+
+    const TileGrid& getGrid() const;
+    const SnakeBody& getSnake() const;
+    int getScore() const;
+    bool isSnakeDead() const;
+    PlayerInput getLastMovement() const;
+    int getRemainingGrowthTicks() const;
+    // Hash over the grid, score and death state, two runs with the same seed and inputs give the same value
+    std::uint64_t computeStateHash() const;
+
+    static bool isOppositeDirection(PlayerInput first, PlayerInput second);
+    // One tile in the direction of the input
+    static sf::Vector2i getDirection(PlayerInput input);
+
+private:
+    void moveSnake(PlayerInput input, Events* events);
+    int eatFood(TileGrid::TileValue food, Events* events);
+    void spawnFood(Events* events);
+    bool isSnakeValid() const;
+    void triggerSnakeDeath();
+    void snakeGrows(int growth);
+    std::uint32_t getRandomNumberBelow(std::uint32_t bound);
+
+    TileGrid m_grid;
+    SnakeBody m_snake;
+    int m_score {0};
+    int m_foodInLevel {0};
+    int m_maxFoodInLevel {20};
+    int m_foodSpawnCooldown {5};
+    int m_remainingGrowthTicks {0}; // Pending growth, the tail stays in place while this is > 0
+    int m_remainingFoodSpawnCooldown {0};
+    PlayerInput m_lastMovement {PlayerInput::Up};
+    bool m_snakeIsDead {false};
+
+    // mt19937 produces the same sequence with every standard library, the distributions don't,
+    // so random numbers are mapped to ranges by getRandomNumberBelow() to keep replays portable
+    std::mt19937 m_randomGenerator;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef SNAKE_ARENA_HPP
+#define SNAKE_ARENA_HPP
+
+#include "simulation/Simulation.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Many snakes on one TileGrid with the rules of Simulation. All snakes move at the same time:
+// every head's target is checked against the tiles as they were before the tick, so the order of
+// the snakes doesn't matter. A snake dies when it moves into a wall or any snake tile (tails
+// included, like in the single snake game) or when another head moves onto the same tile, which
+// also decides shared food. Two snakes swapping places run into each other's neck and both die.
+// Snakes are stored as arrays per property and their bodies as links between tiles, so a tick
+// costs O(snakes) plus the length of the snakes that died.
+class SnakeArena
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    SnakeArena();
+
+    void seed(unsigned int seed);
+    // Snake 0 starts where the level says, the others on random free tiles. False if not all of them fit
+    bool loadLevel(const LevelData& level, int snakeCount);
+    // inputs holds one input per snake, the inputs of dead snakes are ignored
+    void step(const PlayerInput* inputs);
+    // Clears the body of a dead snake and places it on random free tiles, false if no place was found
+    bool respawnSnake(int index);
+
+    // Straight on while that is safe, otherwise or now and then (random % 8 == 0) a random safe turn.
+    // Food next to the head is always taken. Cheap enough to steer thousands of snakes every tick
+    PlayerInput getWanderInput(int index, std::uint32_t random) const;
+
+    const TileGrid& getGrid() const;
+    int getSnakeCount() const;
+    int getAliveSnakeCount() const;
+    bool isSnakeAlive(int index) const;
+    int getScore(int index) const;
+    int getSnakeLength(int index) const;
+    sf::Vector2i getHead(int index) const;
+    sf::Vector2i getTail(int index) const;
+    PlayerInput getLastMovement(int index) const;
+    const Simulation::Events& getEvents(int index) const; // What happened to the snake in the last step
+    // Hash over the grid, scores and alive flags, two runs with the same seed and inputs give the same value
+    std::uint64_t computeStateHash() const;
+
+    // Everything step() and respawnSnake() change apart from the tiles. The tiles are restored from undo
+    // journals the grid and the arena keep while rollbacks are enabled, so saving costs O(snakes) and
+    // restoring O(snakes + tile changes since the snapshot) instead of copying the whole level
+    struct Snapshot
+    {
+        std::size_t gridJournalPosition {0};
+        std::size_t linkJournalPosition {0};
+        int foodInLevel {0};
+        int remainingFoodSpawnCooldown {0};
+        int aliveSnakeCount {0};
+        std::vector<int> heads;
+        std::vector<int> tails;
+        std::vector<int> lengths;
+        std::vector<int> remainingGrowthTicks;
+        std::vector<int> scores;
+        std::vector<PlayerInput> lastMovements;
+        std::vector<std::uint8_t> alive;
+        std::vector<Simulation::Events> events;
+        std::mt19937 randomGenerator;
+    };
+
+    // Off by default, the journals grow with every tick until forgetSnapshotsBefore() trims them
+    void setRollbackEnabled(bool enabled);
+    // Reuses the vectors of snapshot, saving into the same snapshots over and over doesn't allocate
+    void saveSnapshot(Snapshot* snapshot) const;
+    // The snapshot has to be from the current level and not older than the last forgetSnapshotsBefore().
+    // The grid's changed tiles list every tile the restore touched
+    void restoreSnapshot(const Snapshot& snapshot);
+    // Snapshots saved before this one can't be restored anymore
+    void forgetSnapshotsBefore(const Snapshot& snapshot);
+
+private:
+    // Tile the head reaches with input, teleporters included. -1 outside of the grid
+    int getTarget(int index, PlayerInput input) const;
+    bool placeSnake(int index, const std::vector<sf::Vector2i>& parts); // Head first, all tiles have to be empty
+    void killSnake(int index);
+    void spawnFood();
+    sf::Vector2i toPosition(int tile) const;
+    std::uint32_t getRandomNumberBelow(std::uint32_t bound);
+    void setNextPart(int tile, int nextPart);
+
+    static bool isDeadly(TileGrid::TileValue value);
+
+    static constexpr int NO_CLAIM = -1;
+    static constexpr int CONTESTED = -2;
+
+    TileGrid m_grid;
+    int m_startLength {3};
+    int m_foodInLevel {0};
+    int m_maxFoodInLevel {20};
+    int m_foodSpawnCooldown {5};
+    int m_foodPerSpawn {1};
+    int m_remainingFoodSpawnCooldown {0};
+    int m_aliveSnakeCount {0};
+
+    // Per snake
+    std::vector<int> m_heads;          // Tile indices
+    std::vector<int> m_tails;
+    std::vector<int> m_lengths;
+    std::vector<int> m_remainingGrowthTicks;
+    std::vector<int> m_scores;
+    std::vector<PlayerInput> m_lastMovements;
+    std::vector<std::uint8_t> m_alive;
+    std::vector<Simulation::Events> m_events;
+    std::vector<int> m_targets;        // Only valid during step()
+
+    // Per tile
+    std::vector<int> m_nextPart;       // Snake tiles link to the next part towards the head, -1 elsewhere
+    std::vector<int> m_claims;         // Snake moving onto the tile during step(), NO_CLAIM between steps
+
+    std::vector<sf::Vector2i> m_placement; // Reused by respawnSnake()
+
+    // Old values of m_nextPart, recorded while rollbacks are enabled
+    struct LinkChange
+    {
+        int tile;
+        int nextPart;
+    };
+    bool m_isRollbackEnabled {false};
+    std::vector<LinkChange> m_linkJournal;
+    std::size_t m_linkJournalStart {0}; // Position of m_linkJournal.front()
+
+    std::mt19937 m_randomGenerator;
+};
+
+#endif
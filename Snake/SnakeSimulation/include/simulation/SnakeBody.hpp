@@ -0,0 +1,34 @@
+#ifndef SNAKE_BODY_HPP
+#define SNAKE_BODY_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+// Snake parts stored as a ring buffer, moving the snake only touches the head and the tail.
+// Index 0 is the head, size() - 1 the tail.
+class SnakeBody
+{
+public:
+    void clear();
+    void pushHead(sf::Vector2i position);
+    void pushTail(sf::Vector2i position);
+    void popTail();
+    void reserve(std::size_t capacity); // Parts that fit before the buffer has to grow
+
+    sf::Vector2i getHead() const;
+    sf::Vector2i getTail() const;
+    sf::Vector2i operator[](std::size_t index) const;
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    void grow(std::size_t capacity);
+    std::size_t toStorageIndex(std::size_t index) const;
+
+    std::vector<sf::Vector2i> m_parts;
+    std::size_t m_head {0};
+    std::size_t m_size {0};
+};
+
+#endif
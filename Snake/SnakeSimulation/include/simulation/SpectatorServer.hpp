@@ -0,0 +1,80 @@
+#ifndef SPECTATOR_SERVER_HPP
+#define SPECTATOR_SERVER_HPP
+
+#include "simulation/SpectatorStream.hpp"
+#include <SFML/Network/TcpListener.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Streams a game to any number of viewers over TCP, programs using it have to link sfml-network.
+// Deltas only make sense in order and without gaps, TCP gives that for free. Every message is sent
+// with its length as a varint in front.
+// Sockets never block: a viewer that can't keep up stops getting deltas once its backlog is too
+// large and gets a new keyframe when the backlog is sent, so a slow viewer never holds up the game.
+class SpectatorServer
+{
+public:
+    bool listen(std::uint16_t port);
+    // Accepts new viewers, queues keyframes for the ones that need one and sends what is queued.
+    // Has to be called every frame with the current state of the game
+    void update(const TileGrid& grid, sf::Vector2u tileSize, std::uint32_t tick, int score);
+    // Queues the tiles grid.getChangedTiles() lists for every viewer, called after each tick
+    void broadcastTick(const TileGrid& grid, std::uint32_t tick, int score);
+    // All viewers get a keyframe with the next update(), after a new level was loaded
+    void resync();
+
+    int getViewerCount() const;
+    long long getSentByteCount() const;
+    long long getKeyframeCount() const; // Keyframes sent to all viewers together
+
+private:
+    struct Viewer
+    {
+        std::unique_ptr<sf::TcpSocket> socket;
+        std::vector<std::uint8_t> queue;
+        std::size_t sentSize {0}; // Bytes at the front of queue that were sent
+        bool needsKeyframe {true};
+    };
+
+    void queueMessage(Viewer* viewer, const std::vector<std::uint8_t>& message);
+    // False once the viewer is gone
+    bool flush(Viewer* viewer);
+
+    sf::TcpListener m_listener;
+    bool m_isListening {false};
+    std::vector<Viewer> m_viewers;
+    std::unique_ptr<sf::TcpSocket> m_nextSocket;
+
+    SpectatorEncoder m_encoder;
+    std::vector<std::uint8_t> m_message;
+    long long m_sentByteCount {0};
+    long long m_keyframeCount {0};
+};
+
+class SpectatorClient
+{
+public:
+    // Blocks until the server answered or timeout milliseconds passed
+    bool connect(const std::string& host, std::uint16_t port, int timeout = 3000);
+    // Applies all messages that arrived completely. False once the server is gone or sent something broken
+    bool update();
+
+    const SpectatorDecoder& getDecoder() const;
+    // To clear the changed tiles once they are drawn
+    SpectatorDecoder& getDecoder();
+    long long getReceivedByteCount() const;
+
+private:
+    sf::TcpSocket m_socket;
+    bool m_isConnected {false};
+    SpectatorDecoder m_decoder;
+    std::vector<std::uint8_t> m_received;
+    std::vector<std::uint8_t> m_buffer;
+    std::vector<std::uint8_t> m_message;
+    long long m_receivedByteCount {0};
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SPECTATOR_STREAM_HPP
+#define SPECTATOR_STREAM_HPP
+
+#include "simulation/TileGrid.hpp"
+#include <cstdint>
+#include <vector>
+
+// Messages that let a spectator follow a game: a keyframe with the whole grid when it joins, then
+// one delta per tick with the tiles that tick changed. A tick only changes a few tiles, so a delta
+// is a few bytes no matter how large the level is.
+// Keyframe: type, tick, score, tile size, width, height, then runs of (length, tile value).
+// Delta: type, tick, score, count, then per tile the distance to the previous tile index and the value.
+class SpectatorEncoder
+{
+public:
+    void encodeKeyframe(const TileGrid& grid, sf::Vector2u tileSize, std::uint32_t tick, int score, std::vector<std::uint8_t>* message);
+    // The tiles grid.getChangedTiles() lists, each once with its current value
+    void encodeDelta(const TileGrid& grid, std::uint32_t tick, int score, std::vector<std::uint8_t>* message);
+
+private:
+    std::vector<int> m_changedTiles; // Reused, sorted tile indices of the delta
+};
+
+// Rebuilds the grid from the messages of a SpectatorEncoder
+class SpectatorDecoder
+{
+public:
+    // False if the message is broken or a delta comes before the first keyframe
+    bool apply(const std::vector<std::uint8_t>& message);
+
+    bool hasKeyframe() const;
+    long long getKeyframeCount() const; // Changes whenever the grid was replaced and has to be loaded again
+    // Deltas add to the changed tiles of the grid, the owner decides when to clear them
+    TileGrid& getGrid();
+    const TileGrid& getGrid() const;
+    sf::Vector2u getTileSize() const;
+    std::uint32_t getTick() const;
+    int getScore() const;
+
+private:
+    TileGrid m_grid;
+    bool m_hasKeyframe {false};
+    long long m_keyframeCount {0};
+    sf::Vector2u m_tileSize;
+    std::uint32_t m_tick {0};
+    int m_score {0};
+    std::vector<int> m_gridData; // Reused by keyframes
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef TILE_GRID_HPP
+#define TILE_GRID_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Logical game grid without any rendering, shared by the game and headless tools
+class TileGrid
+{
+public:
+	enum class TileValue : std::uint8_t
+	{
+		Empty, Wall, SnakeBody, SnakeHead, Food, SuperFood,
+		Poison, Teleport1, Teleport2, NoPlayArea, DeadSnakeBody, DeadSnakeHead
+	};
+
+    // Tile groups that can be mirrored into bit planes
+    enum class BitPlane
+    {
+        Walls, Snake, Food, Free
+    };
+
+	bool loadFromArray(const std::vector<int>& level, int width, int height);
+	void updateTile(int x, int y, TileValue value);
+	void updateTile(sf::Vector2i position, TileValue value);
+    bool isValidPosition(int x, int y) const;
+    bool isValidPosition(sf::Vector2i position) const;
+    bool getTileValueAt(int x, int y, TileValue* const tileValueToSet) const;
+    bool getTileValueAt(sf::Vector2i position, TileValue* const tileValueToSet) const;
+    void getListOfEmptyTiles(std::vector<sf::Vector2i>* tileList) const;
+    std::size_t getEmptyTileCount() const;
+    sf::Vector2i getEmptyTile(std::size_t index) const; // index in [0, getEmptyTileCount())
+    std::optional<sf::Vector2i> getPositionOfOtherTeleporter1(sf::Vector2i position) const;
+    std::optional<sf::Vector2i> getPositionOfOtherTeleporter2(sf::Vector2i position) const;
+
+    int getWidth() const;
+    int getHeight() const;
+
+    // Positions touched by updateTile() since the last clear, lets views sync only what changed
+    const std::vector<sf::Vector2i>& getChangedTiles() const;
+    void clearChangedTiles();
+
+    // Optional undo log of updateTile() for rollbacks, disabled by default. Positions count every recorded
+    // change since the level was loaded. Undoing restores the tiles and the order of the empty tile set
+    // exactly, so random picks from it after a rollback are the same as the first time
+    void setJournalEnabled(bool enabled);
+    std::size_t getJournalPosition() const;
+    // Undoes the changes recorded after position, newest first. Undone tiles count as changed
+    void undoJournal(std::size_t position);
+    // Drops the changes before position, they can't be undone anymore
+    void forgetJournal(std::size_t position);
+
+    // Optional one bit per tile views, every row is padded to whole 64 bit words.
+    // Disabled by default since the game itself only needs per tile lookups.
+    void setBitPlanesEnabled(bool enabled);
+    bool areBitPlanesEnabled() const;
+    const std::vector<std::uint64_t>& getBitPlane(BitPlane plane) const;
+    int getWordsPerRow() const;
+    std::size_t countTiles(BitPlane plane) const;
+    void getCollisionMask(std::vector<std::uint64_t>* mask) const;
+    void getBlockedNeighbourMask(std::vector<std::uint64_t>* mask) const;
+
+    std::size_t getMemoryUsage() const;
+
+private:
+    void addEmptyTile(int tileIndex);
+    void removeEmptyTile(int tileIndex);
+    void buildBitPlanes();
+    void setBitPlaneBit(TileValue value, int x, int y, bool isSet);
+    static std::optional<BitPlane> getBitPlaneOfTileValue(TileValue value);
+
+    struct JournalEntry
+    {
+        int tileIndex;
+        int emptyTileSlot; // Slot the tile had in the empty tile set before it was filled, -1 if it wasn't empty
+        TileValue oldValue;
+    };
+
+    struct TeleporterPair
+    {
+        TeleporterPair(sf::Vector2i pos1, sf::Vector2i pos2)
+            :pos1(pos1), pos2(pos2){}
+        sf::Vector2i pos1;
+        sf::Vector2i pos2;
+    };
+
+	int m_width {0};
+	int m_height {0};
+	std::vector<TileValue> m_grid;
+
+    // Indexed set of all empty tiles: dense list of tile indices and each tile's slot in it (-1 if not empty)
+    std::vector<int> m_emptyTiles;
+    std::vector<int> m_emptyTileSlots;
+    std::vector<sf::Vector2i> m_changedTiles;
+    std::optional<TeleporterPair> m_teleporterPair1;
+    std::optional<TeleporterPair> m_teleporterPair2;
+
+    bool m_journalEnabled {false};
+    std::vector<JournalEntry> m_journal;
+    std::size_t m_journalStart {0}; // Position of m_journal.front()
+
+    bool m_bitPlanesEnabled {false};
+    int m_wordsPerRow {0};
+    std::array<std::vector<std::uint64_t>, 4> m_bitPlanes;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef UDP_TRANSPORT_HPP
+#define UDP_TRANSPORT_HPP
+
+#include "simulation/NetTransport.hpp"
+#include <SFML/Network/UdpSocket.hpp>
+#include <optional>
+#include <string>
+
+// NetTransport over a non-blocking sf::UdpSocket, programs using it have to link sfml-network
+class UdpTransport : public NetTransport
+{
+public:
+    UdpTransport();
+
+    // Port 0 binds to any free port
+    bool bind(std::uint16_t port);
+
+    virtual bool send(const NetEndpoint& to, const std::vector<std::uint8_t>& datagram) override;
+    virtual bool receive(NetEndpoint* from, std::vector<std::uint8_t>* datagram) override;
+    virtual NetEndpoint getLocalEndpoint() const override;
+
+    // Accepts addresses like "192.168.0.2" and host names, empty if the host is unknown
+    static std::optional<NetEndpoint> resolve(const std::string& host, std::uint16_t port);
+
+private:
+    sf::UdpSocket m_socket;
+    std::vector<std::uint8_t> m_buffer;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef VECTOR_ENVIRONMENT_HPP
+#define VECTOR_ENVIRONMENT_HPP
+
+#include "simulation/Simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Steps many independent games of one level at once, meant for training agents.
+// Observations, rewards and done flags are written into buffers owned by the caller, stepping
+// doesn't allocate. A finished game starts over right away, its observation then already shows
+// the new game while its done flag tells that the previous one ended.
+class VectorEnvironment
+{
+public:
+    using PlayerInput = Simulation::PlayerInput;
+
+    // One byte per tile in every plane, 1 where the tile belongs to the plane
+    enum class ObservationPlane
+    {
+        Walls,       // Walls and NoPlayArea
+        SnakeBody,
+        SnakeHead,
+        Food,
+        SuperFood,
+        Teleporters,
+        Count
+    };
+
+    static const int OBSERVATION_PLANE_COUNT = static_cast<int>(ObservationPlane::Count);
+    // Reward of the step the snake dies in, eating gives the score of the food
+    static constexpr float DEATH_REWARD = -1.0f;
+
+    // reset() seeds game i with seed + i, a game that starts over keeps drawing from its random numbers.
+    // Games that last maxTicks are ended like a death, but without the death reward
+    bool create(const LevelData& level, int gameCount, unsigned int seed, long long maxTicks);
+
+    // observations holds getObservationSize() bytes per game, rewards and dones one entry per game.
+    // The buffers have to stay the same between steps, a step only rewrites the tiles that changed
+    void setBuffers(std::uint8_t* observations, float* rewards, std::uint8_t* dones);
+    // Starts all games over and writes their full observations
+    void reset();
+
+    // actions holds one PlayerInput value (0 - 3) per game
+    void step(const std::uint8_t* actions);
+    // Steps only the games in [begin, end), threads may step disjoint ranges at the same time
+    void stepRange(const std::uint8_t* actions, int begin, int end);
+
+    int getGameCount() const;
+    int getWidth() const;
+    int getHeight() const;
+    std::size_t getObservationSize() const; // Bytes per game: height * width * planes, the planes of a tile are next to each other
+    const Simulation& getGame(int index) const;
+
+private:
+    void resetGame(int index);
+    void writeTile(std::uint8_t* observation, sf::Vector2i position, TileGrid::TileValue value) const;
+
+    // Games restart from this one. They have room for a snake over the whole level, so steps never allocate
+    Simulation m_initialGame;
+    std::vector<std::uint8_t> m_initialObservation;
+    std::vector<Simulation> m_games;
+    std::vector<long long> m_ticks;
+    unsigned int m_seed {0};
+    long long m_maxTicks {0};
+    int m_width {0};
+    int m_height {0};
+
+    std::uint8_t* m_observations {nullptr};
+    float* m_rewards {nullptr};
+    std::uint8_t* m_dones {nullptr};
+};
+
+#endif
@@ -0,0 +1,304 @@
+#include "simulation/Autopilot.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const std::uint8_t MAX_SEARCH_NUMBER = 63;
+
+    // The clock is only read every few tiles, reading it is slower than expanding a tile
+    const int TILES_PER_CLOCK_CHECK = 64;
+    const int SCANNED_TILES_PER_CLOCK_CHECK = 4096;
+    const int CLEARED_TILES_PER_CLOCK_CHECK = 1 << 16;
+
+    const Simulation::PlayerInput ALL_INPUTS[] = {
+        Simulation::PlayerInput::Up, Simulation::PlayerInput::Down, Simulation::PlayerInput::Left, Simulation::PlayerInput::Right
+    };
+
+    std::optional<sf::Vector2i> getPartnerTeleporter(const TileGrid& grid, sf::Vector2i position, TileGrid::TileValue value)
+    {
+        if (value == TileGrid::TileValue::Teleport1)
+            return grid.getPositionOfOtherTeleporter1(position);
+        if (value == TileGrid::TileValue::Teleport2)
+            return grid.getPositionOfOtherTeleporter2(position);
+        return std::nullopt;
+    }
+}
+
+void Autopilot::reset()
+{
+    m_phase = Phase::Idle;
+    m_score = -1;
+    m_queue.clear();
+    m_queueFront = 0;
+    m_visitedTileCount = 0;
+}
+
+void Autopilot::think(const Simulation& simulation, std::chrono::microseconds budget)
+{
+    if (simulation.isSnakeDead() || simulation.getSnake().empty())
+        return;
+
+    const TileGrid& grid = simulation.getGrid();
+    if (grid.getWidth() != m_width || grid.getHeight() != m_height || simulation.getScore() != m_score)
+        m_phase = Phase::Idle;
+    if (m_phase == Phase::Idle)
+        startSearch(simulation);
+
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    const sf::Vector2i head = simulation.getSnake().getHead();
+    const int headTile = head.x + head.y * m_width;
+    const int tileCount = m_width * m_height;
+
+    if (m_phase == Phase::Clearing)
+    {
+        while (m_scanTile < tileCount)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return;
+
+            const int clearCount = std::min(CLEARED_TILES_PER_CLOCK_CHECK, tileCount - m_scanTile);
+            std::memset(&m_labels[m_scanTile], 0, clearCount);
+            m_scanTile += clearCount;
+        }
+        m_scanTile = 0;
+        m_phase = Phase::Scanning;
+    }
+
+    if (m_phase == Phase::Scanning)
+    {
+        for (; m_scanTile < tileCount; ++m_scanTile)
+        {
+            if (m_scanTile % SCANNED_TILES_PER_CLOCK_CHECK == 0 && std::chrono::steady_clock::now() >= deadline)
+                return;
+
+            TileGrid::TileValue value = TileGrid::TileValue::Empty;
+            grid.getTileValueAt(m_scanTile % m_width, m_scanTile / m_width, &value);
+            if (value == TileGrid::TileValue::Food || value == TileGrid::TileValue::SuperFood)
+            {
+                label(m_scanTile, PlayerInput::Up);
+                m_queue.push_back(m_scanTile);
+            }
+        }
+        m_phase = Phase::Expanding;
+    }
+
+    if (m_phase == Phase::Expanding)
+    {
+        int expandedTiles = 0;
+        while (m_queueFront < m_queue.size())
+        {
+            // The rest of the level is only needed once the snake leaves the tiles searched so far
+            if (isLabeled(headTile))
+                return;
+            if (++expandedTiles % TILES_PER_CLOCK_CHECK == 0 && std::chrono::steady_clock::now() >= deadline)
+                return;
+
+            expandTile(grid, m_queue[m_queueFront++], headTile);
+
+            // Drop the processed part of the queue now and then, the queue only has to hold the wave front
+            if (m_queueFront >= 4096 && m_queueFront * 2 >= m_queue.size())
+            {
+                m_queue.erase(m_queue.begin(), m_queue.begin() + m_queueFront);
+                m_queueFront = 0;
+            }
+        }
+        m_phase = Phase::Done;
+    }
+}
+
+Autopilot::PlayerInput Autopilot::getInput(const Simulation& simulation)
+{
+    if (simulation.getSnake().empty() || !isSearchedThisFar()
+        || simulation.getGrid().getWidth() != m_width || simulation.getGrid().getHeight() != m_height)
+        return getSafeInput(simulation);
+
+    const sf::Vector2i head = simulation.getSnake().getHead();
+    const int headTile = head.x + head.y * m_width;
+    if (isLabeled(headTile))
+    {
+        const PlayerInput input = getLabel(headTile);
+        int nextTile;
+        if (!Simulation::isOppositeDirection(input, simulation.getLastMovement()) && getNextTile(simulation.getGrid(), headTile, input, &nextTile))
+            return input;
+
+        // Something moved into the path since the search, search again with the current state
+        m_phase = Phase::Idle;
+    }
+    else if (m_phase == Phase::Done)
+    {
+        // The snake left the searched tiles or no food is reachable, try again with the current state
+        m_phase = Phase::Idle;
+    }
+
+    return getSafeInput(simulation);
+}
+
+bool Autopilot::isSearching() const
+{
+    return m_phase == Phase::Clearing || m_phase == Phase::Scanning || m_phase == Phase::Expanding;
+}
+
+bool Autopilot::hasPathFromHead(const Simulation& simulation) const
+{
+    if (!isSearchedThisFar() || simulation.getSnake().empty()
+        || simulation.getGrid().getWidth() != m_width || simulation.getGrid().getHeight() != m_height)
+        return false;
+
+    const sf::Vector2i head = simulation.getSnake().getHead();
+    return isLabeled(head.x + head.y * m_width);
+}
+
+std::uint64_t Autopilot::getVisitedTileCount() const
+{
+    return m_visitedTileCount;
+}
+
+void Autopilot::startSearch(const Simulation& simulation)
+{
+    const TileGrid& grid = simulation.getGrid();
+    m_phase = Phase::Scanning;
+    if (grid.getWidth() != m_width || grid.getHeight() != m_height)
+    {
+        m_width = grid.getWidth();
+        m_height = grid.getHeight();
+        m_labels.reset(new std::uint8_t[static_cast<std::size_t>(m_width) * m_height]);
+        m_searchNumber = 0;
+        m_phase = Phase::Clearing;
+    }
+
+    // Search numbers only have 6 bits, clear all labels once they run out
+    if (++m_searchNumber > MAX_SEARCH_NUMBER)
+    {
+        m_searchNumber = 1;
+        m_phase = Phase::Clearing;
+    }
+
+    m_score = simulation.getScore();
+    m_scanTile = 0;
+    m_queue.clear();
+    m_queueFront = 0;
+}
+
+void Autopilot::expandTile(const TileGrid& grid, int tile, int headTile)
+{
+    const sf::Vector2i position(tile % m_width, tile / m_width);
+
+    // Look for every tile from which one input leads onto this tile
+    for (PlayerInput input : ALL_INPUTS)
+    {
+        const sf::Vector2i direction = Simulation::getDirection(input);
+        sf::Vector2i previous = position - direction;
+
+        TileGrid::TileValue value;
+        if (!grid.getTileValueAt(previous, &value))
+            continue;
+
+        // Arriving behind a teleporter means the move started in front of its partner
+        if (auto partner = getPartnerTeleporter(grid, previous, value))
+        {
+            previous = *partner - direction;
+            if (!grid.getTileValueAt(previous, &value))
+                continue;
+        }
+
+        const int previousTile = previous.x + previous.y * m_width;
+        if (isLabeled(previousTile))
+            continue;
+
+        // The head gets its input but the search doesn't continue through the snake
+        if (previousTile == headTile)
+        {
+            label(previousTile, input);
+            continue;
+        }
+        if (isBlocked(value) || getPartnerTeleporter(grid, previous, value))
+            continue;
+
+        label(previousTile, input);
+        m_queue.push_back(previousTile);
+    }
+}
+
+bool Autopilot::getNextTile(const TileGrid& grid, int tile, PlayerInput input, int* nextTile) const
+{
+    const sf::Vector2i direction = Simulation::getDirection(input);
+    sf::Vector2i next = sf::Vector2i(tile % m_width, tile / m_width) + direction;
+
+    TileGrid::TileValue value;
+    if (!grid.getTileValueAt(next, &value))
+        return false;
+
+    // Same as Simulation::moveSnake(), the head comes out one tile behind the partner teleporter
+    if (auto partner = getPartnerTeleporter(grid, next, value))
+    {
+        next = *partner + direction;
+        if (!grid.getTileValueAt(next, &value))
+            return false;
+    }
+
+    if (isBlocked(value))
+        return false;
+
+    *nextTile = next.x + next.y * m_width;
+    return true;
+}
+
+bool Autopilot::isSearchedThisFar() const
+{
+    return m_phase == Phase::Expanding || m_phase == Phase::Done;
+}
+
+bool Autopilot::isLabeled(int tile) const
+{
+    return (m_labels[tile] >> 2) == m_searchNumber;
+}
+
+void Autopilot::label(int tile, PlayerInput input)
+{
+    m_labels[tile] = static_cast<std::uint8_t>((m_searchNumber << 2) | static_cast<std::uint8_t>(input));
+    ++m_visitedTileCount;
+}
+
+Autopilot::PlayerInput Autopilot::getLabel(int tile) const
+{
+    return static_cast<PlayerInput>(m_labels[tile] & 3);
+}
+
+Autopilot::PlayerInput Autopilot::getSafeInput(const Simulation& simulation) const
+{
+    const PlayerInput lastMovement = simulation.getLastMovement();
+    if (m_width != simulation.getGrid().getWidth() || m_height != simulation.getGrid().getHeight())
+        return lastMovement;
+
+    const sf::Vector2i head = simulation.getSnake().getHead();
+    const int headTile = head.x + head.y * m_width;
+
+    // Keep going if possible, otherwise take the first turn that doesn't kill the snake
+    int nextTile;
+    if (getNextTile(simulation.getGrid(), headTile, lastMovement, &nextTile))
+        return lastMovement;
+
+    for (PlayerInput input : ALL_INPUTS)
+    {
+        if (!Simulation::isOppositeDirection(input, lastMovement) && getNextTile(simulation.getGrid(), headTile, input, &nextTile))
+            return input;
+    }
+    return lastMovement;
+}
+
+bool Autopilot::isBlocked(TileGrid::TileValue value)
+{
+    switch (value)
+    {
+    case TileGrid::TileValue::Empty:
+    case TileGrid::TileValue::Food:
+    case TileGrid::TileValue::SuperFood:
+    case TileGrid::TileValue::Poison:
+    case TileGrid::TileValue::Teleport1:
+    case TileGrid::TileValue::Teleport2:
+        return false;
+    default:
+        return true;
+    }
+}
@@ -0,0 +1,202 @@
+#include "simulation/CycleFollower.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Tiles kept free behind the shortcut on top of the pending growth, one super food grows the snake by 5
+    const int SHORTCUT_MARGIN = 8;
+
+    const Simulation::PlayerInput ALL_INPUTS[] = {
+        Simulation::PlayerInput::Up, Simulation::PlayerInput::Down, Simulation::PlayerInput::Left, Simulation::PlayerInput::Right
+    };
+
+    Simulation::PlayerInput getOppositeInput(Simulation::PlayerInput input)
+    {
+        switch (input)
+        {
+        case Simulation::PlayerInput::Up:
+            return Simulation::PlayerInput::Down;
+        case Simulation::PlayerInput::Down:
+            return Simulation::PlayerInput::Up;
+        case Simulation::PlayerInput::Left:
+            return Simulation::PlayerInput::Right;
+        default:
+            return Simulation::PlayerInput::Left;
+        }
+    }
+}
+
+void CycleFollower::reset(const HamiltonianCycle* cycle)
+{
+    m_cycle = cycle;
+    m_isDirectionChosen = false;
+    m_isReversed = false;
+    m_isBodyAlongCycle = false;
+}
+
+CycleFollower::PlayerInput CycleFollower::getInput(const Simulation& simulation)
+{
+    const SnakeBody& snake = simulation.getSnake();
+    if (!m_cycle || m_cycle->isEmpty() || snake.empty())
+        return simulation.getLastMovement();
+
+    const auto headOrder = m_cycle->getOrder(snake.getHead());
+    if (!headOrder)
+    {
+        m_isBodyAlongCycle = false;
+        return getInputTowardsCycle(simulation);
+    }
+
+    // Follow the cycle in the direction that doesn't lead back into the neck
+    if (!m_isDirectionChosen)
+    {
+        m_isDirectionChosen = true;
+        m_isReversed = snake.size() > 1 && m_cycle->getPosition(getNextOrder(*headOrder)) == snake[1];
+    }
+
+    if (!m_isBodyAlongCycle)
+        m_isBodyAlongCycle = isBodyAlongCycle(snake);
+
+    if (m_isBodyAlongCycle)
+    {
+        if (auto shortcut = getShortcut(simulation, *headOrder))
+            return *shortcut;
+    }
+    return getCycleInput(*headOrder);
+}
+
+int CycleFollower::getNextOrder(int order) const
+{
+    const int length = m_cycle->getLength();
+    return m_isReversed ? (order + length - 1) % length : (order + 1) % length;
+}
+
+int CycleFollower::getDistance(int fromOrder, int toOrder) const
+{
+    const int length = m_cycle->getLength();
+    return m_isReversed ? (fromOrder - toOrder + length) % length : (toOrder - fromOrder + length) % length;
+}
+
+CycleFollower::PlayerInput CycleFollower::getCycleInput(int order) const
+{
+    // Walking the cycle backwards undoes the step that led onto this tile
+    if (m_isReversed)
+        return getOppositeInput(m_cycle->getInput(getNextOrder(order)));
+    return m_cycle->getInput(order);
+}
+
+std::optional<CycleFollower::PlayerInput> CycleFollower::getShortcut(const Simulation& simulation, int headOrder) const
+{
+    const SnakeBody& snake = simulation.getSnake();
+    const int growth = simulation.getRemainingGrowthTicks();
+    if (static_cast<int>(snake.size()) + growth >= m_cycle->getLength() / 2)
+        return std::nullopt;
+
+    const auto tailOrder = m_cycle->getOrder(snake.getTail());
+    if (!tailOrder)
+        return std::nullopt;
+
+    // The body lies between tail and head, so everything ahead of the head up to the tail is free
+    const int maxSkip = getDistance(headOrder, *tailOrder) - growth - SHORTCUT_MARGIN;
+    if (maxSkip <= 1)
+        return std::nullopt;
+
+    // Never skip the next food on the cycle
+    const TileGrid& grid = simulation.getGrid();
+    int limit = maxSkip;
+    for (int distance = 1, order = getNextOrder(headOrder); distance < maxSkip; ++distance, order = getNextOrder(order))
+    {
+        TileGrid::TileValue value;
+        if (grid.getTileValueAt(m_cycle->getPosition(order), &value)
+            && (value == TileGrid::TileValue::Food || value == TileGrid::TileValue::SuperFood))
+        {
+            limit = distance;
+            break;
+        }
+    }
+
+    std::optional<PlayerInput> shortcut;
+    int shortcutDistance = 1;
+    for (PlayerInput input : ALL_INPUTS)
+    {
+        if (Simulation::isOppositeDirection(input, simulation.getLastMovement()))
+            continue;
+
+        const auto neighbour = HamiltonianCycle::getNeighbour(grid, snake.getHead(), input);
+        if (!neighbour || !isFree(grid, *neighbour))
+            continue;
+        const auto neighbourOrder = m_cycle->getOrder(*neighbour);
+        if (!neighbourOrder)
+            continue;
+
+        const int distance = getDistance(headOrder, *neighbourOrder);
+        if (distance > shortcutDistance && distance <= limit)
+        {
+            shortcut = input;
+            shortcutDistance = distance;
+        }
+    }
+    return shortcut;
+}
+
+CycleFollower::PlayerInput CycleFollower::getInputTowardsCycle(const Simulation& simulation) const
+{
+    // Usually only happens at the start or when the follower takes over from the player
+    const TileGrid& grid = simulation.getGrid();
+    const sf::Vector2i head = simulation.getSnake().getHead();
+    std::optional<PlayerInput> safeInput;
+    for (PlayerInput input : ALL_INPUTS)
+    {
+        if (Simulation::isOppositeDirection(input, simulation.getLastMovement()))
+            continue;
+
+        const auto neighbour = HamiltonianCycle::getNeighbour(grid, head, input);
+        if (!neighbour || !isFree(grid, *neighbour))
+            continue;
+        if (m_cycle->getOrder(*neighbour))
+            return input;
+        if (!safeInput || input == simulation.getLastMovement())
+            safeInput = input;
+    }
+    return safeInput.value_or(simulation.getLastMovement());
+}
+
+bool CycleFollower::isBodyAlongCycle(const SnakeBody& snake) const
+{
+    const auto tailOrder = m_cycle->getOrder(snake.getTail());
+    if (!tailOrder)
+        return false;
+
+    // From the tail to the head every part has to be further along the cycle than the one before
+    int previousDistance = 0;
+    for (std::size_t i = snake.size() - 1; i-- > 0; )
+    {
+        const auto order = m_cycle->getOrder(snake[i]);
+        if (!order)
+            return false;
+
+        const int distance = getDistance(*tailOrder, *order);
+        if (distance <= previousDistance)
+            return false;
+        previousDistance = distance;
+    }
+    return true;
+}
+
+bool CycleFollower::isFree(const TileGrid& grid, sf::Vector2i position)
+{
+    TileGrid::TileValue value;
+    if (!grid.getTileValueAt(position, &value))
+        return false;
+
+    switch (value)
+    {
+    case TileGrid::TileValue::Empty:
+    case TileGrid::TileValue::Food:
+    case TileGrid::TileValue::SuperFood:
+    case TileGrid::TileValue::Poison:
+        return true;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,679 @@
+#include "simulation/HamiltonianCycle.hpp"
+#include "Varint.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    const std::uint8_t CYCLE_MAGIC[4] = {'S', 'N', 'K', 'H'};
+    // Bump when the solver finds better cycles, older cache files are solved again
+    const std::uint8_t CYCLE_VERSION = 1;
+
+    const int MAX_MERGE_GAP = 3;
+    // The solver keeps four neighbours per tile, larger levels would need gigabytes
+    const int MAX_SOLVER_TILE_COUNT = 2048 * 2048;
+
+    const Simulation::PlayerInput ALL_INPUTS[] = {
+        Simulation::PlayerInput::Up, Simulation::PlayerInput::Down, Simulation::PlayerInput::Left, Simulation::PlayerInput::Right
+    };
+
+    Simulation::PlayerInput getOppositeInput(Simulation::PlayerInput input)
+    {
+        switch (input)
+        {
+        case Simulation::PlayerInput::Up:
+            return Simulation::PlayerInput::Down;
+        case Simulation::PlayerInput::Down:
+            return Simulation::PlayerInput::Up;
+        case Simulation::PlayerInput::Left:
+            return Simulation::PlayerInput::Right;
+        default:
+            return Simulation::PlayerInput::Left;
+        }
+    }
+
+    // Cycles over the tile graph as linked tiles, a tile belongs to at most one cycle
+    class CycleSolver
+    {
+    public:
+        using PlayerInput = Simulation::PlayerInput;
+
+        explicit CycleSolver(const std::vector<int>& neighbours)
+            :m_neighbours(neighbours),
+            m_nextTile(m_neighbours.size() / 4, -1),
+            m_previousTile(m_neighbours.size() / 4, -1),
+            m_nextInput(m_neighbours.size() / 4, PlayerInput::Up),
+            m_cycle(m_neighbours.size() / 4, -1)
+        {
+        }
+
+        // Loop over the step tile -> getNeighbour(tile, input) and the shortest way back.
+        // Used to start with a cycle through a teleporter, which extending and merging can't add later
+        bool startCycleThrough(int tile, PlayerInput input)
+        {
+            const int first = getNeighbour(tile, input);
+            if (first < 0 || first == tile)
+                return false;
+
+            std::vector<int> previousTile(m_nextTile.size(), -1);
+            std::vector<PlayerInput> previousInput(m_nextTile.size(), PlayerInput::Up);
+            std::vector<int> queue {first};
+            previousTile[first] = first;
+            for (std::size_t i = 0; i < queue.size() && previousTile[tile] < 0; ++i)
+            {
+                const int current = queue[i];
+                for (PlayerInput next : ALL_INPUTS)
+                {
+                    const int neighbour = getNeighbour(current, next);
+                    if (neighbour < 0 || previousTile[neighbour] >= 0 || (current == first && neighbour == tile))
+                        continue;
+
+                    previousTile[neighbour] = current;
+                    previousInput[neighbour] = next;
+                    queue.push_back(neighbour);
+                }
+            }
+            if (previousTile[tile] < 0)
+                return false;
+
+            for (int current = tile; current != first; current = previousTile[current])
+            {
+                m_cycle[current] = tile;
+                link(previousTile[current], current, previousInput[current]);
+            }
+            m_cycle[first] = tile;
+            link(tile, first, input);
+            return true;
+        }
+
+        // Puts a 2x2 loop on every free 2x2 area and extends each one as far as it goes
+        void buildCycles()
+        {
+            extendCycle();
+
+            const int tileCount = static_cast<int>(m_nextTile.size());
+            for (int tile = 0; tile < tileCount; ++tile)
+            {
+                if (m_nextTile[tile] < 0 && startCycle(tile))
+                    extendCycle();
+            }
+        }
+
+        // Joins two cycles where they run side by side, giving up at most one tile of each.
+        // Merged cycles are extended again since the given up tiles might fit in elsewhere
+        void mergeCycles()
+        {
+            const int tileCount = static_cast<int>(m_nextTile.size());
+            bool merged = true;
+            while (merged)
+            {
+                merged = false;
+                for (int tile = 0; tile < tileCount; ++tile)
+                {
+                    if (m_nextTile[tile] >= 0 && tryMerge(tile))
+                    {
+                        extendCycle();
+                        merged = true;
+                    }
+                }
+            }
+        }
+
+        // Tile of the longest cycle, -1 if there is no cycle
+        int getLongestCycleTile() const
+        {
+            std::vector<int> cycleSizes(m_nextTile.size(), 0);
+            int longestCycleTile = -1;
+            for (int tile = 0; tile < static_cast<int>(m_nextTile.size()); ++tile)
+            {
+                if (m_cycle[tile] < 0)
+                    continue;
+                if (++cycleSizes[m_cycle[tile]] > (longestCycleTile < 0 ? 0 : cycleSizes[m_cycle[longestCycleTile]]))
+                    longestCycleTile = tile;
+            }
+            return longestCycleTile;
+        }
+
+        std::vector<PlayerInput> getInputs(int startTile) const
+        {
+            std::vector<PlayerInput> inputs;
+            for (int tile = startTile; inputs.empty() || tile != startTile; tile = m_nextTile[tile])
+                inputs.push_back(m_nextInput[tile]);
+            return inputs;
+        }
+
+    private:
+        int getNeighbour(int tile, PlayerInput input) const
+        {
+            return m_neighbours[tile * 4 + static_cast<int>(input)];
+        }
+
+        std::optional<PlayerInput> getInputTo(int tile, int neighbour) const
+        {
+            for (PlayerInput input : ALL_INPUTS)
+            {
+                if (getNeighbour(tile, input) == neighbour)
+                    return input;
+            }
+            return std::nullopt;
+        }
+
+        void link(int tile, int nextTile, PlayerInput input)
+        {
+            m_nextTile[tile] = nextTile;
+            m_nextInput[tile] = input;
+            m_previousTile[nextTile] = tile;
+            m_pendingTiles.push_back(tile);
+        }
+
+        bool startCycle(int tile)
+        {
+            const int right = getNeighbour(tile, PlayerInput::Right);
+            const int down = getNeighbour(tile, PlayerInput::Down);
+            if (right < 0 || down < 0 || m_nextTile[right] >= 0 || m_nextTile[down] >= 0)
+                return false;
+            const int rightDown = getNeighbour(right, PlayerInput::Down);
+            if (rightDown < 0 || m_nextTile[rightDown] >= 0 || getNeighbour(rightDown, PlayerInput::Left) != down
+                || getNeighbour(down, PlayerInput::Up) != tile || rightDown == tile || right == down || rightDown == down)
+                return false;
+
+            m_cycle[tile] = m_cycle[right] = m_cycle[rightDown] = m_cycle[down] = tile;
+            link(tile, right, PlayerInput::Right);
+            link(right, rightDown, PlayerInput::Down);
+            link(rightDown, down, PlayerInput::Left);
+            link(down, tile, PlayerInput::Up);
+            return true;
+        }
+
+        // Replaces a step a -> b by a -> c -> d -> b where c and d are free neighbours on the same side.
+        // Tiles only join a cycle here, so a step that can't be extended now never can and is checked once
+        void extendCycle()
+        {
+            while (!m_pendingTiles.empty())
+            {
+                const int a = m_pendingTiles.back();
+                m_pendingTiles.pop_back();
+                const int b = m_nextTile[a];
+                if (b < 0)
+                    continue;
+                const PlayerInput forward = m_nextInput[a];
+
+                for (PlayerInput side : ALL_INPUTS)
+                {
+                    if (side == forward || side == getOppositeInput(forward))
+                        continue;
+
+                    const int c = getNeighbour(a, side);
+                    const int d = getNeighbour(b, side);
+                    if (c < 0 || d < 0 || c == d || m_nextTile[c] >= 0 || m_nextTile[d] >= 0
+                        || getNeighbour(c, forward) != d || getNeighbour(d, getOppositeInput(side)) != b)
+                        continue;
+
+                    m_cycle[c] = m_cycle[d] = m_cycle[a];
+                    link(d, b, getOppositeInput(side));
+                    link(c, d, forward);
+                    link(a, c, side);
+                    break;
+                }
+            }
+        }
+
+        // Looks for tiles p1 -> p2 of this cycle and q2 -> q1 of another cycle with edges p1 - q1 and q2 - p2,
+        // p2 and q1 may be one tile further along their cycle. The result runs p1 -> q1 ... q2 -> p2 ... p1
+        bool tryMerge(int p1)
+        {
+            for (PlayerInput toOther : ALL_INPUTS)
+            {
+                const int q1 = getNeighbour(p1, toOther);
+                if (q1 < 0 || m_cycle[q1] < 0 || m_cycle[q1] == m_cycle[p1])
+                    continue;
+
+                int p2 = p1;
+                for (int gap = 0; gap <= MAX_MERGE_GAP; ++gap)
+                {
+                    p2 = m_nextTile[p2];
+                    for (PlayerInput back : ALL_INPUTS)
+                    {
+                        const int q2 = getNeighbour(p2, back);
+                        if (q2 < 0 || q2 == q1 || m_cycle[q2] != m_cycle[q1])
+                            continue;
+
+                        bool isForward = false;
+                        bool isBackward = false;
+                        for (int forward = q2, backward = q2, step = 0; step <= MAX_MERGE_GAP; ++step)
+                        {
+                            forward = m_nextTile[forward];
+                            backward = m_previousTile[backward];
+                            isForward = isForward || forward == q1;
+                            isBackward = isBackward || backward == q1;
+                        }
+                        auto inputToOther = getInputTo(q2, p2);
+                        if ((!isForward && !isBackward) || !inputToOther)
+                            continue;
+
+                        if (!isForward)
+                            reverseCycle(q1);
+                        merge(p1, toOther, q1, q2, *inputToOther, p2);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void reverseCycle(int startTile)
+        {
+            std::vector<int> tiles;
+            for (int tile = startTile; tiles.empty() || tile != startTile; tile = m_nextTile[tile])
+                tiles.push_back(tile);
+
+            // Every edge can be walked both ways, teleporters included
+            std::vector<PlayerInput> inputs(tiles.size());
+            for (std::size_t i = 0; i < tiles.size(); ++i)
+                inputs[(i + 1) % tiles.size()] = getOppositeInput(m_nextInput[tiles[i]]);
+
+            for (std::size_t i = 0; i < tiles.size(); ++i)
+            {
+                std::swap(m_nextTile[tiles[i]], m_previousTile[tiles[i]]);
+                m_nextInput[tiles[i]] = inputs[i];
+            }
+        }
+
+        void merge(int p1, PlayerInput toOther, int q1, int q2, PlayerInput back, int p2)
+        {
+            // Give up the tiles skipped between p1 and p2 and between q2 and q1
+            for (int tile = m_nextTile[p1]; tile != p2; )
+                tile = unlink(tile);
+            for (int tile = m_nextTile[q2]; tile != q1; )
+                tile = unlink(tile);
+
+            const int otherCycle = m_cycle[q1];
+            for (int tile = q1; m_cycle[tile] == otherCycle; tile = m_nextTile[tile])
+            {
+                m_cycle[tile] = m_cycle[p1];
+                m_pendingTiles.push_back(tile);
+                if (tile == q2)
+                    break;
+            }
+
+            link(p1, q1, toOther);
+            link(q2, p2, back);
+            for (int tile = p2; tile != p1; tile = m_nextTile[tile])
+                m_pendingTiles.push_back(tile);
+        }
+
+        int unlink(int tile)
+        {
+            const int nextTile = m_nextTile[tile];
+            m_nextTile[tile] = -1;
+            m_previousTile[tile] = -1;
+            m_cycle[tile] = -1;
+            return nextTile;
+        }
+
+        const std::vector<int>& m_neighbours; // 4 per tile, -1 where a move leaves the playable tiles
+        std::vector<int> m_nextTile;
+        std::vector<int> m_previousTile;
+        std::vector<PlayerInput> m_nextInput;
+        std::vector<int> m_cycle; // Any tile of the cycle as its id, -1 if not on a cycle
+        std::vector<int> m_pendingTiles; // Tiles whose next step might still be extended
+    };
+}
+
+bool HamiltonianCycle::solve(const LevelData& level)
+{
+    *this = HamiltonianCycle();
+
+    if (static_cast<long long>(level.width) * level.height > MAX_SOLVER_TILE_COUNT)
+    {
+        cerr << "HamiltonianCycle::solve(): levels of " << level.width << "x" << level.height << " tiles are too large!" << endl;
+        return false;
+    }
+
+    TileGrid grid;
+    if (!grid.loadFromArray(level.gridData, level.width, level.height))
+    {
+        cerr << "HamiltonianCycle::solve(): invalid level data!" << endl;
+        return false;
+    }
+
+    const int width = level.width;
+    const int tileCount = level.width * level.height;
+
+    // Every edge of the tile graph with teleporters resolved
+    std::vector<int> neighbours(static_cast<std::size_t>(tileCount) * 4, -1);
+    std::vector<std::pair<int, PlayerInput>> teleporterSteps;
+    for (int tile = 0; tile < tileCount; ++tile)
+    {
+        const sf::Vector2i position(tile % width, tile / width);
+        if (!isPlayable(grid, position))
+            continue;
+
+        ++m_playableTileCount;
+        for (PlayerInput input : ALL_INPUTS)
+        {
+            auto neighbour = getNeighbour(grid, position, input);
+            if (!neighbour || !isPlayable(grid, *neighbour))
+                continue;
+
+            const int neighbourTile = neighbour->x + neighbour->y * width;
+            neighbours[tile * 4 + static_cast<int>(input)] = neighbourTile;
+            if (std::abs(neighbourTile - tile) != 1 && std::abs(neighbourTile - tile) != width)
+                teleporterSteps.emplace_back(tile, input);
+        }
+    }
+
+    // Areas only joined by a narrow passage get their own cycles, which are merged afterwards.
+    // Merging can't cross a teleporter though, so the solver also runs once starting with a cycle
+    // through each teleporter step, the longest cycle of all runs wins
+    int startTile = -1;
+    std::vector<PlayerInput> inputs;
+    for (std::size_t run = 0; run <= teleporterSteps.size(); ++run)
+    {
+        CycleSolver solver(neighbours);
+        if (run > 0 && !solver.startCycleThrough(teleporterSteps[run - 1].first, teleporterSteps[run - 1].second))
+            continue;
+        solver.buildCycles();
+        solver.mergeCycles();
+
+        const int tile = solver.getLongestCycleTile();
+        if (tile < 0)
+            continue;
+        std::vector<PlayerInput> runInputs = solver.getInputs(tile);
+        if (runInputs.size() > inputs.size())
+        {
+            startTile = tile;
+            inputs = std::move(runInputs);
+        }
+    }
+
+    if (startTile < 0)
+    {
+        cerr << "HamiltonianCycle::solve(): the level has no 2x2 area to start a cycle in!" << endl;
+        return false;
+    }
+
+    const int playableTileCount = m_playableTileCount;
+    if (!buildFromInputs(grid, startTile, inputs))
+    {
+        cerr << "HamiltonianCycle::solve(): the solver built an invalid cycle!" << endl;
+        *this = HamiltonianCycle();
+        return false;
+    }
+    m_levelHash = computeLevelHash(level);
+    m_playableTileCount = playableTileCount;
+    return true;
+}
+
+bool HamiltonianCycle::loadOrSolve(const LevelData& level, const std::string& cacheDirectory)
+{
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%016llx.cycle", static_cast<unsigned long long>(computeLevelHash(level)));
+    const std::string path = cacheDirectory + "/" + fileName;
+
+    std::error_code error;
+    if (std::filesystem::exists(path, error) && loadFromFile(path, level))
+        return true;
+
+    if (!solve(level))
+        return false;
+
+    // A cycle that can't be cached is still usable
+    std::filesystem::create_directories(cacheDirectory, error);
+    saveToFile(path);
+    return true;
+}
+
+bool HamiltonianCycle::loadFromFile(const std::string& path, const LevelData& level)
+{
+    *this = HamiltonianCycle();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        cerr << "HamiltonianCycle::loadFromFile(): error opening " << path << endl;
+        return false;
+    }
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < 13 || !std::equal(std::begin(CYCLE_MAGIC), std::end(CYCLE_MAGIC), data.begin()) || data[4] != CYCLE_VERSION)
+    {
+        cerr << "HamiltonianCycle::loadFromFile(): " << path << " is no cycle of version " << static_cast<int>(CYCLE_VERSION) << endl;
+        return false;
+    }
+
+    std::uint64_t levelHash = 0;
+    for (int i = 0; i < 8; ++i)
+        levelHash |= static_cast<std::uint64_t>(data[5 + i]) << (i * 8);
+    if (levelHash != computeLevelHash(level))
+    {
+        cerr << "HamiltonianCycle::loadFromFile(): " << path << " belongs to another level" << endl;
+        return false;
+    }
+
+    std::size_t position = 13;
+    std::uint64_t startTile, length, playableTileCount;
+    if (!readVarint(data, &position, &startTile) || !readVarint(data, &position, &length)
+        || !readVarint(data, &position, &playableTileCount))
+    {
+        cerr << "HamiltonianCycle::loadFromFile(): " << path << " is truncated" << endl;
+        return false;
+    }
+
+    const std::uint64_t tileCount = static_cast<std::uint64_t>(level.width) * level.height;
+    if (startTile >= tileCount || length > tileCount)
+    {
+        cerr << "HamiltonianCycle::loadFromFile(): " << path << " is corrupt" << endl;
+        return false;
+    }
+
+    std::vector<PlayerInput> inputs;
+    inputs.reserve(static_cast<std::size_t>(length));
+    while (inputs.size() < length)
+    {
+        std::uint64_t run;
+        if (!readVarint(data, &position, &run) || (run >> 2) == 0 || (run >> 2) > length - inputs.size())
+        {
+            cerr << "HamiltonianCycle::loadFromFile(): " << path << " is corrupt" << endl;
+            return false;
+        }
+        inputs.insert(inputs.end(), static_cast<std::size_t>(run >> 2), static_cast<PlayerInput>(run & 3));
+    }
+
+    // The cycle is walked on the level again, so a damaged file can't produce a path through walls
+    TileGrid grid;
+    if (!grid.loadFromArray(level.gridData, level.width, level.height)
+        || !buildFromInputs(grid, static_cast<int>(startTile), inputs))
+    {
+        cerr << "HamiltonianCycle::loadFromFile(): " << path << " is no cycle on this level" << endl;
+        return false;
+    }
+    m_levelHash = levelHash;
+    m_playableTileCount = static_cast<int>(playableTileCount);
+    return true;
+}
+
+bool HamiltonianCycle::saveToFile(const std::string& path) const
+{
+    std::vector<std::uint8_t> data(std::begin(CYCLE_MAGIC), std::end(CYCLE_MAGIC));
+    data.push_back(CYCLE_VERSION);
+    for (int i = 0; i < 8; ++i)
+        data.push_back(static_cast<std::uint8_t>(m_levelHash >> (i * 8)));
+
+    writeVarint(m_tiles.empty() ? 0 : static_cast<std::uint64_t>(m_tiles[0]), &data);
+    writeVarint(m_inputs.size(), &data);
+    writeVarint(static_cast<std::uint64_t>(m_playableTileCount), &data);
+
+    // Same run encoding as replays, cycles mostly go straight for a while
+    std::size_t runBegin = 0;
+    while (runBegin < m_inputs.size())
+    {
+        std::size_t runEnd = runBegin + 1;
+        while (runEnd < m_inputs.size() && m_inputs[runEnd] == m_inputs[runBegin])
+            ++runEnd;
+
+        writeVarint((static_cast<std::uint64_t>(runEnd - runBegin) << 2) | static_cast<std::uint64_t>(m_inputs[runBegin]), &data);
+        runBegin = runEnd;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+    {
+        cerr << "HamiltonianCycle::saveToFile(): error writing " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool HamiltonianCycle::isEmpty() const
+{
+    return m_tiles.empty();
+}
+
+int HamiltonianCycle::getLength() const
+{
+    return static_cast<int>(m_tiles.size());
+}
+
+int HamiltonianCycle::getPlayableTileCount() const
+{
+    return m_playableTileCount;
+}
+
+int HamiltonianCycle::getWidth() const
+{
+    return m_width;
+}
+
+std::optional<int> HamiltonianCycle::getOrder(sf::Vector2i position) const
+{
+    if (position.x < 0 || position.y < 0 || position.x >= m_width || position.y >= m_height)
+        return std::nullopt;
+
+    const int order = m_orderOfTile[position.x + position.y * m_width];
+    if (order < 0)
+        return std::nullopt;
+    return order;
+}
+
+sf::Vector2i HamiltonianCycle::getPosition(int order) const
+{
+    const int tile = m_tiles[order % m_tiles.size()];
+    return sf::Vector2i(tile % m_width, tile / m_width);
+}
+
+HamiltonianCycle::PlayerInput HamiltonianCycle::getInput(int order) const
+{
+    return m_inputs[order % m_inputs.size()];
+}
+
+std::optional<sf::Vector2i> HamiltonianCycle::getNeighbour(const TileGrid& grid, sf::Vector2i position, PlayerInput input)
+{
+    sf::Vector2i direction;
+    switch (input)
+    {
+    case PlayerInput::Up:
+        direction.y = -1;
+        break;
+    case PlayerInput::Down:
+        direction.y = 1;
+        break;
+    case PlayerInput::Left:
+        direction.x = -1;
+        break;
+    case PlayerInput::Right:
+        direction.x = 1;
+        break;
+    }
+
+    sf::Vector2i next = position + direction;
+    TileGrid::TileValue value;
+    if (!grid.getTileValueAt(next, &value))
+        return std::nullopt;
+
+    // Same as Simulation::moveSnake(), the head comes out one tile behind the partner teleporter
+    std::optional<sf::Vector2i> partner;
+    if (value == TileGrid::TileValue::Teleport1)
+        partner = grid.getPositionOfOtherTeleporter1(next);
+    else if (value == TileGrid::TileValue::Teleport2)
+        partner = grid.getPositionOfOtherTeleporter2(next);
+
+    if (partner)
+    {
+        next = *partner + direction;
+        if (!grid.isValidPosition(next))
+            return std::nullopt;
+    }
+    return next;
+}
+
+bool HamiltonianCycle::buildFromInputs(const TileGrid& grid, int startTile, const std::vector<PlayerInput>& inputs)
+{
+    m_width = grid.getWidth();
+    m_height = grid.getHeight();
+    m_orderOfTile.assign(static_cast<std::size_t>(m_width) * m_height, -1);
+    m_tiles.clear();
+    m_tiles.reserve(inputs.size());
+    m_inputs = inputs;
+
+    sf::Vector2i position(startTile % m_width, startTile / m_width);
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        const int tile = position.x + position.y * m_width;
+        if (!isPlayable(grid, position) || m_orderOfTile[tile] >= 0)
+            return false;
+
+        m_orderOfTile[tile] = static_cast<int>(i);
+        m_tiles.push_back(tile);
+
+        auto next = getNeighbour(grid, position, inputs[i]);
+        if (!next)
+            return false;
+        position = *next;
+    }
+
+    // The last input has to lead back to the start
+    return !inputs.empty() && position.x + position.y * m_width == startTile;
+}
+
+bool HamiltonianCycle::isPlayable(const TileGrid& grid, sf::Vector2i position)
+{
+    TileGrid::TileValue value;
+    if (!grid.getTileValueAt(position, &value))
+        return false;
+
+    switch (value)
+    {
+    case TileGrid::TileValue::Wall:
+    case TileGrid::TileValue::NoPlayArea:
+        return false;
+    // The head never stays on a teleporter that has a partner
+    case TileGrid::TileValue::Teleport1:
+        return !grid.getPositionOfOtherTeleporter1(position);
+    case TileGrid::TileValue::Teleport2:
+        return !grid.getPositionOfOtherTeleporter2(position);
+    default:
+        return true;
+    }
+}
+
+std::uint64_t computeLevelHash(const LevelData& level)
+{
+    // FNV-1a
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    hash = (hash ^ static_cast<std::uint64_t>(level.width)) * prime;
+    hash = (hash ^ static_cast<std::uint64_t>(level.height)) * prime;
+    for (int tileValue : level.gridData)
+        hash = (hash ^ static_cast<std::uint64_t>(tileValue)) * prime;
+    return hash;
+}
@@ -0,0 +1,289 @@
+#include "simulation/LevelPack.hpp"
+#include "Varint.hpp"
+#include "simulation/TileGrid.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    const std::uint8_t LEVEL_PACK_MAGIC[4] = {'S', 'N', 'K', 'L'};
+    const std::uint8_t LEVEL_PACK_VERSION = 1;
+    const std::size_t LEVEL_PACK_HEADER_SIZE = 12;
+    const std::size_t LEVEL_INDEX_ENTRY_SIZE = 8;
+    const std::size_t LEVEL_RECORD_HEADER_SIZE = 17;
+
+    // Limits against corrupt files
+    const int MAX_LEVEL_SIZE = 16384;
+    const std::uint32_t MAX_LEVEL_COUNT = 1 << 20;
+
+    enum class TileEncoding : std::uint8_t
+    {
+        Raw, RunLength
+    };
+
+    void writeUInt16(std::uint16_t value, std::vector<std::uint8_t>* data)
+    {
+        data->push_back(static_cast<std::uint8_t>(value));
+        data->push_back(static_cast<std::uint8_t>(value >> 8));
+    }
+
+    void writeUInt32(std::uint32_t value, std::vector<std::uint8_t>* data)
+    {
+        for (int i = 0; i < 4; ++i)
+            data->push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+    }
+
+    std::uint16_t readUInt16(const std::uint8_t* data)
+    {
+        return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    std::uint32_t readUInt32(const std::uint8_t* data)
+    {
+        return static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8)
+            | (static_cast<std::uint32_t>(data[2]) << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+    }
+
+    bool isTeleporter(int tileValue)
+    {
+        return tileValue == static_cast<int>(TileGrid::TileValue::Teleport1)
+            || tileValue == static_cast<int>(TileGrid::TileValue::Teleport2);
+    }
+}
+
+bool LevelPack::open(const std::string& path)
+{
+    close();
+
+    m_file.open(path, std::ios::binary);
+    if (!m_file)
+    {
+        cerr << "LevelPack::open(): could not open " << path << "!" << endl;
+        return false;
+    }
+
+    std::uint8_t header[LEVEL_PACK_HEADER_SIZE];
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header))
+        || !std::equal(std::begin(LEVEL_PACK_MAGIC), std::end(LEVEL_PACK_MAGIC), header)
+        || header[4] != LEVEL_PACK_VERSION)
+    {
+        cerr << "LevelPack::open(): " << path << " is no level pack of version " << static_cast<int>(LEVEL_PACK_VERSION) << "!" << endl;
+        close();
+        return false;
+    }
+
+    const std::uint32_t levelCount = readUInt32(header + 8);
+    if (levelCount > MAX_LEVEL_COUNT)
+    {
+        cerr << "LevelPack::open(): " << path << " claims to hold " << levelCount << " levels!" << endl;
+        close();
+        return false;
+    }
+
+    std::vector<std::uint8_t> index(levelCount * LEVEL_INDEX_ENTRY_SIZE);
+    if (!m_file.read(reinterpret_cast<char*>(index.data()), index.size()))
+    {
+        cerr << "LevelPack::open(): the level index of " << path << " is truncated!" << endl;
+        close();
+        return false;
+    }
+
+    m_index.resize(levelCount);
+    for (std::uint32_t i = 0; i < levelCount; ++i)
+    {
+        m_index[i].offset = readUInt32(&index[i * LEVEL_INDEX_ENTRY_SIZE]);
+        m_index[i].size = readUInt32(&index[i * LEVEL_INDEX_ENTRY_SIZE + 4]);
+    }
+    return true;
+}
+
+void LevelPack::close()
+{
+    if (m_file.is_open())
+        m_file.close();
+    m_file.clear();
+    m_index.clear();
+}
+
+bool LevelPack::isOpen() const
+{
+    return m_file.is_open();
+}
+
+int LevelPack::getLevelCount() const
+{
+    return static_cast<int>(m_index.size());
+}
+
+bool LevelPack::loadLevel(int levelIndex, LevelData* level)
+{
+    if (levelIndex < 0 || levelIndex >= getLevelCount())
+    {
+        cerr << "LevelPack::loadLevel(): " << levelIndex << " is no valid level!" << endl;
+        return false;
+    }
+
+    const IndexEntry& entry = m_index[levelIndex];
+    m_record.resize(entry.size);
+    m_file.clear();
+    if (!m_file.seekg(entry.offset) || !m_file.read(reinterpret_cast<char*>(m_record.data()), m_record.size()))
+    {
+        cerr << "LevelPack::loadLevel(): could not read level " << levelIndex << "!" << endl;
+        return false;
+    }
+
+    if (!decodeLevel(m_record.data(), m_record.size(), level))
+    {
+        cerr << "LevelPack::loadLevel(): level " << levelIndex << " is corrupt!" << endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::uint8_t> encodeLevel(const LevelData& level)
+{
+    std::vector<std::uint8_t> data;
+    writeUInt16(static_cast<std::uint16_t>(level.width), &data);
+    writeUInt16(static_cast<std::uint16_t>(level.height), &data);
+    writeUInt16(static_cast<std::uint16_t>(level.tileSize.x), &data);
+    writeUInt16(static_cast<std::uint16_t>(level.tileSize.y), &data);
+    writeUInt16(static_cast<std::uint16_t>(level.startPosition.x), &data);
+    writeUInt16(static_cast<std::uint16_t>(level.startPosition.y), &data);
+    data.push_back(static_cast<std::uint8_t>(level.startLength));
+
+    // Teleporters go into the header, the tiles below them are stored as empty
+    std::vector<std::uint8_t> teleporters;
+    std::uint8_t teleporterCount = 0;
+    std::vector<std::uint8_t> raw(level.gridData.size());
+    for (std::size_t i = 0; i < level.gridData.size(); ++i)
+    {
+        if (isTeleporter(level.gridData[i]) && teleporterCount < 255)
+        {
+            teleporters.push_back(static_cast<std::uint8_t>(level.gridData[i]));
+            writeUInt16(static_cast<std::uint16_t>(i % level.width), &teleporters);
+            writeUInt16(static_cast<std::uint16_t>(i / level.width), &teleporters);
+            ++teleporterCount;
+            raw[i] = static_cast<std::uint8_t>(TileGrid::TileValue::Empty);
+        }
+        else
+            raw[i] = static_cast<std::uint8_t>(level.gridData[i]);
+    }
+
+    // Walls and empty areas come in long runs, small or noisy levels are smaller raw
+    std::vector<std::uint8_t> runs;
+    std::size_t runBegin = 0;
+    while (runBegin < raw.size())
+    {
+        std::size_t runEnd = runBegin + 1;
+        while (runEnd < raw.size() && raw[runEnd] == raw[runBegin])
+            ++runEnd;
+
+        runs.push_back(raw[runBegin]);
+        writeVarint(runEnd - runBegin, &runs);
+        runBegin = runEnd;
+    }
+
+    const bool useRuns = runs.size() < raw.size();
+    data.push_back(static_cast<std::uint8_t>(useRuns ? TileEncoding::RunLength : TileEncoding::Raw));
+    writeUInt16(static_cast<std::uint16_t>(level.maxFood), &data);
+    data.push_back(teleporterCount);
+    data.insert(data.end(), teleporters.begin(), teleporters.end());
+
+    const std::vector<std::uint8_t>& tiles = useRuns ? runs : raw;
+    data.insert(data.end(), tiles.begin(), tiles.end());
+    return data;
+}
+
+bool decodeLevel(const std::uint8_t* data, std::size_t size, LevelData* level)
+{
+    if (size < LEVEL_RECORD_HEADER_SIZE)
+        return false;
+
+    LevelData decoded;
+    decoded.width = readUInt16(data);
+    decoded.height = readUInt16(data + 2);
+    decoded.tileSize = sf::Vector2u(readUInt16(data + 4), readUInt16(data + 6));
+    decoded.startPosition = sf::Vector2i(readUInt16(data + 8), readUInt16(data + 10));
+    decoded.startLength = data[12];
+    const TileEncoding encoding = static_cast<TileEncoding>(data[13]);
+    decoded.maxFood = readUInt16(data + 14);
+    const std::size_t teleporterCount = data[16];
+
+    if (decoded.width <= 0 || decoded.height <= 0 || decoded.width > MAX_LEVEL_SIZE || decoded.height > MAX_LEVEL_SIZE)
+        return false;
+
+    const std::size_t tileCount = static_cast<std::size_t>(decoded.width) * decoded.height;
+    std::size_t position = LEVEL_RECORD_HEADER_SIZE + teleporterCount * 5;
+    if (position > size)
+        return false;
+
+    decoded.gridData.reserve(tileCount);
+    if (encoding == TileEncoding::Raw)
+    {
+        if (size - position != tileCount)
+            return false;
+        decoded.gridData.assign(data + position, data + size);
+    }
+    else if (encoding == TileEncoding::RunLength)
+    {
+        while (position < size)
+        {
+            const int tileValue = data[position++];
+            std::uint64_t runLength;
+            if (!readVarint(data, size, &position, &runLength) || runLength == 0 || runLength > tileCount - decoded.gridData.size())
+                return false;
+            decoded.gridData.insert(decoded.gridData.end(), static_cast<std::size_t>(runLength), tileValue);
+        }
+        if (decoded.gridData.size() != tileCount)
+            return false;
+    }
+    else
+        return false;
+
+    for (std::size_t i = 0; i < teleporterCount; ++i)
+    {
+        const std::uint8_t* teleporter = data + LEVEL_RECORD_HEADER_SIZE + i * 5;
+        const int x = readUInt16(teleporter + 1);
+        const int y = readUInt16(teleporter + 3);
+        if (!isTeleporter(teleporter[0]) || x >= decoded.width || y >= decoded.height)
+            return false;
+        decoded.gridData[y * decoded.width + x] = teleporter[0];
+    }
+
+    *level = std::move(decoded);
+    return true;
+}
+
+bool saveLevelPack(const std::vector<LevelData>& levels, const std::string& path)
+{
+    std::vector<std::uint8_t> data(std::begin(LEVEL_PACK_MAGIC), std::end(LEVEL_PACK_MAGIC));
+    data.push_back(LEVEL_PACK_VERSION);
+    data.insert(data.end(), 3, 0);
+    writeUInt32(static_cast<std::uint32_t>(levels.size()), &data);
+
+    std::vector<std::vector<std::uint8_t>> records;
+    records.reserve(levels.size());
+    std::size_t offset = LEVEL_PACK_HEADER_SIZE + levels.size() * LEVEL_INDEX_ENTRY_SIZE;
+    for (const LevelData& level : levels)
+    {
+        records.push_back(encodeLevel(level));
+        writeUInt32(static_cast<std::uint32_t>(offset), &data);
+        writeUInt32(static_cast<std::uint32_t>(records.back().size()), &data);
+        offset += records.back().size();
+    }
+
+    for (const std::vector<std::uint8_t>& record : records)
+        data.insert(data.end(), record.begin(), record.end());
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file || !file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+    {
+        cerr << "saveLevelPack(): could not write " << path << "!" << endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,447 @@
+#include "simulation/Lockstep.hpp"
+#include "Varint.hpp"
+#include <algorithm>
+#include <iostream>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    const std::uint8_t LOCKSTEP_MAGIC[2] = {'S', 'L'};
+
+    enum class MessageType : std::uint8_t
+    {
+        Join = 1,    // Client -> server, repeated until the welcome arrives
+        Welcome,     // Server -> client: player index and settings, repeated until the first inputs arrive
+        Inputs,      // Client -> server: ticks received so far and the own inputs that are not confirmed
+        Ticks        // Server -> client: inputs of all players for the ticks the client doesn't have
+    };
+
+    // Input value of a player that keeps the direction, used before the first input and for timeouts
+    const std::uint8_t NO_INPUT = 4;
+    // Server side placeholder for inputs that haven't arrived
+    const std::uint8_t MISSING_INPUT = 0xFF;
+
+    const std::chrono::microseconds JOIN_INTERVAL {100000};
+    const std::chrono::microseconds RESEND_INTERVAL {50000};
+    // Ticks per datagram, a client that fell further behind gets the rest with the next ones
+    const int MAX_TICKS_PER_DATAGRAM = 64;
+
+    bool readInt(const std::vector<std::uint8_t>& data, std::size_t* position, int maximum, int* value)
+    {
+        std::uint64_t varint = 0;
+        if (!readVarint(data, position, &varint) || varint > static_cast<std::uint64_t>(maximum))
+            return false;
+        *value = static_cast<int>(varint);
+        return true;
+    }
+
+    void beginMessage(MessageType type, std::vector<std::uint8_t>* data)
+    {
+        data->assign(std::begin(LOCKSTEP_MAGIC), std::end(LOCKSTEP_MAGIC));
+        data->push_back(static_cast<std::uint8_t>(type));
+    }
+
+    bool readMessageType(const std::vector<std::uint8_t>& data, std::size_t* position, MessageType* type)
+    {
+        if (data.size() < 3 || data[0] != LOCKSTEP_MAGIC[0] || data[1] != LOCKSTEP_MAGIC[1])
+            return false;
+        *type = static_cast<MessageType>(data[2]);
+        *position = 3;
+        return true;
+    }
+}
+
+bool LockstepServer::start(NetTransport* transport, const LockstepSettings& settings)
+{
+    if (!transport || settings.playerCount < 1 || settings.inputDelay < 1 || settings.inputDelay > 0xFFFF)
+    {
+        cerr << "LockstepServer::start(): invalid settings!" << endl;
+        return false;
+    }
+
+    m_transport = transport;
+    m_settings = settings;
+    m_players.clear();
+    m_isRunning = false;
+
+    // Nobody can send inputs for the first ticks in time, they are known before anyone joins
+    m_inputs.assign(static_cast<std::size_t>(settings.inputDelay) * settings.playerCount, NO_INPUT);
+    m_firstStoredTick = 0;
+    m_tickCount = settings.inputDelay;
+    m_isWaitingForInputs = false;
+    m_timedOutInputCount = 0;
+    return true;
+}
+
+void LockstepServer::update(std::chrono::microseconds now)
+{
+    if (!m_transport)
+        return;
+
+    receive(now);
+    if (!m_isRunning)
+        return;
+
+    closeTicks(now);
+
+    // Lost welcomes are repeated until the player answers, lost ticks when the player asks for them again
+    for (int i = 0; i < static_cast<int>(m_players.size()); ++i)
+    {
+        Player& player = m_players[i];
+        if (!player.hasSentInputs && now - player.lastSendTime >= RESEND_INTERVAL)
+        {
+            sendWelcome(i);
+            player.lastSendTime = now;
+        }
+    }
+
+    // Forget the ticks every player has
+    int oldestNeededTick = m_tickCount;
+    for (const Player& player : m_players)
+        oldestNeededTick = std::min(oldestNeededTick, player.receivedTickCount);
+    const int droppableTicks = oldestNeededTick - m_firstStoredTick;
+    if (droppableTicks >= 1024)
+    {
+        m_inputs.erase(m_inputs.begin(), m_inputs.begin() + static_cast<std::size_t>(droppableTicks) * m_settings.playerCount);
+        m_firstStoredTick = oldestNeededTick;
+    }
+}
+
+bool LockstepServer::isRunning() const
+{
+    return m_isRunning;
+}
+
+int LockstepServer::getJoinedPlayerCount() const
+{
+    return static_cast<int>(m_players.size());
+}
+
+int LockstepServer::getTickCount() const
+{
+    return m_tickCount;
+}
+
+long long LockstepServer::getTimedOutInputCount() const
+{
+    return m_timedOutInputCount;
+}
+
+void LockstepServer::receive(std::chrono::microseconds now)
+{
+    NetEndpoint from;
+    while (m_transport->receive(&from, &m_datagram))
+    {
+        std::size_t position = 0;
+        MessageType type;
+        if (!readMessageType(m_datagram, &position, &type))
+            continue;
+
+        auto player = std::find_if(m_players.begin(), m_players.end(), [&](const Player& p) { return p.endpoint == from; });
+        const int playerIndex = player == m_players.end() ? -1 : static_cast<int>(player - m_players.begin());
+
+        if (type == MessageType::Join)
+        {
+            // Players get their index in the order they join, a repeated join just gets the welcome again
+            if (playerIndex < 0 && static_cast<int>(m_players.size()) < m_settings.playerCount)
+            {
+                Player newPlayer;
+                newPlayer.endpoint = from;
+                m_players.push_back(newPlayer);
+                if (static_cast<int>(m_players.size()) == m_settings.playerCount)
+                {
+                    m_isRunning = true;
+                    for (int i = 0; i < m_settings.playerCount; ++i)
+                    {
+                        sendWelcome(i);
+                        m_players[i].lastSendTime = now;
+                    }
+                }
+            }
+            else if (playerIndex >= 0 && m_isRunning)
+                sendWelcome(playerIndex);
+        }
+        else if (type == MessageType::Inputs && playerIndex >= 0 && m_isRunning)
+        {
+            int sentIndex = 0;
+            int receivedTickCount = 0;
+            int firstTick = 0;
+            int count = 0;
+            // A client can't be further ahead than the input delay, anything else would grow m_inputs without bound
+            const int lastFirstTick = m_tickCount + m_settings.inputDelay + MAX_TICKS_PER_DATAGRAM;
+            if (!readInt(m_datagram, &position, m_settings.playerCount - 1, &sentIndex) || sentIndex != playerIndex
+                || !readInt(m_datagram, &position, m_tickCount, &receivedTickCount)
+                || !readInt(m_datagram, &position, lastFirstTick, &firstTick) || firstTick < m_firstStoredTick
+                || !readInt(m_datagram, &position, MAX_TICKS_PER_DATAGRAM, &count)
+                || m_datagram.size() - position != static_cast<std::size_t>(count))
+                continue;
+
+            Player& sender = m_players[playerIndex];
+            const bool isFirstInputs = !sender.hasSentInputs;
+            sender.hasSentInputs = true;
+            sender.receivedTickCount = std::max(sender.receivedTickCount, receivedTickCount);
+
+            // Inputs for ticks that were already sent came too late and are dropped
+            for (int i = 0; i < count; ++i)
+            {
+                const int tick = firstTick + i;
+                const std::uint8_t input = m_datagram[position + i];
+                if (tick >= m_tickCount && input <= NO_INPUT)
+                    getInput(tick, playerIndex) = input;
+            }
+
+            // The first inputs ask for the ticks before the first own input, later ones are only behind
+            // if ticks got lost or are still on the way, so they are answered at most every RESEND_INTERVAL
+            if (isFirstInputs || (sender.receivedTickCount < m_tickCount && now - sender.lastSendTime >= RESEND_INTERVAL))
+                sendTicks(playerIndex, now);
+        }
+    }
+}
+
+void LockstepServer::closeTicks(std::chrono::microseconds now)
+{
+    const int playerCount = m_settings.playerCount;
+    for (;;)
+    {
+        int missingCount = 0;
+        for (int i = 0; i < playerCount; ++i)
+            if (getInput(m_tickCount, i) == MISSING_INPUT)
+                ++missingCount;
+
+        if (missingCount == playerCount)
+            return;
+
+        // Wait for the others once the first input for the tick is there, but not forever
+        if (missingCount > 0)
+        {
+            if (!m_isWaitingForInputs)
+            {
+                m_isWaitingForInputs = true;
+                m_waitingSince = now;
+            }
+            if (now - m_waitingSince < m_settings.inputTimeout)
+                return;
+
+            for (int i = 0; i < playerCount; ++i)
+                if (getInput(m_tickCount, i) == MISSING_INPUT)
+                    getInput(m_tickCount, i) = NO_INPUT;
+            m_timedOutInputCount += missingCount;
+        }
+
+        m_isWaitingForInputs = false;
+        ++m_tickCount;
+
+        // One datagram per player for every completed tick, it also repeats what they are missing
+        for (int i = 0; i < playerCount; ++i)
+            sendTicks(i, now);
+    }
+}
+
+void LockstepServer::sendWelcome(int playerIndex)
+{
+    beginMessage(MessageType::Welcome, &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(playerIndex), &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(m_settings.playerCount), &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(m_settings.aiSnakeCount), &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(m_settings.levelIndex), &m_datagram);
+    writeVarint(m_settings.seed, &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(m_settings.inputDelay), &m_datagram);
+    m_transport->send(m_players[playerIndex].endpoint, m_datagram);
+}
+
+void LockstepServer::sendTicks(int playerIndex, std::chrono::microseconds now)
+{
+    Player& player = m_players[playerIndex];
+    const int firstTick = std::max(player.receivedTickCount, m_firstStoredTick);
+    const int count = std::min(m_tickCount - firstTick, MAX_TICKS_PER_DATAGRAM);
+    if (count <= 0)
+        return;
+
+    beginMessage(MessageType::Ticks, &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(firstTick), &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(count), &m_datagram);
+    const std::size_t begin = static_cast<std::size_t>(firstTick - m_firstStoredTick) * m_settings.playerCount;
+    m_datagram.insert(m_datagram.end(), m_inputs.begin() + begin, m_inputs.begin() + begin + static_cast<std::size_t>(count) * m_settings.playerCount);
+
+    m_transport->send(player.endpoint, m_datagram);
+    player.lastSendTime = now;
+}
+
+std::uint8_t& LockstepServer::getInput(int tick, int playerIndex)
+{
+    const std::size_t index = static_cast<std::size_t>(tick - m_firstStoredTick) * m_settings.playerCount + playerIndex;
+    if (index >= m_inputs.size())
+        m_inputs.resize((index / m_settings.playerCount + 1) * m_settings.playerCount, MISSING_INPUT);
+    return m_inputs[index];
+}
+
+bool LockstepClient::connect(NetTransport* transport, const NetEndpoint& server)
+{
+    if (!transport)
+        return false;
+
+    m_transport = transport;
+    m_server = server;
+    m_isStarted = false;
+    m_playerIndex = -1;
+    m_hasSent = false;
+    m_tickInputs.clear();
+    m_tick = 0;
+    m_receivedTickCount = 0;
+    m_localInputs.clear();
+    m_firstLocalTick = 0;
+    return true;
+}
+
+void LockstepClient::update(std::chrono::microseconds now)
+{
+    if (!m_transport)
+        return;
+
+    receive();
+
+    if (!m_isStarted)
+    {
+        if (!m_hasSent || now - m_lastSendTime >= JOIN_INTERVAL)
+        {
+            beginMessage(MessageType::Join, &m_datagram);
+            m_transport->send(m_server, m_datagram);
+            m_lastSendTime = now;
+            m_hasSent = true;
+        }
+    }
+    // Inputs go out with every tick. Without the inputs for the next tick some datagram got lost,
+    // either own inputs or the server's ticks, and the inputs are sent again as a reminder
+    else if (!m_hasSent || (m_tick >= m_receivedTickCount && now - m_lastSendTime >= RESEND_INTERVAL))
+        sendInputs(now);
+}
+
+bool LockstepClient::isStarted() const
+{
+    return m_isStarted;
+}
+
+const LockstepSettings& LockstepClient::getSettings() const
+{
+    return m_settings;
+}
+
+int LockstepClient::getPlayerIndex() const
+{
+    return m_playerIndex;
+}
+
+int LockstepClient::getTick() const
+{
+    return m_tick;
+}
+
+bool LockstepClient::hasTickInputs() const
+{
+    return m_isStarted && m_tick < m_receivedTickCount;
+}
+
+bool LockstepClient::advanceTick(PlayerInput localInput, const SnakeArena& arena, PlayerInput* inputs, std::chrono::microseconds now)
+{
+    if (!hasTickInputs())
+        return false;
+
+    const int playerCount = m_settings.playerCount;
+    for (int i = 0; i < playerCount; ++i)
+    {
+        const std::uint8_t input = m_tickInputs[i];
+        inputs[i] = input == NO_INPUT ? arena.getLastMovement(i) : static_cast<PlayerInput>(input);
+    }
+    m_tickInputs.erase(m_tickInputs.begin(), m_tickInputs.begin() + playerCount);
+    ++m_tick;
+
+    // The input for the tick inputDelay ahead, sent right away so it has the whole delay to arrive
+    m_localInputs.push_back(static_cast<std::uint8_t>(localInput));
+    sendInputs(now);
+    return true;
+}
+
+void LockstepClient::receive()
+{
+    NetEndpoint from;
+    while (m_transport->receive(&from, &m_datagram))
+    {
+        std::size_t position = 0;
+        MessageType type;
+        if (from != m_server || !readMessageType(m_datagram, &position, &type))
+            continue;
+
+        if (type == MessageType::Welcome && !m_isStarted)
+        {
+            LockstepSettings settings;
+            int playerIndex = 0;
+            if (!readInt(m_datagram, &position, 0xFFFF, &playerIndex)
+                || !readInt(m_datagram, &position, 0xFFFF, &settings.playerCount)
+                || !readInt(m_datagram, &position, 0xFFFFFF, &settings.aiSnakeCount)
+                || !readInt(m_datagram, &position, 0xFFFF, &settings.levelIndex))
+                continue;
+
+            std::uint64_t seedValue = 0;
+            if (!readVarint(m_datagram, &position, &seedValue)
+                || !readInt(m_datagram, &position, 0xFFFF, &settings.inputDelay)
+                || playerIndex >= settings.playerCount || settings.inputDelay < 1)
+                continue;
+            settings.seed = static_cast<unsigned int>(seedValue);
+
+            m_settings = settings;
+            m_playerIndex = playerIndex;
+            m_isStarted = true;
+            // Own inputs start after the ticks the server filled in itself
+            m_firstLocalTick = settings.inputDelay;
+            m_hasSent = false;
+        }
+        else if (type == MessageType::Ticks && m_isStarted)
+        {
+            int firstTick = 0;
+            int count = 0;
+            const int playerCount = m_settings.playerCount;
+            // Ticks after the received ones can't continue them, so firstTick + count can't overflow either
+            if (!readInt(m_datagram, &position, m_receivedTickCount, &firstTick)
+                || !readInt(m_datagram, &position, MAX_TICKS_PER_DATAGRAM, &count)
+                || m_datagram.size() - position != static_cast<std::size_t>(count) * playerCount)
+                continue;
+
+            // Only the ticks that continue what is there are kept, datagrams can arrive out of order
+            for (int i = 0; i < count; ++i)
+            {
+                const int tick = firstTick + i;
+                if (tick != m_receivedTickCount)
+                    continue;
+                m_tickInputs.insert(m_tickInputs.end(), m_datagram.begin() + position + static_cast<std::size_t>(i) * playerCount,
+                    m_datagram.begin() + position + static_cast<std::size_t>(i + 1) * playerCount);
+                ++m_receivedTickCount;
+            }
+
+            // Own inputs for ticks the server has closed are confirmed
+            const int confirmedCount = std::min(m_receivedTickCount - m_firstLocalTick, static_cast<int>(m_localInputs.size()));
+            if (confirmedCount > 0)
+            {
+                m_localInputs.erase(m_localInputs.begin(), m_localInputs.begin() + confirmedCount);
+                m_firstLocalTick += confirmedCount;
+            }
+        }
+    }
+}
+
+void LockstepClient::sendInputs(std::chrono::microseconds now)
+{
+    const int count = std::min(static_cast<int>(m_localInputs.size()), MAX_TICKS_PER_DATAGRAM);
+
+    beginMessage(MessageType::Inputs, &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(m_playerIndex), &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(m_receivedTickCount), &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(m_firstLocalTick), &m_datagram);
+    writeVarint(static_cast<std::uint64_t>(count), &m_datagram);
+    m_datagram.insert(m_datagram.end(), m_localInputs.begin(), m_localInputs.begin() + count);
+
+    m_transport->send(m_server, m_datagram);
+    m_lastSendTime = now;
+    m_hasSent = true;
+}
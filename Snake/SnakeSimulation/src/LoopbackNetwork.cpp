@@ -0,0 +1,120 @@
+#include "simulation/LoopbackNetwork.hpp"
+
+namespace
+{
+    // 127.0.0.1 in host byte order
+    const std::uint32_t LOOPBACK_ADDRESS = 0x7F000001;
+}
+
+class LoopbackNetwork::Endpoint : public NetTransport
+{
+public:
+    Endpoint(LoopbackNetwork* network, std::uint16_t port)
+        :m_network(network)
+    {
+        m_endpoint.address = LOOPBACK_ADDRESS;
+        m_endpoint.port = port;
+    }
+
+    virtual bool send(const NetEndpoint& to, const std::vector<std::uint8_t>& datagram) override
+    {
+        m_network->post(m_endpoint, to, datagram);
+        return true;
+    }
+
+    virtual bool receive(NetEndpoint* from, std::vector<std::uint8_t>* datagram) override
+    {
+        return m_network->take(m_endpoint, from, datagram);
+    }
+
+    virtual NetEndpoint getLocalEndpoint() const override
+    {
+        return m_endpoint;
+    }
+
+private:
+    LoopbackNetwork* m_network;
+    NetEndpoint m_endpoint;
+};
+
+LoopbackNetwork::LoopbackNetwork(unsigned int seed)
+    :m_randomGenerator(seed)
+{
+}
+
+void LoopbackNetwork::setConditions(const Conditions& conditions)
+{
+    m_conditions = conditions;
+}
+
+std::unique_ptr<NetTransport> LoopbackNetwork::createEndpoint(std::uint16_t port)
+{
+    return std::make_unique<Endpoint>(this, port);
+}
+
+void LoopbackNetwork::setTime(std::chrono::microseconds now)
+{
+    m_now = now;
+}
+
+std::chrono::microseconds LoopbackNetwork::getTime() const
+{
+    return m_now;
+}
+
+long long LoopbackNetwork::getSentDatagramCount() const
+{
+    return m_sentDatagramCount;
+}
+
+long long LoopbackNetwork::getLostDatagramCount() const
+{
+    return m_lostDatagramCount;
+}
+
+long long LoopbackNetwork::getSentByteCount() const
+{
+    return m_sentByteCount;
+}
+
+void LoopbackNetwork::post(const NetEndpoint& from, const NetEndpoint& to, const std::vector<std::uint8_t>& data)
+{
+    ++m_sentDatagramCount;
+    m_sentByteCount += static_cast<long long>(data.size());
+
+    // Draw both numbers for every datagram, so the loss rate doesn't change which delays the others get
+    const double lossRoll = static_cast<double>(m_randomGenerator()) / 4294967296.0;
+    const double jitterRoll = static_cast<double>(m_randomGenerator()) / 4294967296.0;
+    if (lossRoll < m_conditions.lossRate)
+    {
+        ++m_lostDatagramCount;
+        return;
+    }
+
+    const auto jitter = std::chrono::microseconds(static_cast<long long>(jitterRoll * m_conditions.jitter.count()));
+    m_inFlight.push_back(Datagram {m_now + m_conditions.latency + jitter, m_sentDatagramCount, from, to, data});
+}
+
+bool LoopbackNetwork::take(const NetEndpoint& to, NetEndpoint* from, std::vector<std::uint8_t>* data)
+{
+    // Few datagrams are in flight at a time, a scan for the one that arrived first is enough
+    std::size_t first = m_inFlight.size();
+    for (std::size_t i = 0; i < m_inFlight.size(); ++i)
+    {
+        const Datagram& datagram = m_inFlight[i];
+        if (datagram.to != to || datagram.arrival > m_now)
+            continue;
+        if (first == m_inFlight.size() || datagram.arrival < m_inFlight[first].arrival
+            || (datagram.arrival == m_inFlight[first].arrival && datagram.sequence < m_inFlight[first].sequence))
+            first = i;
+    }
+    if (first == m_inFlight.size())
+        return false;
+
+    *from = m_inFlight[first].from;
+    data->swap(m_inFlight[first].data);
+    if (first + 1 < m_inFlight.size())
+        m_inFlight[first] = std::move(m_inFlight.back());
+    m_inFlight.pop_back();
+    return true;
+}
@@ -0,0 +1,151 @@
+#include "simulation/Replay.hpp"
+#include "Varint.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    const std::uint8_t REPLAY_MAGIC[4] = {'S', 'N', 'K', 'R'};
+    const std::uint8_t REPLAY_VERSION = 1;
+}
+
+std::vector<std::uint8_t> encodeReplay(const Replay& replay)
+{
+    std::vector<std::uint8_t> data(std::begin(REPLAY_MAGIC), std::end(REPLAY_MAGIC));
+    data.push_back(REPLAY_VERSION);
+
+    writeVarint(replay.seed, &data);
+    writeVarint(static_cast<std::uint64_t>(replay.levelIndex), &data);
+    writeVarint(static_cast<std::uint64_t>(replay.finalScore), &data);
+    for (int i = 0; i < 8; ++i)
+        data.push_back(static_cast<std::uint8_t>(replay.finalStateHash >> (i * 8)));
+    writeVarint(replay.inputs.size(), &data);
+
+    // Most ticks repeat the previous input, so runs are far shorter than the tick count
+    std::size_t runBegin = 0;
+    while (runBegin < replay.inputs.size())
+    {
+        std::size_t runEnd = runBegin + 1;
+        while (runEnd < replay.inputs.size() && replay.inputs[runEnd] == replay.inputs[runBegin])
+            ++runEnd;
+
+        writeVarint((static_cast<std::uint64_t>(runEnd - runBegin) << 2) | static_cast<std::uint64_t>(replay.inputs[runBegin]), &data);
+        runBegin = runEnd;
+    }
+
+    return data;
+}
+
+bool decodeReplay(const std::vector<std::uint8_t>& data, Replay* replay)
+{
+    if (data.size() < 5 || !std::equal(std::begin(REPLAY_MAGIC), std::end(REPLAY_MAGIC), data.begin()) || data[4] != REPLAY_VERSION)
+        return false;
+
+    std::size_t position = 5;
+    std::uint64_t seed, levelIndex, finalScore, tickCount;
+    if (!readVarint(data, &position, &seed) || !readVarint(data, &position, &levelIndex)
+        || !readVarint(data, &position, &finalScore))
+        return false;
+
+    if (position + 8 > data.size())
+        return false;
+    std::uint64_t finalStateHash = 0;
+    for (int i = 0; i < 8; ++i)
+        finalStateHash |= static_cast<std::uint64_t>(data[position++]) << (i * 8);
+
+    if (!readVarint(data, &position, &tickCount))
+        return false;
+
+    std::vector<Simulation::PlayerInput> inputs;
+    while (inputs.size() < tickCount)
+    {
+        std::uint64_t run;
+        if (!readVarint(data, &position, &run))
+            return false;
+
+        std::uint64_t runLength = run >> 2;
+        if (runLength == 0 || runLength > tickCount - inputs.size())
+            return false;
+        inputs.insert(inputs.end(), static_cast<std::size_t>(runLength), static_cast<Simulation::PlayerInput>(run & 3));
+    }
+
+    replay->seed = static_cast<unsigned int>(seed);
+    replay->levelIndex = static_cast<int>(levelIndex);
+    replay->finalScore = static_cast<int>(finalScore);
+    replay->finalStateHash = finalStateHash;
+    replay->inputs = std::move(inputs);
+    return true;
+}
+
+bool saveReplay(const Replay& replay, const std::string& path)
+{
+    std::vector<std::uint8_t> data = encodeReplay(replay);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+    {
+        cerr << "saveReplay(): error writing " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadReplay(const std::string& path, Replay* replay)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        cerr << "loadReplay(): error opening " << path << endl;
+        return false;
+    }
+
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!decodeReplay(data, replay))
+    {
+        cerr << "loadReplay(): " << path << " is no valid replay!" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReplayPlayer::start(const Replay& replay, const LevelData& level)
+{
+    m_replay = replay;
+    m_tick = 0;
+
+    m_simulation.seed(m_replay.seed);
+    return m_simulation.loadLevel(level);
+}
+
+Simulation::Events ReplayPlayer::step()
+{
+    if (isFinished())
+        return Simulation::Events();
+
+    return m_simulation.step(m_replay.inputs[m_tick++]);
+}
+
+bool ReplayPlayer::isFinished() const
+{
+    return m_tick >= m_replay.inputs.size();
+}
+
+std::size_t ReplayPlayer::getTick() const
+{
+    return m_tick;
+}
+
+bool ReplayPlayer::matchesRecording() const
+{
+    return m_simulation.getScore() == m_replay.finalScore && m_simulation.computeStateHash() == m_replay.finalStateHash;
+}
+
+const Simulation& ReplayPlayer::getSimulation() const
+{
+    return m_simulation;
+}
@@ -0,0 +1,183 @@
+#include "simulation/Rollback.hpp"
+#include <algorithm>
+#include <iostream>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    // Same as in the lockstep games
+    const int SNAKE_RESPAWN_TICKS = 8;
+    // Inputs older than the oldest tick a rollback can reach are dropped in blocks of this many ticks
+    const int INPUT_TRIM_TICKS = 256;
+}
+
+bool RollbackSession::start(const LevelData& level, int playerCount, int aiSnakeCount, unsigned int seed, int maxRollbackTicks)
+{
+    if (playerCount < 1 || aiSnakeCount < 0 || maxRollbackTicks < 1)
+    {
+        cerr << "RollbackSession::start(): invalid settings!" << endl;
+        return false;
+    }
+
+    m_arena.seed(seed);
+    if (!m_arena.loadLevel(level, playerCount + aiSnakeCount))
+        return false;
+    m_arena.setRollbackEnabled(true);
+
+    m_playerCount = playerCount;
+    m_maxRollbackTicks = maxRollbackTicks;
+    m_seed = seed;
+    m_respawnTicks.assign(m_arena.getSnakeCount(), 0);
+    m_stepInputs.assign(m_arena.getSnakeCount(), PlayerInput::Up);
+
+    m_tick = 0;
+    m_confirmedTickCount = 0;
+    m_rollbackTick = 0;
+    m_confirmedInputs.clear();
+    m_usedInputs.clear();
+    m_firstStoredTick = 0;
+    m_snapshots.resize(static_cast<std::size_t>(maxRollbackTicks) + 1);
+    m_rollbackCount = 0;
+    m_resimulatedTickCount = 0;
+    return true;
+}
+
+void RollbackSession::addInput(int playerIndex, int tick, PlayerInput input)
+{
+    if (playerIndex < 0 || playerIndex >= m_playerCount || tick < m_confirmedTickCount)
+        return;
+
+    std::uint8_t& confirmedInput = getInput(&m_confirmedInputs, tick, playerIndex);
+    confirmedInput = static_cast<std::uint8_t>(input);
+    if (tick < m_tick && getInput(&m_usedInputs, tick, playerIndex) != confirmedInput)
+        m_rollbackTick = std::min(m_rollbackTick, tick);
+
+    for (;;)
+    {
+        bool isComplete = true;
+        for (int i = 0; i < m_playerCount && isComplete; ++i)
+            isComplete = getInput(&m_confirmedInputs, m_confirmedTickCount, i) != MISSING_INPUT;
+        if (!isComplete)
+            break;
+        ++m_confirmedTickCount;
+    }
+}
+
+bool RollbackSession::advance()
+{
+    if (m_rollbackTick < m_tick)
+        rollback();
+
+    // The ticks before this one are final, their snapshots and journal entries aren't needed anymore
+    const int oldestRollbackTick = std::min(m_confirmedTickCount, m_tick);
+    if (m_tick - oldestRollbackTick >= m_maxRollbackTicks)
+        return false;
+
+    if (oldestRollbackTick < m_tick)
+        m_arena.forgetSnapshotsBefore(m_snapshots[oldestRollbackTick % m_snapshots.size()].arena);
+    if (oldestRollbackTick - 1 - m_firstStoredTick >= INPUT_TRIM_TICKS)
+    {
+        const std::size_t count = static_cast<std::size_t>(oldestRollbackTick - 1 - m_firstStoredTick) * m_playerCount;
+        m_confirmedInputs.erase(m_confirmedInputs.begin(), m_confirmedInputs.begin() + count);
+        m_usedInputs.erase(m_usedInputs.begin(), m_usedInputs.begin() + count);
+        m_firstStoredTick = oldestRollbackTick - 1;
+    }
+
+    simulateTick(m_tick);
+    ++m_tick;
+    m_rollbackTick = m_tick;
+    return true;
+}
+
+const SnakeArena& RollbackSession::getArena() const
+{
+    return m_arena;
+}
+
+int RollbackSession::getTick() const
+{
+    return m_tick;
+}
+
+int RollbackSession::getConfirmedTickCount() const
+{
+    return m_confirmedTickCount;
+}
+
+long long RollbackSession::getRollbackCount() const
+{
+    return m_rollbackCount;
+}
+
+long long RollbackSession::getResimulatedTickCount() const
+{
+    return m_resimulatedTickCount;
+}
+
+void RollbackSession::simulateTick(int tick)
+{
+    TickSnapshot& snapshot = m_snapshots[tick % m_snapshots.size()];
+    m_arena.saveSnapshot(&snapshot.arena);
+    snapshot.respawnTicks = m_respawnTicks;
+
+    // A missing input repeats the input of the tick before, which is the last input that arrived
+    for (int i = 0; i < m_playerCount; ++i)
+    {
+        std::uint8_t input = getInput(&m_confirmedInputs, tick, i);
+        if (input == MISSING_INPUT)
+            input = tick > m_firstStoredTick ? getInput(&m_usedInputs, tick - 1, i) : MISSING_INPUT;
+        if (input == MISSING_INPUT)
+            input = static_cast<std::uint8_t>(m_arena.getLastMovement(i));
+
+        getInput(&m_usedInputs, tick, i) = input;
+        m_stepInputs[i] = static_cast<PlayerInput>(input);
+    }
+    for (int i = m_playerCount; i < m_arena.getSnakeCount(); ++i)
+        m_stepInputs[i] = m_arena.getWanderInput(i, getAIRandomNumber(tick, i));
+
+    m_arena.step(m_stepInputs.data());
+
+    for (int i = 0; i < m_arena.getSnakeCount(); ++i)
+    {
+        if (m_arena.isSnakeAlive(i))
+            continue;
+        if (++m_respawnTicks[i] >= SNAKE_RESPAWN_TICKS)
+        {
+            m_respawnTicks[i] = 0;
+            m_arena.respawnSnake(i);
+        }
+    }
+}
+
+void RollbackSession::rollback()
+{
+    const TickSnapshot& snapshot = m_snapshots[m_rollbackTick % m_snapshots.size()];
+    m_arena.restoreSnapshot(snapshot.arena);
+    m_respawnTicks = snapshot.respawnTicks;
+
+    ++m_rollbackCount;
+    m_resimulatedTickCount += m_tick - m_rollbackTick;
+    for (int tick = m_rollbackTick; tick < m_tick; ++tick)
+        simulateTick(tick);
+    m_rollbackTick = m_tick;
+}
+
+std::uint8_t& RollbackSession::getInput(std::vector<std::uint8_t>* inputs, int tick, int playerIndex)
+{
+    const std::size_t index = static_cast<std::size_t>(tick - m_firstStoredTick) * m_playerCount + playerIndex;
+    if (index >= inputs->size())
+        inputs->resize((index / m_playerCount + 1) * m_playerCount, MISSING_INPUT);
+    return (*inputs)[index];
+}
+
+std::uint32_t RollbackSession::getAIRandomNumber(int tick, int snakeIndex) const
+{
+    // Derived from the tick instead of drawn from a generator, so there is no generator state to roll back
+    std::uint64_t value = (static_cast<std::uint64_t>(m_seed) << 32) ^ (static_cast<std::uint64_t>(tick) * 0x9E3779B97F4A7C15ULL)
+        ^ static_cast<std::uint64_t>(snakeIndex);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<std::uint32_t>((value ^ (value >> 31)) >> 32);
+}
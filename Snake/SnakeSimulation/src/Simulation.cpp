@@ -0,0 +1,401 @@
+#include "simulation/Simulation.hpp"
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::cerr;
+
+Simulation::Simulation()
+{
+}
+
+void Simulation::seed(unsigned int seed)
+{
+    m_randomGenerator.seed(seed);
+}
+
+bool Simulation::loadLevel(const LevelData& level)
+{
+    m_snake.clear();
+    m_score = 0;
+    m_maxFoodInLevel = level.maxFood;
+    m_foodInLevel = 0;
+    m_remainingGrowthTicks = 0;
+    m_remainingFoodSpawnCooldown = 0;
+    m_lastMovement = PlayerInput::Up;
+    m_snakeIsDead = false;
+
+    if (!m_grid.loadFromArray(level.gridData, level.width, level.height))
+    {
+        cerr << "Simulation::loadLevel(): invalid level data!" << endl;
+        return false;
+    }
+
+    if (!level.startBody.empty())
+    {
+        for (std::size_t i = 0; i < level.startBody.size(); ++i)
+        {
+            m_snake.pushTail(level.startBody[i]);
+            m_grid.updateTile(m_snake.getTail(), i == 0 ? TileGrid::TileValue::SnakeHead : TileGrid::TileValue::SnakeBody);
+        }
+
+        // The snake keeps facing the way its neck points, so it can't turn back into itself on the first tick
+        if (m_snake.size() > 1)
+        {
+            const sf::Vector2i facing = m_snake[0] - m_snake[1];
+            if (facing.x > 0)
+                m_lastMovement = PlayerInput::Right;
+            else if (facing.x < 0)
+                m_lastMovement = PlayerInput::Left;
+            else if (facing.y > 0)
+                m_lastMovement = PlayerInput::Down;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < level.startLength; ++i)
+        {
+            m_snake.pushTail(level.startPosition + sf::Vector2i(0, i));
+            m_grid.updateTile(m_snake.getTail(), i == 0 ? TileGrid::TileValue::SnakeHead : TileGrid::TileValue::SnakeBody);
+        }
+    }
+
+    return true;
+}
+
+void Simulation::restartFrom(const Simulation& initial)
+{
+    // Everything but the random generator, assigning the containers reuses their storage.
+    // The snake is copied part by part, assigning it would also copy its unused buffer
+    m_grid = initial.m_grid;
+    m_snake.clear();
+    for (std::size_t i = 0; i < initial.m_snake.size(); ++i)
+        m_snake.pushTail(initial.m_snake[i]);
+    m_score = initial.m_score;
+    m_foodInLevel = initial.m_foodInLevel;
+    m_maxFoodInLevel = initial.m_maxFoodInLevel;
+    m_foodSpawnCooldown = initial.m_foodSpawnCooldown;
+    m_remainingGrowthTicks = initial.m_remainingGrowthTicks;
+    m_remainingFoodSpawnCooldown = initial.m_remainingFoodSpawnCooldown;
+    m_lastMovement = initial.m_lastMovement;
+    m_snakeIsDead = initial.m_snakeIsDead;
+}
+
+void Simulation::reserveSnakeLength(std::size_t length)
+{
+    m_snake.reserve(length);
+}
+
+Simulation::Events Simulation::step(PlayerInput input)
+{
+    Events events;
+    m_grid.clearChangedTiles();
+
+    if (m_snakeIsDead)
+        return events;
+
+    moveSnake(input, &events);
+
+    // Spawn food every x ticks up to a certain maximum
+    if (0 < m_remainingFoodSpawnCooldown)
+        --m_remainingFoodSpawnCooldown;
+
+    if (0 >= m_remainingFoodSpawnCooldown && m_foodInLevel < m_maxFoodInLevel)
+        spawnFood(&events);
+
+    return events;
+}
+
+const TileGrid& Simulation::getGrid() const
+{
+    return m_grid;
+}
+
+const SnakeBody& Simulation::getSnake() const
+{
+    return m_snake;
+}
+
+int Simulation::getScore() const
+{
+    return m_score;
+}
+
+bool Simulation::isSnakeDead() const
+{
+    return m_snakeIsDead;
+}
+
+Simulation::PlayerInput Simulation::getLastMovement() const
+{
+    return m_lastMovement;
+}
+
+int Simulation::getRemainingGrowthTicks() const
+{
+    return m_remainingGrowthTicks;
+}
+
+std::uint64_t Simulation::computeStateHash() const
+{
+    // FNV-1a
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (int y = 0; y < m_grid.getHeight(); ++y)
+    {
+        for (int x = 0; x < m_grid.getWidth(); ++x)
+        {
+            TileGrid::TileValue tileValue = TileGrid::TileValue::Empty;
+            m_grid.getTileValueAt(sf::Vector2i(x, y), &tileValue);
+            hash = (hash ^ static_cast<std::uint64_t>(tileValue)) * prime;
+        }
+    }
+    hash = (hash ^ static_cast<std::uint64_t>(m_score)) * prime;
+    hash = (hash ^ static_cast<std::uint64_t>(m_snakeIsDead)) * prime;
+    return hash;
+}
+
+bool Simulation::isOppositeDirection(PlayerInput first, PlayerInput second)
+{
+    switch (first)
+    {
+    case PlayerInput::Up:
+        return second == PlayerInput::Down;
+    case PlayerInput::Down:
+        return second == PlayerInput::Up;
+    case PlayerInput::Left:
+        return second == PlayerInput::Right;
+    case PlayerInput::Right:
+        return second == PlayerInput::Left;
+    default:
+        return false;
+    }
+}
+
+sf::Vector2i Simulation::getDirection(PlayerInput input)
+{
+    switch (input)
+    {
+    case PlayerInput::Up:
+        return sf::Vector2i(0, -1);
+    case PlayerInput::Down:
+        return sf::Vector2i(0, 1);
+    case PlayerInput::Left:
+        return sf::Vector2i(-1, 0);
+    case PlayerInput::Right:
+        return sf::Vector2i(1, 0);
+    default:
+        return sf::Vector2i(0, 0);
+    }
+}
+
+void Simulation::moveSnake(PlayerInput input, Events* events)
+{
+    // Only move if snake is at least 2 parts long and is not dead
+    if (!isSnakeValid() || m_snakeIsDead)
+        return;
+
+    // The snake can't turn back into itself, keep going in the last direction instead
+    if (isOppositeDirection(input, m_lastMovement))
+        input = m_lastMovement;
+
+    sf::Vector2i movement;
+    TileGrid::TileValue tileValue;
+    bool snakeDied = false;
+    int snakeGrowth = 0;
+
+    switch (input)
+    {
+    case PlayerInput::Up:
+        --movement.y;
+        break;
+    case PlayerInput::Down:
+        ++movement.y;
+        break;
+
+    case PlayerInput::Left:
+        --movement.x;
+        break;
+
+    case PlayerInput::Right:
+        ++movement.x;
+        break;
+
+    default:
+        // invalid state, do nothing
+        return;
+    }
+
+    const sf::Vector2i head = m_snake.getHead();
+
+    // Only move if next position is valid
+    if (m_grid.getTileValueAt(head + movement, &tileValue))
+    {
+        // Snake grows x ticks after eating food, the tail keeps its position during these ticks
+        bool isGrowing = false;
+        if (m_remainingGrowthTicks > 0)
+        {
+            events->growing = true;
+            isGrowing = true;
+            --m_remainingGrowthTicks;
+        }
+
+        // Check for next position's tile value
+        switch (tileValue)
+        {
+        case TileGrid::TileValue::Empty:
+            // Do nothing, only move snake
+            break;
+        case TileGrid::TileValue::Wall:
+        case TileGrid::TileValue::SnakeBody:
+            snakeDied = true;
+            break;
+        case TileGrid::TileValue::SnakeHead:
+            snakeDied = true;
+            // Note: this shouldn't be possible with only one snake on the board
+            // -> possible multiplayer extension
+            break;
+        case TileGrid::TileValue::Food:
+        case TileGrid::TileValue::SuperFood:
+            snakeGrowth = eatFood(tileValue, events);
+            break;
+        case TileGrid::TileValue::Poison:
+            // Trigger posion effects (changed controls, other effects)
+            break;
+        case TileGrid::TileValue::Teleport1:
+        case TileGrid::TileValue::Teleport2:
+            {
+                auto otherTeleporter = tileValue == TileGrid::TileValue::Teleport1
+                    ? m_grid.getPositionOfOtherTeleporter1(head + movement)
+                    : m_grid.getPositionOfOtherTeleporter2(head + movement);
+                if (otherTeleporter)
+                {
+                    events->teleported = true;
+
+                    // Teleport the snake by adding an offset
+                    movement += *otherTeleporter - head;
+
+                    // Check for collision on other telporter's side
+                    if (m_grid.getTileValueAt(head + movement, &tileValue))
+                    {
+                        switch (tileValue)
+                        {
+                        case TileGrid::TileValue::Wall:
+                        case TileGrid::TileValue::SnakeBody:
+                        case TileGrid::TileValue::SnakeHead:
+                        case TileGrid::TileValue::NoPlayArea:
+                            snakeDied = true;
+                            break;
+                        case TileGrid::TileValue::Food:
+                        case TileGrid::TileValue::SuperFood:
+                            snakeGrowth = eatFood(tileValue, events);
+                            break;
+                        default: ;
+                        }
+                    }
+                }
+            }
+            break;
+        case TileGrid::TileValue::NoPlayArea:
+            snakeDied = true;
+            // Note: this shouldn't be possible, trigger death for safety reasons
+            break;
+        default: ;
+        }
+
+        // Clear the tail's previous tile, all parts in between keep their position
+        if (!isGrowing)
+        {
+            m_grid.updateTile(m_snake.getTail(), TileGrid::TileValue::Empty);
+            m_snake.popTail();
+        }
+
+        m_grid.updateTile(head, TileGrid::TileValue::SnakeBody);
+        m_snake.pushHead(head + movement);
+        m_grid.updateTile(m_snake.getHead(), TileGrid::TileValue::SnakeHead);
+        events->moved = true;
+    }
+
+    if (snakeDied)
+    {
+        events->collided = true;
+        triggerSnakeDeath();
+    }
+
+    if (snakeGrowth > 0)
+        snakeGrows(snakeGrowth);
+
+    m_lastMovement = input;
+}
+
+int Simulation::eatFood(TileGrid::TileValue food, Events* events)
+{
+    --m_foodInLevel;
+
+    if (food == TileGrid::TileValue::SuperFood)
+    {
+        events->ateSuperFood = true;
+        m_score += 5;
+        return 5;
+    }
+
+    events->ateFood = true;
+    m_score += 1;
+    return 1;
+}
+
+void Simulation::spawnFood(Events* events)
+{
+    std::size_t emptyTileCount = m_grid.getEmptyTileCount();
+    if (emptyTileCount == 0)
+        return;
+
+    // Get random tile to spawn the food on
+    sf::Vector2i chosenTile = m_grid.getEmptyTile(getRandomNumberBelow(static_cast<std::uint32_t>(emptyTileCount)));
+    ++m_foodInLevel;
+
+    // 5 % chance for spawning a super food
+    if (getRandomNumberBelow(100) < 95)
+        m_grid.updateTile(chosenTile, TileGrid::TileValue::Food);
+    else
+        m_grid.updateTile(chosenTile, TileGrid::TileValue::SuperFood);
+
+    // Reset cooldown only in case of successful spawn
+    m_remainingFoodSpawnCooldown = m_foodSpawnCooldown;
+    events->spawnedFood = true;
+}
+
+bool Simulation::isSnakeValid() const
+{
+    return m_snake.size() > 1;
+}
+
+void Simulation::triggerSnakeDeath()
+{
+    m_snakeIsDead = true;
+    if (m_snake.size() > 1)
+    {
+        for (std::size_t i = 1; i < m_snake.size(); ++i)
+            m_grid.updateTile(m_snake[i], TileGrid::TileValue::DeadSnakeBody);
+
+		// Update snake head at last element to show head on top when colliding with snake
+        m_grid.updateTile(m_snake.getHead(), TileGrid::TileValue::DeadSnakeHead);
+    }
+}
+
+void Simulation::snakeGrows(int growth)
+{
+    // If there is no existing snake it's not possible to grow
+    if (m_snake.empty())
+        return;
+
+    // No parts are added here, the tail just stays in place for the next growth ticks
+    m_remainingGrowthTicks += growth;
+}
+
+std::uint32_t Simulation::getRandomNumberBelow(std::uint32_t bound)
+{
+    // Multiply and shift instead of modulo, the bias is negligible for the grid sizes used here
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(m_randomGenerator()) * bound) >> 32);
+}
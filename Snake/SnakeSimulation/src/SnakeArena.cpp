@@ -0,0 +1,535 @@
+#include "simulation/SnakeArena.hpp"
+#include <algorithm>
+#include <iostream>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    // Random free spots tried before respawnSnake() gives up
+    const int MAX_PLACEMENT_ATTEMPTS = 64;
+
+    bool isFood(TileGrid::TileValue value)
+    {
+        return value == TileGrid::TileValue::Food || value == TileGrid::TileValue::SuperFood;
+    }
+}
+
+SnakeArena::SnakeArena()
+{
+}
+
+void SnakeArena::seed(unsigned int seed)
+{
+    m_randomGenerator.seed(seed);
+}
+
+bool SnakeArena::loadLevel(const LevelData& level, int snakeCount)
+{
+    if (snakeCount < 1)
+    {
+        cerr << "SnakeArena::loadLevel(): at least one snake is needed!" << endl;
+        return false;
+    }
+
+    if (!m_grid.loadFromArray(level.gridData, level.width, level.height))
+    {
+        cerr << "SnakeArena::loadLevel(): invalid level data!" << endl;
+        return false;
+    }
+
+    // Food grows with the number of snakes, a single snake gets the food of the single snake game
+    m_startLength = std::max(2, level.startBody.empty() ? level.startLength : static_cast<int>(level.startBody.size()));
+    m_maxFoodInLevel = level.maxFood + snakeCount - 1;
+    m_foodPerSpawn = std::max(1, snakeCount / m_foodSpawnCooldown);
+    m_foodInLevel = 0;
+    m_remainingFoodSpawnCooldown = 0;
+    m_aliveSnakeCount = 0;
+
+    m_heads.assign(snakeCount, -1);
+    m_tails.assign(snakeCount, -1);
+    m_lengths.assign(snakeCount, 0);
+    m_remainingGrowthTicks.assign(snakeCount, 0);
+    m_scores.assign(snakeCount, 0);
+    m_lastMovements.assign(snakeCount, PlayerInput::Up);
+    m_alive.assign(snakeCount, 0);
+    m_events.assign(snakeCount, Simulation::Events());
+    m_targets.assign(snakeCount, -1);
+
+    const std::size_t tileCount = static_cast<std::size_t>(level.width) * level.height;
+    m_nextPart.assign(tileCount, -1);
+    m_linkJournal.clear();
+    m_linkJournalStart = 0;
+    m_claims.assign(tileCount, NO_CLAIM);
+
+    // Snake 0 starts like the snake of the single snake game
+    m_placement.clear();
+    if (!level.startBody.empty())
+        m_placement = level.startBody;
+    else
+        for (int i = 0; i < level.startLength; ++i)
+            m_placement.push_back(level.startPosition + sf::Vector2i(0, i));
+
+    bool allPlaced = placeSnake(0, m_placement);
+    for (int i = 1; i < snakeCount; ++i)
+        allPlaced = respawnSnake(i) && allPlaced;
+
+    if (!allPlaced)
+        cerr << "SnakeArena::loadLevel(): only " << m_aliveSnakeCount << " of " << snakeCount << " snakes fit into the level!" << endl;
+    return allPlaced;
+}
+
+void SnakeArena::step(const PlayerInput* inputs)
+{
+    m_grid.clearChangedTiles();
+    const int snakeCount = getSnakeCount();
+
+    // Pick the targets and claim them, a tile claimed twice is deadly for every snake that claimed it
+    for (int i = 0; i < snakeCount; ++i)
+    {
+        m_events[i] = Simulation::Events();
+        m_targets[i] = -1;
+        if (!m_alive[i])
+            continue;
+
+        PlayerInput input = inputs[i];
+        if (Simulation::isOppositeDirection(input, m_lastMovements[i]))
+            input = m_lastMovements[i];
+        m_lastMovements[i] = input;
+
+        const int target = getTarget(i, input);
+        m_targets[i] = target;
+        if (target < 0)
+            continue;
+
+        const sf::Vector2i neighbour = toPosition(m_heads[i]) + Simulation::getDirection(input);
+        m_events[i].teleported = target != neighbour.x + neighbour.y * m_grid.getWidth();
+
+        int& claim = m_claims[target];
+        claim = claim == NO_CLAIM ? i : CONTESTED;
+    }
+
+    // Decide every death before any tile changes, so no snake sees the result of another snake's move
+    for (int i = 0; i < snakeCount; ++i)
+    {
+        const int target = m_targets[i];
+        if (target < 0)
+            continue;
+
+        TileGrid::TileValue targetValue = TileGrid::TileValue::Empty;
+        m_grid.getTileValueAt(toPosition(target), &targetValue);
+        if (m_claims[target] == CONTESTED || isDeadly(targetValue))
+            m_events[i].collided = true;
+    }
+
+    // Move the survivors, their targets were free before the tick and nobody else moves onto them
+    for (int i = 0; i < snakeCount; ++i)
+    {
+        const int target = m_targets[i];
+        if (target < 0)
+            continue;
+        m_claims[target] = NO_CLAIM;
+
+        Simulation::Events& events = m_events[i];
+        if (events.collided)
+            continue;
+
+        // Snake grows x ticks after eating food, the tail keeps its position during these ticks
+        const bool isGrowing = m_remainingGrowthTicks[i] > 0;
+        if (isGrowing)
+        {
+            events.growing = true;
+            --m_remainingGrowthTicks[i];
+        }
+        else
+        {
+            const int tail = m_tails[i];
+            m_tails[i] = m_nextPart[tail];
+            setNextPart(tail, -1);
+            m_grid.updateTile(toPosition(tail), TileGrid::TileValue::Empty);
+            --m_lengths[i];
+        }
+
+        TileGrid::TileValue targetValue = TileGrid::TileValue::Empty;
+        m_grid.getTileValueAt(toPosition(target), &targetValue);
+        if (isFood(targetValue))
+        {
+            const int growth = targetValue == TileGrid::TileValue::SuperFood ? 5 : 1;
+            --m_foodInLevel;
+            m_scores[i] += growth;
+            m_remainingGrowthTicks[i] += growth;
+            events.ateFood = growth == 1;
+            events.ateSuperFood = growth == 5;
+        }
+
+        const sf::Vector2i head = toPosition(m_heads[i]);
+        setNextPart(m_heads[i], target);
+        m_grid.updateTile(head, TileGrid::TileValue::SnakeBody);
+        m_heads[i] = target;
+        m_grid.updateTile(toPosition(target), TileGrid::TileValue::SnakeHead);
+        ++m_lengths[i];
+        events.moved = true;
+    }
+
+    for (int i = 0; i < snakeCount; ++i)
+        if (m_events[i].collided)
+            killSnake(i);
+
+    // Spawn food every x ticks up to a certain maximum
+    if (0 < m_remainingFoodSpawnCooldown)
+        --m_remainingFoodSpawnCooldown;
+
+    if (0 >= m_remainingFoodSpawnCooldown && m_foodInLevel < m_maxFoodInLevel)
+        spawnFood();
+}
+
+bool SnakeArena::respawnSnake(int index)
+{
+    if (m_alive[index])
+        return false;
+
+    // Clear what is left of the old body, from the tail along the links to the head
+    for (int tile = m_tails[index]; tile >= 0; )
+    {
+        const int next = m_nextPart[tile];
+        setNextPart(tile, -1);
+        m_grid.updateTile(toPosition(tile), TileGrid::TileValue::Empty);
+        tile = next;
+    }
+    m_heads[index] = -1;
+    m_tails[index] = -1;
+
+    // The snake lies straight downwards from a random free tile, like the single snake at its start
+    for (int attempt = 0; attempt < MAX_PLACEMENT_ATTEMPTS; ++attempt)
+    {
+        const std::size_t emptyTileCount = m_grid.getEmptyTileCount();
+        if (emptyTileCount == 0)
+            return false;
+
+        const sf::Vector2i head = m_grid.getEmptyTile(getRandomNumberBelow(static_cast<std::uint32_t>(emptyTileCount)));
+        m_placement.clear();
+        for (int i = 0; i < m_startLength; ++i)
+            m_placement.push_back(head + sf::Vector2i(0, i));
+
+        if (placeSnake(index, m_placement))
+            return true;
+    }
+    return false;
+}
+
+SnakeArena::PlayerInput SnakeArena::getWanderInput(int index, std::uint32_t random) const
+{
+    const PlayerInput straight = m_lastMovements[index];
+    if (!m_alive[index])
+        return straight;
+
+    // Straight first, then both turns starting with a random one
+    PlayerInput candidates[3] = {straight, PlayerInput::Left, PlayerInput::Right};
+    if (straight == PlayerInput::Left || straight == PlayerInput::Right)
+    {
+        candidates[1] = PlayerInput::Up;
+        candidates[2] = PlayerInput::Down;
+    }
+    if ((random >> 3) & 1)
+        std::swap(candidates[1], candidates[2]);
+
+    bool isSafe[3] = {false, false, false};
+    for (int i = 0; i < 3; ++i)
+    {
+        const int target = getTarget(index, candidates[i]);
+        TileGrid::TileValue value = TileGrid::TileValue::Empty;
+        if (target < 0 || !m_grid.getTileValueAt(toPosition(target), &value))
+            continue;
+        if (isFood(value))
+            return candidates[i];
+        isSafe[i] = !isDeadly(value);
+    }
+
+    if (isSafe[0] && random % 8 != 0)
+        return straight;
+    if (isSafe[1])
+        return candidates[1];
+    if (isSafe[2])
+        return candidates[2];
+    return straight;
+}
+
+const TileGrid& SnakeArena::getGrid() const
+{
+    return m_grid;
+}
+
+int SnakeArena::getSnakeCount() const
+{
+    return static_cast<int>(m_heads.size());
+}
+
+int SnakeArena::getAliveSnakeCount() const
+{
+    return m_aliveSnakeCount;
+}
+
+bool SnakeArena::isSnakeAlive(int index) const
+{
+    return m_alive[index] != 0;
+}
+
+int SnakeArena::getScore(int index) const
+{
+    return m_scores[index];
+}
+
+int SnakeArena::getSnakeLength(int index) const
+{
+    return m_lengths[index];
+}
+
+sf::Vector2i SnakeArena::getHead(int index) const
+{
+    return m_heads[index] >= 0 ? toPosition(m_heads[index]) : sf::Vector2i(-1, -1);
+}
+
+sf::Vector2i SnakeArena::getTail(int index) const
+{
+    return m_tails[index] >= 0 ? toPosition(m_tails[index]) : sf::Vector2i(-1, -1);
+}
+
+SnakeArena::PlayerInput SnakeArena::getLastMovement(int index) const
+{
+    return m_lastMovements[index];
+}
+
+const Simulation::Events& SnakeArena::getEvents(int index) const
+{
+    return m_events[index];
+}
+
+std::uint64_t SnakeArena::computeStateHash() const
+{
+    // FNV-1a
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (int y = 0; y < m_grid.getHeight(); ++y)
+    {
+        for (int x = 0; x < m_grid.getWidth(); ++x)
+        {
+            TileGrid::TileValue tileValue = TileGrid::TileValue::Empty;
+            m_grid.getTileValueAt(x, y, &tileValue);
+            hash = (hash ^ static_cast<std::uint64_t>(tileValue)) * prime;
+        }
+    }
+    for (int i = 0; i < getSnakeCount(); ++i)
+    {
+        hash = (hash ^ static_cast<std::uint64_t>(m_scores[i])) * prime;
+        hash = (hash ^ static_cast<std::uint64_t>(m_alive[i])) * prime;
+    }
+    return hash;
+}
+
+void SnakeArena::setRollbackEnabled(bool enabled)
+{
+    m_isRollbackEnabled = enabled;
+    m_grid.setJournalEnabled(enabled);
+    if (!enabled)
+    {
+        m_linkJournalStart += m_linkJournal.size();
+        m_linkJournal.clear();
+    }
+}
+
+void SnakeArena::saveSnapshot(Snapshot* snapshot) const
+{
+    snapshot->gridJournalPosition = m_grid.getJournalPosition();
+    snapshot->linkJournalPosition = m_linkJournalStart + m_linkJournal.size();
+    snapshot->foodInLevel = m_foodInLevel;
+    snapshot->remainingFoodSpawnCooldown = m_remainingFoodSpawnCooldown;
+    snapshot->aliveSnakeCount = m_aliveSnakeCount;
+    snapshot->heads = m_heads;
+    snapshot->tails = m_tails;
+    snapshot->lengths = m_lengths;
+    snapshot->remainingGrowthTicks = m_remainingGrowthTicks;
+    snapshot->scores = m_scores;
+    snapshot->lastMovements = m_lastMovements;
+    snapshot->alive = m_alive;
+    snapshot->events = m_events;
+    snapshot->randomGenerator = m_randomGenerator;
+}
+
+void SnakeArena::restoreSnapshot(const Snapshot& snapshot)
+{
+    if (!m_isRollbackEnabled || snapshot.linkJournalPosition < m_linkJournalStart
+        || snapshot.heads.size() != m_heads.size())
+    {
+        cerr << "SnakeArena::restoreSnapshot(): the snapshot can't be restored!" << endl;
+        return;
+    }
+
+    m_grid.clearChangedTiles();
+    m_grid.undoJournal(snapshot.gridJournalPosition);
+    while (m_linkJournalStart + m_linkJournal.size() > snapshot.linkJournalPosition)
+    {
+        m_nextPart[m_linkJournal.back().tile] = m_linkJournal.back().nextPart;
+        m_linkJournal.pop_back();
+    }
+
+    m_foodInLevel = snapshot.foodInLevel;
+    m_remainingFoodSpawnCooldown = snapshot.remainingFoodSpawnCooldown;
+    m_aliveSnakeCount = snapshot.aliveSnakeCount;
+    m_heads = snapshot.heads;
+    m_tails = snapshot.tails;
+    m_lengths = snapshot.lengths;
+    m_remainingGrowthTicks = snapshot.remainingGrowthTicks;
+    m_scores = snapshot.scores;
+    m_lastMovements = snapshot.lastMovements;
+    m_alive = snapshot.alive;
+    m_events = snapshot.events;
+    m_randomGenerator = snapshot.randomGenerator;
+}
+
+void SnakeArena::forgetSnapshotsBefore(const Snapshot& snapshot)
+{
+    m_grid.forgetJournal(snapshot.gridJournalPosition);
+
+    const std::size_t end = m_linkJournalStart + m_linkJournal.size();
+    const std::size_t count = std::min(snapshot.linkJournalPosition, end) - std::min(snapshot.linkJournalPosition, m_linkJournalStart);
+    m_linkJournal.erase(m_linkJournal.begin(), m_linkJournal.begin() + count);
+    m_linkJournalStart += count;
+}
+
+int SnakeArena::getTarget(int index, PlayerInput input) const
+{
+    const sf::Vector2i movement = Simulation::getDirection(input);
+    sf::Vector2i target = toPosition(m_heads[index]) + movement;
+
+    TileGrid::TileValue tileValue;
+    if (!m_grid.getTileValueAt(target, &tileValue))
+        return -1;
+
+    // Moving onto a teleporter leads to the tile behind its partner
+    if (tileValue == TileGrid::TileValue::Teleport1 || tileValue == TileGrid::TileValue::Teleport2)
+    {
+        auto otherTeleporter = tileValue == TileGrid::TileValue::Teleport1
+            ? m_grid.getPositionOfOtherTeleporter1(target)
+            : m_grid.getPositionOfOtherTeleporter2(target);
+        if (otherTeleporter)
+        {
+            target = *otherTeleporter + movement;
+            if (!m_grid.isValidPosition(target))
+                return -1;
+        }
+    }
+
+    return target.x + target.y * m_grid.getWidth();
+}
+
+bool SnakeArena::placeSnake(int index, const std::vector<sf::Vector2i>& parts)
+{
+    if (parts.size() < 2)
+        return false;
+
+    for (const sf::Vector2i& part : parts)
+    {
+        TileGrid::TileValue tileValue;
+        if (!m_grid.getTileValueAt(part, &tileValue) || tileValue != TileGrid::TileValue::Empty)
+            return false;
+    }
+
+    // Every part links to the one before it, the head links to nothing
+    const int width = m_grid.getWidth();
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+        const int tile = parts[i].x + parts[i].y * width;
+        setNextPart(tile, i == 0 ? -1 : parts[i - 1].x + parts[i - 1].y * width);
+        m_grid.updateTile(parts[i], i == 0 ? TileGrid::TileValue::SnakeHead : TileGrid::TileValue::SnakeBody);
+    }
+
+    // The snake keeps facing the way its neck points, so it can't turn back into itself on the first tick
+    const sf::Vector2i facing = parts[0] - parts[1];
+    PlayerInput lastMovement = PlayerInput::Up;
+    if (facing.x > 0)
+        lastMovement = PlayerInput::Right;
+    else if (facing.x < 0)
+        lastMovement = PlayerInput::Left;
+    else if (facing.y > 0)
+        lastMovement = PlayerInput::Down;
+
+    m_heads[index] = parts.front().x + parts.front().y * width;
+    m_tails[index] = parts.back().x + parts.back().y * width;
+    m_lengths[index] = static_cast<int>(parts.size());
+    m_remainingGrowthTicks[index] = 0;
+    m_scores[index] = 0;
+    m_lastMovements[index] = lastMovement;
+    m_alive[index] = 1;
+    ++m_aliveSnakeCount;
+    return true;
+}
+
+void SnakeArena::killSnake(int index)
+{
+    m_alive[index] = 0;
+    --m_aliveSnakeCount;
+
+    // The body stays as an obstacle until the snake respawns, the head is marked last to show it on top
+    for (int tile = m_tails[index]; tile >= 0; tile = m_nextPart[tile])
+        m_grid.updateTile(toPosition(tile), TileGrid::TileValue::DeadSnakeBody);
+    m_grid.updateTile(toPosition(m_heads[index]), TileGrid::TileValue::DeadSnakeHead);
+}
+
+void SnakeArena::spawnFood()
+{
+    for (int i = 0; i < m_foodPerSpawn && m_foodInLevel < m_maxFoodInLevel; ++i)
+    {
+        std::size_t emptyTileCount = m_grid.getEmptyTileCount();
+        if (emptyTileCount == 0)
+            return;
+
+        // Get random tile to spawn the food on
+        sf::Vector2i chosenTile = m_grid.getEmptyTile(getRandomNumberBelow(static_cast<std::uint32_t>(emptyTileCount)));
+        ++m_foodInLevel;
+
+        // 5 % chance for spawning a super food
+        if (getRandomNumberBelow(100) < 95)
+            m_grid.updateTile(chosenTile, TileGrid::TileValue::Food);
+        else
+            m_grid.updateTile(chosenTile, TileGrid::TileValue::SuperFood);
+
+        // Reset cooldown only in case of successful spawn
+        m_remainingFoodSpawnCooldown = m_foodSpawnCooldown;
+    }
+}
+
+sf::Vector2i SnakeArena::toPosition(int tile) const
+{
+    return sf::Vector2i(tile % m_grid.getWidth(), tile / m_grid.getWidth());
+}
+
+std::uint32_t SnakeArena::getRandomNumberBelow(std::uint32_t bound)
+{
+    // Same mapping as Simulation, keeps runs portable between standard libraries
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(m_randomGenerator()) * bound) >> 32);
+}
+
+void SnakeArena::setNextPart(int tile, int nextPart)
+{
+    if (m_isRollbackEnabled)
+        m_linkJournal.push_back(LinkChange {tile, m_nextPart[tile]});
+    m_nextPart[tile] = nextPart;
+}
+
+bool SnakeArena::isDeadly(TileGrid::TileValue value)
+{
+    switch (value)
+    {
+    case TileGrid::TileValue::Wall:
+    case TileGrid::TileValue::NoPlayArea:
+    case TileGrid::TileValue::SnakeBody:
+    case TileGrid::TileValue::SnakeHead:
+    case TileGrid::TileValue::DeadSnakeBody:
+    case TileGrid::TileValue::DeadSnakeHead:
+        return true;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,81 @@
+#include "simulation/SnakeBody.hpp"
+
+void SnakeBody::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+void SnakeBody::pushHead(sf::Vector2i position)
+{
+    if (m_size == m_parts.size())
+        grow(m_parts.empty() ? 16 : m_parts.size() * 2);
+
+    // The head walks backwards through the buffer, the tail stays where it is
+    m_head = m_head == 0 ? m_parts.size() - 1 : m_head - 1;
+    m_parts[m_head] = position;
+    ++m_size;
+}
+
+void SnakeBody::pushTail(sf::Vector2i position)
+{
+    if (m_size == m_parts.size())
+        grow(m_parts.empty() ? 16 : m_parts.size() * 2);
+
+    m_parts[toStorageIndex(m_size)] = position;
+    ++m_size;
+}
+
+void SnakeBody::popTail()
+{
+    if (m_size > 0)
+        --m_size;
+}
+
+void SnakeBody::reserve(std::size_t capacity)
+{
+    if (capacity > m_parts.size())
+        grow(capacity);
+}
+
+sf::Vector2i SnakeBody::getHead() const
+{
+    return m_parts[m_head];
+}
+
+sf::Vector2i SnakeBody::getTail() const
+{
+    return m_parts[toStorageIndex(m_size - 1)];
+}
+
+sf::Vector2i SnakeBody::operator[](std::size_t index) const
+{
+    return m_parts[toStorageIndex(index)];
+}
+
+std::size_t SnakeBody::size() const
+{
+    return m_size;
+}
+
+bool SnakeBody::empty() const
+{
+    return m_size == 0;
+}
+
+void SnakeBody::grow(std::size_t capacity)
+{
+    // Unroll the ring into the larger buffer, doubling keeps it amortized O(1) per pushed part
+    std::vector<sf::Vector2i> parts(capacity);
+    for (std::size_t i = 0; i < m_size; ++i)
+        parts[i] = (*this)[i];
+
+    m_parts.swap(parts);
+    m_head = 0;
+}
+
+std::size_t SnakeBody::toStorageIndex(std::size_t index) const
+{
+    std::size_t storageIndex = m_head + index;
+    return storageIndex < m_parts.size() ? storageIndex : storageIndex - m_parts.size();
+}
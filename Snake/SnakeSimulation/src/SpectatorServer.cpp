@@ -0,0 +1,239 @@
+#include "simulation/SpectatorServer.hpp"
+#include "Varint.hpp"
+#include <SFML/Network/IpAddress.hpp>
+#include <iostream>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    // A viewer with more unsent bytes than this skips deltas until it caught up and gets a keyframe then
+    const std::size_t MAX_VIEWER_BACKLOG = 256 * 1024;
+    // Nothing the encoder writes comes close, a larger length means the stream is broken
+    const std::uint64_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+    const std::size_t RECEIVE_CHUNK_SIZE = 64 * 1024;
+}
+
+bool SpectatorServer::listen(std::uint16_t port)
+{
+    m_listener.close();
+    m_viewers.clear();
+    m_isListening = false;
+    if (m_listener.listen(port) != sf::Socket::Done)
+    {
+        cerr << "SpectatorServer::listen(): port " << port << " is not available!" << endl;
+        return false;
+    }
+    m_listener.setBlocking(false);
+    m_isListening = true;
+    return true;
+}
+
+void SpectatorServer::update(const TileGrid& grid, sf::Vector2u tileSize, std::uint32_t tick, int score)
+{
+    if (!m_isListening)
+        return;
+
+    for (;;)
+    {
+        if (!m_nextSocket)
+            m_nextSocket = std::make_unique<sf::TcpSocket>();
+        if (m_listener.accept(*m_nextSocket) != sf::Socket::Done)
+            break;
+
+        m_nextSocket->setBlocking(false);
+        Viewer viewer;
+        viewer.socket = std::move(m_nextSocket);
+        m_viewers.push_back(std::move(viewer));
+    }
+
+    // One keyframe for all viewers that need it, once they sent everything before it
+    bool isKeyframeEncoded = false;
+    for (Viewer& viewer : m_viewers)
+    {
+        if (!viewer.needsKeyframe || viewer.sentSize < viewer.queue.size())
+            continue;
+
+        if (!isKeyframeEncoded)
+        {
+            m_encoder.encodeKeyframe(grid, tileSize, tick, score, &m_message);
+            isKeyframeEncoded = true;
+        }
+        queueMessage(&viewer, m_message);
+        viewer.needsKeyframe = false;
+        ++m_keyframeCount;
+    }
+
+    for (std::size_t i = 0; i < m_viewers.size();)
+    {
+        if (flush(&m_viewers[i]))
+            ++i;
+        else
+            m_viewers.erase(m_viewers.begin() + i);
+    }
+}
+
+void SpectatorServer::broadcastTick(const TileGrid& grid, std::uint32_t tick, int score)
+{
+    bool isDeltaEncoded = false;
+    for (Viewer& viewer : m_viewers)
+    {
+        if (viewer.needsKeyframe)
+            continue;
+        if (viewer.queue.size() - viewer.sentSize > MAX_VIEWER_BACKLOG)
+        {
+            viewer.needsKeyframe = true;
+            continue;
+        }
+
+        if (!isDeltaEncoded)
+        {
+            m_encoder.encodeDelta(grid, tick, score, &m_message);
+            isDeltaEncoded = true;
+        }
+        queueMessage(&viewer, m_message);
+    }
+}
+
+void SpectatorServer::resync()
+{
+    for (Viewer& viewer : m_viewers)
+        viewer.needsKeyframe = true;
+}
+
+int SpectatorServer::getViewerCount() const
+{
+    return static_cast<int>(m_viewers.size());
+}
+
+long long SpectatorServer::getSentByteCount() const
+{
+    return m_sentByteCount;
+}
+
+long long SpectatorServer::getKeyframeCount() const
+{
+    return m_keyframeCount;
+}
+
+void SpectatorServer::queueMessage(Viewer* viewer, const std::vector<std::uint8_t>& message)
+{
+    writeVarint(message.size(), &viewer->queue);
+    viewer->queue.insert(viewer->queue.end(), message.begin(), message.end());
+}
+
+bool SpectatorServer::flush(Viewer* viewer)
+{
+    while (viewer->sentSize < viewer->queue.size())
+    {
+        std::size_t sent = 0;
+        const sf::Socket::Status status = viewer->socket->send(viewer->queue.data() + viewer->sentSize,
+            viewer->queue.size() - viewer->sentSize, sent);
+        viewer->sentSize += sent;
+        m_sentByteCount += static_cast<long long>(sent);
+
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+            return false;
+        if (status != sf::Socket::Done)
+            break;
+    }
+
+    // Sent bytes are dropped once they are the larger part, so the queue isn't moved after every partial send
+    if (viewer->sentSize == viewer->queue.size())
+    {
+        viewer->queue.clear();
+        viewer->sentSize = 0;
+    }
+    else if (viewer->sentSize > viewer->queue.size() / 2)
+    {
+        viewer->queue.erase(viewer->queue.begin(), viewer->queue.begin() + viewer->sentSize);
+        viewer->sentSize = 0;
+    }
+    return true;
+}
+
+bool SpectatorClient::connect(const std::string& host, std::uint16_t port, int timeout)
+{
+    m_isConnected = false;
+    m_received.clear();
+    m_decoder = SpectatorDecoder();
+    m_receivedByteCount = 0;
+
+    m_socket.setBlocking(true);
+    if (m_socket.connect(sf::IpAddress(host), port, sf::milliseconds(timeout)) != sf::Socket::Done)
+    {
+        cerr << "SpectatorClient::connect(): no game to watch at " << host << ":" << port << "!" << endl;
+        return false;
+    }
+    m_socket.setBlocking(false);
+    m_buffer.resize(RECEIVE_CHUNK_SIZE);
+    m_isConnected = true;
+    return true;
+}
+
+bool SpectatorClient::update()
+{
+    if (!m_isConnected)
+        return false;
+
+    for (;;)
+    {
+        std::size_t receivedSize = 0;
+        const sf::Socket::Status status = m_socket.receive(m_buffer.data(), m_buffer.size(), receivedSize);
+        if (status == sf::Socket::Done)
+        {
+            m_received.insert(m_received.end(), m_buffer.begin(), m_buffer.begin() + receivedSize);
+            m_receivedByteCount += static_cast<long long>(receivedSize);
+            continue;
+        }
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+            m_isConnected = false;
+        break;
+    }
+
+    std::size_t position = 0;
+    while (position < m_received.size())
+    {
+        std::size_t messageStart = position;
+        std::uint64_t size = 0;
+        const VarintResult result = decodeVarint(m_received.data(), m_received.size(), &messageStart, &size);
+        if (result == VarintResult::Incomplete || (result == VarintResult::Done && size <= MAX_MESSAGE_SIZE && m_received.size() - messageStart < size))
+            break;
+        if (result == VarintResult::Broken || size > MAX_MESSAGE_SIZE)
+        {
+            cerr << "SpectatorClient::update(): broken stream!" << endl;
+            m_socket.disconnect();
+            m_isConnected = false;
+            return false;
+        }
+
+        m_message.assign(m_received.begin() + messageStart, m_received.begin() + messageStart + static_cast<std::size_t>(size));
+        position = messageStart + static_cast<std::size_t>(size);
+        if (!m_decoder.apply(m_message))
+        {
+            cerr << "SpectatorClient::update(): broken message!" << endl;
+            m_socket.disconnect();
+            m_isConnected = false;
+            return false;
+        }
+    }
+    m_received.erase(m_received.begin(), m_received.begin() + position);
+
+    return m_isConnected;
+}
+
+const SpectatorDecoder& SpectatorClient::getDecoder() const
+{
+    return m_decoder;
+}
+
+SpectatorDecoder& SpectatorClient::getDecoder()
+{
+    return m_decoder;
+}
+
+long long SpectatorClient::getReceivedByteCount() const
+{
+    return m_receivedByteCount;
+}
@@ -0,0 +1,193 @@
+#include "simulation/SpectatorStream.hpp"
+#include "Varint.hpp"
+#include <algorithm>
+#include <iostream>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    enum class MessageType : std::uint8_t
+    {
+        Keyframe = 1, Delta
+    };
+
+    const std::uint8_t MAX_TILE_VALUE = static_cast<std::uint8_t>(TileGrid::TileValue::DeadSnakeHead);
+    // Larger grids than this are no level, the message is broken
+    const std::uint64_t MAX_TILE_COUNT = 16384ULL * 16384ULL;
+
+    void writeHeader(MessageType type, std::uint32_t tick, int score, std::vector<std::uint8_t>* message)
+    {
+        message->clear();
+        message->push_back(static_cast<std::uint8_t>(type));
+        writeVarint(tick, message);
+        writeVarint(static_cast<std::uint64_t>(std::max(0, score)), message);
+    }
+}
+
+void SpectatorEncoder::encodeKeyframe(const TileGrid& grid, sf::Vector2u tileSize, std::uint32_t tick, int score, std::vector<std::uint8_t>* message)
+{
+    writeHeader(MessageType::Keyframe, tick, score, message);
+    writeVarint(tileSize.x, message);
+    writeVarint(tileSize.y, message);
+    writeVarint(static_cast<std::uint64_t>(grid.getWidth()), message);
+    writeVarint(static_cast<std::uint64_t>(grid.getHeight()), message);
+
+    // Levels are mostly walls and empty tiles, runs keep even huge ones small
+    TileGrid::TileValue runValue = TileGrid::TileValue::Empty;
+    std::uint64_t runLength = 0;
+    for (int y = 0; y < grid.getHeight(); ++y)
+    {
+        for (int x = 0; x < grid.getWidth(); ++x)
+        {
+            TileGrid::TileValue value = TileGrid::TileValue::Empty;
+            grid.getTileValueAt(x, y, &value);
+            if (runLength > 0 && value != runValue)
+            {
+                writeVarint(runLength, message);
+                message->push_back(static_cast<std::uint8_t>(runValue));
+                runLength = 0;
+            }
+            runValue = value;
+            ++runLength;
+        }
+    }
+    if (runLength > 0)
+    {
+        writeVarint(runLength, message);
+        message->push_back(static_cast<std::uint8_t>(runValue));
+    }
+}
+
+void SpectatorEncoder::encodeDelta(const TileGrid& grid, std::uint32_t tick, int score, std::vector<std::uint8_t>* message)
+{
+    // A tile can change more than once in a tick, only its last value counts
+    const int width = grid.getWidth();
+    m_changedTiles.clear();
+    for (const sf::Vector2i& position : grid.getChangedTiles())
+        m_changedTiles.push_back(position.x + position.y * width);
+    std::sort(m_changedTiles.begin(), m_changedTiles.end());
+    m_changedTiles.erase(std::unique(m_changedTiles.begin(), m_changedTiles.end()), m_changedTiles.end());
+
+    writeHeader(MessageType::Delta, tick, score, message);
+    writeVarint(m_changedTiles.size(), message);
+
+    // Sorted indices as distances to the previous one, neighbouring tiles take one byte
+    int previousTile = 0;
+    for (int tile : m_changedTiles)
+    {
+        TileGrid::TileValue value = TileGrid::TileValue::Empty;
+        grid.getTileValueAt(tile % width, tile / width, &value);
+        writeVarint(static_cast<std::uint64_t>(tile - previousTile), message);
+        message->push_back(static_cast<std::uint8_t>(value));
+        previousTile = tile;
+    }
+}
+
+bool SpectatorDecoder::apply(const std::vector<std::uint8_t>& message)
+{
+    if (message.empty())
+        return false;
+
+    std::size_t position = 1;
+    std::uint64_t tick = 0;
+    std::uint64_t score = 0;
+    if (!readVarint(message, &position, &tick) || !readVarint(message, &position, &score))
+        return false;
+
+    const MessageType type = static_cast<MessageType>(message[0]);
+    if (type == MessageType::Keyframe)
+    {
+        std::uint64_t tileWidth = 0;
+        std::uint64_t tileHeight = 0;
+        std::uint64_t width = 0;
+        std::uint64_t height = 0;
+        if (!readVarint(message, &position, &tileWidth) || !readVarint(message, &position, &tileHeight)
+            || !readVarint(message, &position, &width) || !readVarint(message, &position, &height)
+            || width == 0 || height == 0 || width * height > MAX_TILE_COUNT)
+            return false;
+
+        const std::size_t tileCount = static_cast<std::size_t>(width * height);
+        m_gridData.clear();
+        m_gridData.reserve(tileCount);
+        while (m_gridData.size() < tileCount)
+        {
+            std::uint64_t runLength = 0;
+            if (!readVarint(message, &position, &runLength) || runLength == 0 || runLength > tileCount - m_gridData.size()
+                || position >= message.size() || message[position] > MAX_TILE_VALUE)
+                return false;
+            m_gridData.insert(m_gridData.end(), static_cast<std::size_t>(runLength), message[position++]);
+        }
+
+        if (!m_grid.loadFromArray(m_gridData, static_cast<int>(width), static_cast<int>(height)))
+            return false;
+        m_tileSize = sf::Vector2u(static_cast<unsigned int>(tileWidth), static_cast<unsigned int>(tileHeight));
+        m_hasKeyframe = true;
+        ++m_keyframeCount;
+    }
+    else if (type == MessageType::Delta)
+    {
+        std::uint64_t count = 0;
+        if (!m_hasKeyframe || !readVarint(message, &position, &count))
+            return false;
+
+        const std::uint64_t tileCount = static_cast<std::uint64_t>(m_grid.getWidth()) * m_grid.getHeight();
+        std::uint64_t tile = 0;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            std::uint64_t distance = 0;
+            if (!readVarint(message, &position, &distance) || tile + distance >= tileCount
+                || position >= message.size() || message[position] > MAX_TILE_VALUE)
+                return false;
+
+            tile += distance;
+            const int index = static_cast<int>(tile);
+            m_grid.updateTile(index % m_grid.getWidth(), index / m_grid.getWidth(), static_cast<TileGrid::TileValue>(message[position++]));
+        }
+    }
+    else
+    {
+        cerr << "SpectatorDecoder::apply(): unknown message type " << static_cast<int>(message[0]) << "!" << endl;
+        return false;
+    }
+
+    m_tick = static_cast<std::uint32_t>(tick);
+    m_score = static_cast<int>(score);
+    return true;
+}
+
+bool SpectatorDecoder::hasKeyframe() const
+{
+    return m_hasKeyframe;
+}
+
+long long SpectatorDecoder::getKeyframeCount() const
+{
+    return m_keyframeCount;
+}
+
+TileGrid& SpectatorDecoder::getGrid()
+{
+    return m_grid;
+}
+
+const TileGrid& SpectatorDecoder::getGrid() const
+{
+    return m_grid;
+}
+
+sf::Vector2u SpectatorDecoder::getTileSize() const
+{
+    return m_tileSize;
+}
+
+std::uint32_t SpectatorDecoder::getTick() const
+{
+    return m_tick;
+}
+
+int SpectatorDecoder::getScore() const
+{
+    return static_cast<int>(m_score);
+}
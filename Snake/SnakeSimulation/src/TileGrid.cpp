@@ -0,0 +1,452 @@
+#include "simulation/TileGrid.hpp"
+#include <algorithm>
+#include <iostream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+static int countSetBits(std::uint64_t word)
+{
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+bool TileGrid::loadFromArray(const std::vector<int>& level, int width, int height)
+{
+    if(level.size() != width * height)
+    {
+        cerr << "Size of level data is not equal (width * height)!" << endl;
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_grid.resize(width * height);
+    m_changedTiles.clear();
+    m_journal.clear();
+    m_journalStart = 0;
+    m_emptyTiles.clear();
+    m_emptyTiles.reserve(width * height);
+    m_emptyTileSlots.assign(width * height, -1);
+    m_teleporterPair1.reset();
+    m_teleporterPair2.reset();
+
+    int teleportOneCount = 0;
+    int teleportTwoCount = 0;
+
+    sf::Vector2i teleportOnePos1;
+    sf::Vector2i teleportOnePos2;
+    sf::Vector2i teleportTwoPos1;
+    sf::Vector2i teleportTwoPos2;
+
+    for (unsigned int j = 0; j < height; ++j)
+        for (unsigned int i = 0; i < width; ++i)
+        {
+            // Get the current tile number
+            int intValue = level[i + j * width];
+            TileValue tileValue = static_cast<TileValue>(intValue);
+
+            // Check for teleporter tiles
+            if (tileValue == TileValue::Teleport1)
+            {
+                if (teleportOneCount == 0)
+                    teleportOnePos1 = sf::Vector2i(i, j);
+                else if (teleportOneCount == 1)
+                    teleportOnePos2 = sf::Vector2i(i, j);
+                ++teleportOneCount;
+            }
+            else if (tileValue == TileValue::Teleport2)
+            {
+                if (teleportTwoCount == 0)
+                    teleportTwoPos1 = sf::Vector2i(i, j);
+                else if (teleportTwoCount == 1)
+                    teleportTwoPos2 = sf::Vector2i(i, j);
+                ++teleportTwoCount;
+            }
+
+            // set logical tile value
+            m_grid[i + j * width] = tileValue;
+            if (tileValue == TileValue::Empty)
+                addEmptyTile(i + j * width);
+        }
+
+    // Only none or exactly one pair of each teleporter type is allowed in a level
+    if(!(teleportOneCount == 0 || teleportOneCount == 2) || !(teleportTwoCount == 0 || teleportTwoCount == 2))
+    {
+        cerr << "count of teleporter tiles not valid!" << endl;
+        return false;
+    }
+
+    // Save the valid teleporter positions in a pair
+    if(teleportOneCount == 2)
+        m_teleporterPair1 = std::make_optional<TeleporterPair>(teleportOnePos1, teleportOnePos2);
+    if(teleportTwoCount == 2)
+        m_teleporterPair2 = std::make_optional<TeleporterPair>(teleportTwoPos1, teleportTwoPos2);
+
+    if (m_bitPlanesEnabled)
+        buildBitPlanes();
+
+    return true;
+}
+
+void TileGrid::updateTile(int x, int y, TileValue value)
+{
+    if(!isValidPosition(x, y))
+    {
+        cerr << "updateTile(): invalid x or y coordinate!" << endl;
+        return;
+    }
+
+    int tileIndex = x + y * m_width;
+    TileValue oldValue = m_grid[tileIndex];
+
+    if (m_journalEnabled)
+        m_journal.push_back(JournalEntry {tileIndex, m_emptyTileSlots[tileIndex], oldValue});
+
+    // Keep the empty tile set in sync
+    if (oldValue == TileValue::Empty && value != TileValue::Empty)
+        removeEmptyTile(tileIndex);
+    else if (oldValue != TileValue::Empty && value == TileValue::Empty)
+        addEmptyTile(tileIndex);
+
+    if (m_bitPlanesEnabled)
+    {
+        setBitPlaneBit(oldValue, x, y, false);
+        setBitPlaneBit(value, x, y, true);
+    }
+
+    // Set logical tile value
+    m_grid[tileIndex] = value;
+    m_changedTiles.emplace_back(x, y);
+}
+
+void TileGrid::updateTile(sf::Vector2i position, TileValue value)
+{
+	updateTile(position.x, position.y, value);
+}
+
+void TileGrid::setJournalEnabled(bool enabled)
+{
+    m_journalEnabled = enabled;
+    if (!m_journalEnabled)
+    {
+        m_journalStart += m_journal.size();
+        m_journal.clear();
+    }
+}
+
+std::size_t TileGrid::getJournalPosition() const
+{
+    return m_journalStart + m_journal.size();
+}
+
+void TileGrid::undoJournal(std::size_t position)
+{
+    if (position < m_journalStart)
+    {
+        cerr << "TileGrid::undoJournal(): position " << position << " was already forgotten!" << endl;
+        return;
+    }
+
+    while (getJournalPosition() > position)
+    {
+        const JournalEntry entry = m_journal.back();
+        m_journal.pop_back();
+
+        const int tileIndex = entry.tileIndex;
+        const TileValue value = m_grid[tileIndex];
+        const int x = tileIndex % m_width;
+        const int y = tileIndex / m_width;
+
+        // The exact reverse of addEmptyTile() and removeEmptyTile(), they only ever touch the end of the list
+        if (value != TileValue::Empty && entry.oldValue == TileValue::Empty)
+        {
+            const int slot = entry.emptyTileSlot;
+            if (slot == static_cast<int>(m_emptyTiles.size()))
+                m_emptyTiles.push_back(tileIndex);
+            else
+            {
+                const int movedTileIndex = m_emptyTiles[slot];
+                m_emptyTileSlots[movedTileIndex] = static_cast<int>(m_emptyTiles.size());
+                m_emptyTiles.push_back(movedTileIndex);
+                m_emptyTiles[slot] = tileIndex;
+            }
+            m_emptyTileSlots[tileIndex] = slot;
+        }
+        else if (value == TileValue::Empty && entry.oldValue != TileValue::Empty)
+        {
+            m_emptyTiles.pop_back();
+            m_emptyTileSlots[tileIndex] = -1;
+        }
+
+        if (m_bitPlanesEnabled)
+        {
+            setBitPlaneBit(value, x, y, false);
+            setBitPlaneBit(entry.oldValue, x, y, true);
+        }
+
+        m_grid[tileIndex] = entry.oldValue;
+        m_changedTiles.emplace_back(x, y);
+    }
+}
+
+void TileGrid::forgetJournal(std::size_t position)
+{
+    const std::size_t count = std::min(position, getJournalPosition()) - std::min(position, m_journalStart);
+    m_journal.erase(m_journal.begin(), m_journal.begin() + count);
+    m_journalStart += count;
+}
+
+bool TileGrid::isValidPosition(int x, int y) const
+{
+    return x >= 0 && y >= 0 && x < m_width && y < m_height;
+}
+
+bool TileGrid::isValidPosition(sf::Vector2i position) const
+{
+    return isValidPosition(position.x, position.y);
+}
+
+bool TileGrid::getTileValueAt(int x, int y, TileValue* const tileValueToSet) const
+{
+    if (!isValidPosition(x, y))
+        return false;
+
+    *tileValueToSet = m_grid[x + y * m_width];
+    return true;
+}
+
+bool TileGrid::getTileValueAt(sf::Vector2i position, TileValue* const tileValueToSet) const
+{
+    return getTileValueAt(position.x, position.y, tileValueToSet);
+}
+
+void TileGrid::getListOfEmptyTiles(std::vector<sf::Vector2i>* tileList) const
+{
+    // Reserving for an append would reallocate to the exact size every call, appends grow geometrically
+    if (tileList->empty())
+        tileList->reserve(m_emptyTiles.size());
+    for (int tileIndex : m_emptyTiles)
+        tileList->emplace_back(tileIndex % m_width, tileIndex / m_width);
+}
+
+std::size_t TileGrid::getEmptyTileCount() const
+{
+    return m_emptyTiles.size();
+}
+
+sf::Vector2i TileGrid::getEmptyTile(std::size_t index) const
+{
+    int tileIndex = m_emptyTiles[index];
+    return sf::Vector2i(tileIndex % m_width, tileIndex / m_width);
+}
+
+std::optional<sf::Vector2i> TileGrid::getPositionOfOtherTeleporter1(sf::Vector2i position) const
+{
+    if(m_teleporterPair1)
+    {
+        if(position == m_teleporterPair1->pos1)
+            return m_teleporterPair1->pos2;
+        if (position == m_teleporterPair1->pos2)
+            return m_teleporterPair1->pos1;
+    }
+	return std::nullopt;
+}
+
+std::optional<sf::Vector2i> TileGrid::getPositionOfOtherTeleporter2(sf::Vector2i position) const
+{
+    if (m_teleporterPair2)
+    {
+        if (position == m_teleporterPair2->pos1)
+            return m_teleporterPair2->pos2;
+        if (position == m_teleporterPair2->pos2)
+            return m_teleporterPair2->pos1;
+    }
+    return std::nullopt;
+}
+
+int TileGrid::getWidth() const
+{
+    return m_width;
+}
+
+int TileGrid::getHeight() const
+{
+    return m_height;
+}
+
+const std::vector<sf::Vector2i>& TileGrid::getChangedTiles() const
+{
+    return m_changedTiles;
+}
+
+void TileGrid::clearChangedTiles()
+{
+    m_changedTiles.clear();
+}
+
+void TileGrid::addEmptyTile(int tileIndex)
+{
+    m_emptyTileSlots[tileIndex] = static_cast<int>(m_emptyTiles.size());
+    m_emptyTiles.push_back(tileIndex);
+}
+
+void TileGrid::removeEmptyTile(int tileIndex)
+{
+    // Swap with the last entry so the dense list stays without gaps
+    int slot = m_emptyTileSlots[tileIndex];
+    int lastTileIndex = m_emptyTiles.back();
+    m_emptyTiles[slot] = lastTileIndex;
+    m_emptyTileSlots[lastTileIndex] = slot;
+    m_emptyTiles.pop_back();
+    m_emptyTileSlots[tileIndex] = -1;
+}
+
+void TileGrid::setBitPlanesEnabled(bool enabled)
+{
+    m_bitPlanesEnabled = enabled;
+    if (m_bitPlanesEnabled)
+        buildBitPlanes();
+    else
+        for (auto& bitPlane : m_bitPlanes)
+            std::vector<std::uint64_t>().swap(bitPlane);
+}
+
+bool TileGrid::areBitPlanesEnabled() const
+{
+    return m_bitPlanesEnabled;
+}
+
+const std::vector<std::uint64_t>& TileGrid::getBitPlane(BitPlane plane) const
+{
+    return m_bitPlanes[static_cast<int>(plane)];
+}
+
+int TileGrid::getWordsPerRow() const
+{
+    return m_wordsPerRow;
+}
+
+std::size_t TileGrid::countTiles(BitPlane plane) const
+{
+    std::size_t count = 0;
+    for (std::uint64_t word : m_bitPlanes[static_cast<int>(plane)])
+        count += countSetBits(word);
+    return count;
+}
+
+void TileGrid::getCollisionMask(std::vector<std::uint64_t>* mask) const
+{
+    const auto& walls = m_bitPlanes[static_cast<int>(BitPlane::Walls)];
+    const auto& snake = m_bitPlanes[static_cast<int>(BitPlane::Snake)];
+
+    mask->resize(walls.size());
+    for (std::size_t i = 0; i < walls.size(); ++i)
+        (*mask)[i] = walls[i] | snake[i];
+}
+
+void TileGrid::getBlockedNeighbourMask(std::vector<std::uint64_t>* mask) const
+{
+    // Bit is set if at least one of the four direct neighbours collides, bit i of a word is x = word * 64 + i
+    std::vector<std::uint64_t> blocked;
+    getCollisionMask(&blocked);
+    mask->assign(blocked.size(), 0);
+
+    for (int y = 0; y < m_height; ++y)
+    {
+        const std::uint64_t* row = &blocked[y * m_wordsPerRow];
+        const std::uint64_t* rowAbove = y > 0 ? row - m_wordsPerRow : nullptr;
+        const std::uint64_t* rowBelow = y < m_height - 1 ? row + m_wordsPerRow : nullptr;
+        std::uint64_t* result = &(*mask)[y * m_wordsPerRow];
+
+        for (int w = 0; w < m_wordsPerRow; ++w)
+        {
+            // Left neighbour of x is x - 1, carry the highest bit over from the previous word
+            std::uint64_t left = row[w] << 1;
+            if (w > 0)
+                left |= row[w - 1] >> 63;
+
+            // Right neighbour of x is x + 1, carry the lowest bit over from the next word
+            std::uint64_t right = row[w] >> 1;
+            if (w < m_wordsPerRow - 1)
+                right |= row[w + 1] << 63;
+
+            std::uint64_t neighbours = left | right;
+            if (rowAbove)
+                neighbours |= rowAbove[w];
+            if (rowBelow)
+                neighbours |= rowBelow[w];
+
+            result[w] = neighbours;
+        }
+    }
+}
+
+std::size_t TileGrid::getMemoryUsage() const
+{
+    std::size_t bytes = m_grid.capacity() * sizeof(TileValue)
+        + m_emptyTiles.capacity() * sizeof(int)
+        + m_emptyTileSlots.capacity() * sizeof(int)
+        + m_changedTiles.capacity() * sizeof(sf::Vector2i);
+
+    for (const auto& bitPlane : m_bitPlanes)
+        bytes += bitPlane.capacity() * sizeof(std::uint64_t);
+
+    return bytes;
+}
+
+void TileGrid::buildBitPlanes()
+{
+    m_wordsPerRow = (m_width + 63) / 64;
+    for (auto& bitPlane : m_bitPlanes)
+        bitPlane.assign(m_wordsPerRow * m_height, 0);
+
+    for (int y = 0; y < m_height; ++y)
+        for (int x = 0; x < m_width; ++x)
+            setBitPlaneBit(m_grid[x + y * m_width], x, y, true);
+}
+
+void TileGrid::setBitPlaneBit(TileValue value, int x, int y, bool isSet)
+{
+    std::optional<BitPlane> plane = getBitPlaneOfTileValue(value);
+    if (!plane)
+        return;
+
+    std::uint64_t& word = m_bitPlanes[static_cast<int>(*plane)][y * m_wordsPerRow + x / 64];
+    std::uint64_t bit = std::uint64_t(1) << (x % 64);
+    if (isSet)
+        word |= bit;
+    else
+        word &= ~bit;
+}
+
+std::optional<TileGrid::BitPlane> TileGrid::getBitPlaneOfTileValue(TileValue value)
+{
+    switch (value)
+    {
+    case TileValue::Empty:
+        return BitPlane::Free;
+    case TileValue::Wall:
+    case TileValue::NoPlayArea:
+        return BitPlane::Walls;
+    case TileValue::SnakeBody:
+    case TileValue::SnakeHead:
+    case TileValue::DeadSnakeBody:
+    case TileValue::DeadSnakeHead:
+        return BitPlane::Snake;
+    case TileValue::Food:
+    case TileValue::SuperFood:
+        return BitPlane::Food;
+    default:
+        // Teleporters and poison are neither blocking nor free
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,60 @@
+#include "simulation/UdpTransport.hpp"
+#include <iostream>
+
+using std::endl;
+using std::cerr;
+
+UdpTransport::UdpTransport()
+    :m_buffer(sf::UdpSocket::MaxDatagramSize)
+{
+    m_socket.setBlocking(false);
+}
+
+bool UdpTransport::bind(std::uint16_t port)
+{
+    if (m_socket.bind(port) != sf::Socket::Done)
+    {
+        cerr << "UdpTransport::bind(): port " << port << " is not available!" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool UdpTransport::send(const NetEndpoint& to, const std::vector<std::uint8_t>& datagram)
+{
+    return m_socket.send(datagram.data(), datagram.size(), sf::IpAddress(to.address), to.port) == sf::Socket::Done;
+}
+
+bool UdpTransport::receive(NetEndpoint* from, std::vector<std::uint8_t>* datagram)
+{
+    std::size_t receivedSize = 0;
+    sf::IpAddress sender;
+    unsigned short senderPort = 0;
+    if (m_socket.receive(m_buffer.data(), m_buffer.size(), receivedSize, sender, senderPort) != sf::Socket::Done)
+        return false;
+
+    from->address = sender.toInteger();
+    from->port = senderPort;
+    datagram->assign(m_buffer.begin(), m_buffer.begin() + receivedSize);
+    return true;
+}
+
+NetEndpoint UdpTransport::getLocalEndpoint() const
+{
+    NetEndpoint endpoint;
+    endpoint.address = sf::IpAddress::getLocalAddress().toInteger();
+    endpoint.port = m_socket.getLocalPort();
+    return endpoint;
+}
+
+std::optional<NetEndpoint> UdpTransport::resolve(const std::string& host, std::uint16_t port)
+{
+    const sf::IpAddress address(host);
+    if (address == sf::IpAddress::None)
+        return std::nullopt;
+
+    NetEndpoint endpoint;
+    endpoint.address = address.toInteger();
+    endpoint.port = port;
+    return endpoint;
+}
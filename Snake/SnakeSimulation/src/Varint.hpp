@@ -0,0 +1,54 @@
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LEB128 varints, the wire format of levels, replays, cycles, lockstep datagrams and the spectator stream.
+// Only used inside the simulation library.
+
+enum class VarintResult
+{
+    Done,
+    Incomplete, // The data ends before the last byte
+    Broken // Longer than 64 bits
+};
+
+inline void writeVarint(std::uint64_t value, std::vector<std::uint8_t>* data)
+{
+    while (value >= 0x80)
+    {
+        data->push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data->push_back(static_cast<std::uint8_t>(value));
+}
+
+inline VarintResult decodeVarint(const std::uint8_t* data, std::size_t size, std::size_t* position, std::uint64_t* value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (*position >= size)
+            return VarintResult::Incomplete;
+
+        std::uint8_t byte = data[(*position)++];
+        *value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return VarintResult::Done;
+    }
+    return VarintResult::Broken;
+}
+
+inline bool readVarint(const std::uint8_t* data, std::size_t size, std::size_t* position, std::uint64_t* value)
+{
+    return decodeVarint(data, size, position, value) == VarintResult::Done;
+}
+
+inline bool readVarint(const std::vector<std::uint8_t>& data, std::size_t* position, std::uint64_t* value)
+{
+    return readVarint(data.data(), data.size(), position, value);
+}
+
+#endif
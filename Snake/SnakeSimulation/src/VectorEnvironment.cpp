@@ -0,0 +1,193 @@
+#include "simulation/VectorEnvironment.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using std::endl;
+using std::cerr;
+
+namespace
+{
+    // Plane a tile value is shown in, Empty and Poison (which has no effect yet) are in none
+    int getPlaneOfTileValue(TileGrid::TileValue value)
+    {
+        switch (value)
+        {
+        case TileGrid::TileValue::Wall:
+        case TileGrid::TileValue::NoPlayArea:
+            return static_cast<int>(VectorEnvironment::ObservationPlane::Walls);
+        case TileGrid::TileValue::SnakeBody:
+        case TileGrid::TileValue::DeadSnakeBody:
+            return static_cast<int>(VectorEnvironment::ObservationPlane::SnakeBody);
+        case TileGrid::TileValue::SnakeHead:
+        case TileGrid::TileValue::DeadSnakeHead:
+            return static_cast<int>(VectorEnvironment::ObservationPlane::SnakeHead);
+        case TileGrid::TileValue::Food:
+            return static_cast<int>(VectorEnvironment::ObservationPlane::Food);
+        case TileGrid::TileValue::SuperFood:
+            return static_cast<int>(VectorEnvironment::ObservationPlane::SuperFood);
+        case TileGrid::TileValue::Teleport1:
+        case TileGrid::TileValue::Teleport2:
+            return static_cast<int>(VectorEnvironment::ObservationPlane::Teleporters);
+        default:
+            return -1;
+        }
+    }
+}
+
+bool VectorEnvironment::create(const LevelData& level, int gameCount, unsigned int seed, long long maxTicks)
+{
+    if (gameCount <= 0 || maxTicks <= 0)
+    {
+        cerr << "VectorEnvironment::create(): the game count and the tick limit have to be positive!" << endl;
+        return false;
+    }
+
+    if (!m_initialGame.loadLevel(level))
+        return false;
+
+    m_width = level.width;
+    m_height = level.height;
+    m_seed = seed;
+    m_maxTicks = maxTicks;
+
+    // All games start from the same tiles, a restart copies this instead of writing every tile
+    m_initialObservation.assign(getObservationSize(), 0);
+    const TileGrid& grid = m_initialGame.getGrid();
+    for (int y = 0; y < m_height; ++y)
+    {
+        for (int x = 0; x < m_width; ++x)
+        {
+            TileGrid::TileValue tileValue = TileGrid::TileValue::Empty;
+            grid.getTileValueAt(x, y, &tileValue);
+            writeTile(m_initialObservation.data(), sf::Vector2i(x, y), tileValue);
+        }
+    }
+
+    m_games.assign(gameCount, m_initialGame);
+    for (Simulation& game : m_games)
+        game.reserveSnakeLength(static_cast<std::size_t>(m_width) * m_height);
+    m_ticks.assign(gameCount, 0);
+    m_observations = nullptr;
+    m_rewards = nullptr;
+    m_dones = nullptr;
+    return true;
+}
+
+void VectorEnvironment::setBuffers(std::uint8_t* observations, float* rewards, std::uint8_t* dones)
+{
+    m_observations = observations;
+    m_rewards = rewards;
+    m_dones = dones;
+}
+
+void VectorEnvironment::reset()
+{
+    if (!m_observations || !m_rewards || !m_dones)
+    {
+        cerr << "VectorEnvironment::reset(): no buffers set!" << endl;
+        return;
+    }
+
+    for (int i = 0; i < getGameCount(); ++i)
+    {
+        m_games[i].seed(m_seed + static_cast<unsigned int>(i));
+        resetGame(i);
+        m_rewards[i] = 0.0f;
+        m_dones[i] = 0;
+    }
+}
+
+void VectorEnvironment::step(const std::uint8_t* actions)
+{
+    stepRange(actions, 0, getGameCount());
+}
+
+void VectorEnvironment::stepRange(const std::uint8_t* actions, int begin, int end)
+{
+    if (!m_observations || !m_rewards || !m_dones)
+    {
+        cerr << "VectorEnvironment::stepRange(): no buffers set!" << endl;
+        return;
+    }
+
+    begin = std::max(begin, 0);
+    end = std::min(end, getGameCount());
+    const std::size_t observationSize = getObservationSize();
+
+    for (int i = begin; i < end; ++i)
+    {
+        Simulation& game = m_games[i];
+        const int previousScore = game.getScore();
+        game.step(static_cast<PlayerInput>(actions[i] & 3));
+        ++m_ticks[i];
+
+        float reward = static_cast<float>(game.getScore() - previousScore);
+        if (game.isSnakeDead() || m_ticks[i] >= m_maxTicks)
+        {
+            if (game.isSnakeDead())
+                reward += DEATH_REWARD;
+            m_rewards[i] = reward;
+            m_dones[i] = 1;
+            resetGame(i);
+            continue;
+        }
+
+        // Only the tiles the step touched differ from the observation of the previous step
+        std::uint8_t* observation = m_observations + i * observationSize;
+        const TileGrid& grid = game.getGrid();
+        for (const sf::Vector2i& position : grid.getChangedTiles())
+        {
+            TileGrid::TileValue tileValue = TileGrid::TileValue::Empty;
+            grid.getTileValueAt(position, &tileValue);
+            writeTile(observation, position, tileValue);
+        }
+
+        m_rewards[i] = reward;
+        m_dones[i] = 0;
+    }
+}
+
+int VectorEnvironment::getGameCount() const
+{
+    return static_cast<int>(m_games.size());
+}
+
+int VectorEnvironment::getWidth() const
+{
+    return m_width;
+}
+
+int VectorEnvironment::getHeight() const
+{
+    return m_height;
+}
+
+std::size_t VectorEnvironment::getObservationSize() const
+{
+    return static_cast<std::size_t>(OBSERVATION_PLANE_COUNT) * m_width * m_height;
+}
+
+const Simulation& VectorEnvironment::getGame(int index) const
+{
+    return m_games[index];
+}
+
+void VectorEnvironment::resetGame(int index)
+{
+    m_games[index].restartFrom(m_initialGame);
+    m_ticks[index] = 0;
+
+    std::memcpy(m_observations + index * getObservationSize(), m_initialObservation.data(), m_initialObservation.size());
+}
+
+void VectorEnvironment::writeTile(std::uint8_t* observation, sf::Vector2i position, TileGrid::TileValue value) const
+{
+    std::uint8_t* tile = observation + (position.x + static_cast<std::size_t>(position.y) * m_width) * OBSERVATION_PLANE_COUNT;
+    for (int plane = 0; plane < OBSERVATION_PLANE_COUNT; ++plane)
+        tile[plane] = 0;
+
+    const int plane = getPlaneOfTileValue(value);
+    if (plane >= 0)
+        tile[plane] = 1;
+}
@@ -0,0 +1,361 @@
+#include "simulation/Levels.hpp"
+#include "simulation/SnakeArena.hpp"
+#include "simulation/SpectatorServer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Streams an arena game of wandering snakes to spectators over TCP and measures what it costs.
+// Usage: SnakeSpectator --loopback [--viewers N] [--ticks N] [--level N] [--snakes N] [--seed N] [--port N]
+//        SnakeSpectator --serve <port> [--level N] [--snakes N] [--seed N] [--tick-ms N]
+//        SnakeSpectator --watch <host> <port> [--viewers N] [--ticks N]
+// --loopback serves and watches in this process as fast as the viewers keep up, and checks after every
+// tick that each viewer's grid is the same as the game's.
+
+namespace
+{
+    const int SNAKE_RESPAWN_TICKS = 8;
+    const std::chrono::milliseconds VIEWER_TIMEOUT {5000};
+
+    struct Options
+    {
+        enum class Mode { None, Loopback, Serve, Watch };
+
+        Mode mode {Mode::None};
+        int viewers {8};
+        int ticks {2000};
+        int levelIndex {0};
+        int snakeCount {8};
+        unsigned int seed {0};
+        int tickMilliseconds {250}; // TIME_PER_SNAKE_MOVEMENT of the game
+        std::string host;
+        std::uint16_t port {5100};
+    };
+
+    // The game that is watched: all snakes wander and start over a while after they died
+    class ArenaGame
+    {
+    public:
+        bool load(const Options& options)
+        {
+            m_arena.seed(options.seed);
+            m_randomGenerator.seed(options.seed);
+            m_level = buildBuiltinLevel(options.levelIndex);
+            if (!m_arena.loadLevel(m_level, options.snakeCount))
+                return false;
+            m_inputs.resize(m_arena.getSnakeCount());
+            m_respawnTicks.assign(m_arena.getSnakeCount(), 0);
+            return true;
+        }
+
+        void step()
+        {
+            for (int i = 0; i < m_arena.getSnakeCount(); ++i)
+                m_inputs[i] = m_arena.getWanderInput(i, m_randomGenerator());
+            m_arena.step(m_inputs.data());
+
+            for (int i = 0; i < m_arena.getSnakeCount(); ++i)
+            {
+                if (m_arena.isSnakeAlive(i))
+                    continue;
+                if (++m_respawnTicks[i] >= SNAKE_RESPAWN_TICKS)
+                {
+                    m_respawnTicks[i] = 0;
+                    m_arena.respawnSnake(i);
+                }
+            }
+            ++m_tick;
+        }
+
+        const TileGrid& getGrid() const { return m_arena.getGrid(); }
+        sf::Vector2u getTileSize() const { return m_level.tileSize; }
+        std::uint32_t getTick() const { return m_tick; }
+        int getScore() const { return m_arena.getScore(0); }
+
+    private:
+        LevelData m_level;
+        SnakeArena m_arena;
+        std::vector<Simulation::PlayerInput> m_inputs;
+        std::vector<int> m_respawnTicks;
+        std::mt19937 m_randomGenerator;
+        std::uint32_t m_tick {0};
+    };
+
+    bool parseOptions(int argc, char* argv[], Options* options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            if (argument == "--loopback")
+            {
+                options->mode = Options::Mode::Loopback;
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            const std::string value = argv[++i];
+
+            if (argument == "--serve")
+            {
+                options->mode = Options::Mode::Serve;
+                options->port = static_cast<std::uint16_t>(std::stoi(value));
+            }
+            else if (argument == "--watch" && i + 1 < argc)
+            {
+                options->mode = Options::Mode::Watch;
+                options->host = value;
+                options->port = static_cast<std::uint16_t>(std::stoi(argv[++i]));
+            }
+            else if (argument == "--viewers")
+                options->viewers = std::stoi(value);
+            else if (argument == "--ticks")
+                options->ticks = std::stoi(value);
+            else if (argument == "--level")
+                options->levelIndex = std::stoi(value) - 1;
+            else if (argument == "--snakes")
+                options->snakeCount = std::stoi(value);
+            else if (argument == "--seed")
+                options->seed = static_cast<unsigned int>(std::stoul(value));
+            else if (argument == "--tick-ms")
+                options->tickMilliseconds = std::stoi(value);
+            else if (argument == "--port")
+                options->port = static_cast<std::uint16_t>(std::stoi(value));
+            else
+                return false;
+        }
+
+        return options->mode != Options::Mode::None && options->viewers >= 1 && options->ticks > 0 && options->snakeCount >= 1
+            && options->levelIndex >= 0 && options->levelIndex < BUILTIN_LEVEL_COUNT && options->tickMilliseconds >= 0;
+    }
+
+    bool gridsMatch(const TileGrid& first, const TileGrid& second)
+    {
+        if (first.getWidth() != second.getWidth() || first.getHeight() != second.getHeight())
+            return false;
+
+        for (int y = 0; y < first.getHeight(); ++y)
+        {
+            for (int x = 0; x < first.getWidth(); ++x)
+            {
+                TileGrid::TileValue firstValue = TileGrid::TileValue::Empty;
+                TileGrid::TileValue secondValue = TileGrid::TileValue::Empty;
+                first.getTileValueAt(x, y, &firstValue);
+                second.getTileValueAt(x, y, &secondValue);
+                if (firstValue != secondValue)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool connectViewers(const Options& options, const std::string& host, std::vector<std::unique_ptr<SpectatorClient>>* viewers,
+        SpectatorServer* server = nullptr, ArenaGame* game = nullptr)
+    {
+        for (int i = 0; i < options.viewers; ++i)
+        {
+            viewers->push_back(std::make_unique<SpectatorClient>());
+            if (!viewers->back()->connect(host, options.port))
+                return false;
+            // The own server has to accept the viewers, connect() only waits for the operating system
+            if (server)
+                server->update(game->getGrid(), game->getTileSize(), game->getTick(), game->getScore());
+        }
+        return true;
+    }
+
+    int runLoopback(const Options& options)
+    {
+        ArenaGame game;
+        SpectatorServer server;
+        if (!game.load(options) || !server.listen(options.port))
+            return 1;
+
+        std::vector<std::unique_ptr<SpectatorClient>> viewers;
+        if (!connectViewers(options, "127.0.0.1", &viewers, &server, &game))
+            return 1;
+
+        const TileGrid& grid = game.getGrid();
+        std::vector<long long> keyframeBytes(viewers.size(), 0);
+        const auto begin = std::chrono::steady_clock::now();
+        for (int tick = 0; tick <= options.ticks; ++tick)
+        {
+            if (tick > 0)
+            {
+                game.step();
+                server.broadcastTick(grid, game.getTick(), game.getScore());
+            }
+
+            // Every viewer has to reach the tick before the next one, so each one is compared to the game
+            const auto waitBegin = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < viewers.size(); ++i)
+            {
+                SpectatorClient& viewer = *viewers[i];
+                while (!viewer.getDecoder().hasKeyframe() || viewer.getDecoder().getTick() != game.getTick())
+                {
+                    server.update(grid, game.getTileSize(), game.getTick(), game.getScore());
+                    if (!viewer.update())
+                        return 1;
+                    if (std::chrono::steady_clock::now() - waitBegin > VIEWER_TIMEOUT)
+                    {
+                        cerr << "Viewer " << i + 1 << " got stuck at tick " << viewer.getDecoder().getTick() << endl;
+                        return 1;
+                    }
+                }
+                if (tick == 0)
+                    keyframeBytes[i] = viewer.getReceivedByteCount();
+                viewer.getDecoder().getGrid().clearChangedTiles();
+
+                if (!gridsMatch(viewer.getDecoder().getGrid(), grid) || viewer.getDecoder().getScore() != game.getScore())
+                {
+                    cerr << "Viewer " << i + 1 << " DIVERGED at tick " << game.getTick() << endl;
+                    return 1;
+                }
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        cout << options.viewers << " viewers, " << options.snakeCount << " snakes on level " << options.levelIndex + 1 << " ("
+            << grid.getWidth() << "x" << grid.getHeight() << " tiles), " << options.ticks << " ticks" << endl;
+        long long totalBytes = 0;
+        long long totalKeyframeBytes = 0;
+        for (std::size_t i = 0; i < viewers.size(); ++i)
+        {
+            totalBytes += viewers[i]->getReceivedByteCount();
+            totalKeyframeBytes += keyframeBytes[i];
+        }
+        const double viewerCount = static_cast<double>(viewers.size());
+        cout << std::fixed << std::setprecision(2)
+            << "  keyframe     " << totalKeyframeBytes / viewerCount << " bytes per viewer" << endl
+            << "  deltas       " << (totalBytes - totalKeyframeBytes) / viewerCount / options.ticks << " bytes per tick and viewer" << endl
+            << "  server       " << server.getSentByteCount() << " bytes sent, " << server.getKeyframeCount() << " keyframes" << endl
+            << "  wall time    " << seconds << " s" << endl
+            << "  all viewers matched the game after every tick" << endl;
+        return 0;
+    }
+
+    int runServe(const Options& options)
+    {
+        ArenaGame game;
+        SpectatorServer server;
+        if (!game.load(options) || !server.listen(options.port))
+            return 1;
+
+        cout << "Serving " << options.snakeCount << " snakes on level " << options.levelIndex + 1 << " to spectators on port "
+            << options.port << endl;
+        const std::chrono::milliseconds tickDuration(options.tickMilliseconds);
+        auto nextTickTime = std::chrono::steady_clock::now() + tickDuration;
+        int viewerCount = 0;
+        for (;;)
+        {
+            server.update(game.getGrid(), game.getTileSize(), game.getTick(), game.getScore());
+            if (server.getViewerCount() != viewerCount)
+            {
+                viewerCount = server.getViewerCount();
+                cout << "tick " << game.getTick() << ", " << viewerCount << " viewers" << endl;
+            }
+
+            if (std::chrono::steady_clock::now() < nextTickTime)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            nextTickTime += tickDuration;
+            game.step();
+            server.broadcastTick(game.getGrid(), game.getTick(), game.getScore());
+
+            if (game.getTick() % 1000 == 0)
+                cout << "tick " << game.getTick() << ", " << server.getSentByteCount() << " bytes sent, "
+                    << server.getKeyframeCount() << " keyframes" << endl;
+        }
+    }
+
+    int runWatch(const Options& options)
+    {
+        std::vector<std::unique_ptr<SpectatorClient>> viewers;
+        if (!connectViewers(options, options.host, &viewers))
+            return 1;
+
+        // Ticks are counted from each viewer's first keyframe on
+        std::vector<bool> hasKeyframe(viewers.size(), false);
+        std::vector<std::uint32_t> firstTicks(viewers.size(), 0);
+        for (;;)
+        {
+            bool isDone = true;
+            for (std::size_t i = 0; i < viewers.size(); ++i)
+            {
+                SpectatorClient& viewer = *viewers[i];
+                if (!viewer.update())
+                {
+                    cerr << "Viewer " << i + 1 << " lost the connection" << endl;
+                    return 1;
+                }
+                viewer.getDecoder().getGrid().clearChangedTiles();
+
+                const SpectatorDecoder& decoder = viewer.getDecoder();
+                if (decoder.hasKeyframe() && !hasKeyframe[i])
+                {
+                    hasKeyframe[i] = true;
+                    firstTicks[i] = decoder.getTick();
+                }
+                isDone = isDone && decoder.hasKeyframe() && static_cast<int>(decoder.getTick() - firstTicks[i]) >= options.ticks;
+            }
+            if (isDone)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Viewers that stopped at the same tick have to show the same grid
+        for (std::size_t i = 1; i < viewers.size(); ++i)
+        {
+            const SpectatorDecoder& decoder = viewers[i]->getDecoder();
+            const SpectatorDecoder& reference = viewers.front()->getDecoder();
+            if (decoder.getTick() == reference.getTick() && !gridsMatch(decoder.getGrid(), reference.getGrid()))
+            {
+                cerr << "Viewer " << i + 1 << " differs from viewer 1 at tick " << decoder.getTick() << endl;
+                return 1;
+            }
+        }
+
+        long long totalBytes = 0;
+        long long totalTicks = 0;
+        for (std::size_t i = 0; i < viewers.size(); ++i)
+        {
+            totalBytes += viewers[i]->getReceivedByteCount();
+            totalTicks += viewers[i]->getDecoder().getTick() - firstTicks[i];
+        }
+        const TileGrid& grid = viewers.front()->getDecoder().getGrid();
+        cout << options.viewers << " viewers of a " << grid.getWidth() << "x" << grid.getHeight() << " level" << endl
+            << std::fixed << std::setprecision(2) << "  received     " << static_cast<double>(totalBytes) / totalTicks
+            << " bytes per tick and viewer, keyframes included" << endl;
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, &options))
+    {
+        cerr << "Usage: " << argv[0] << " --loopback [--viewers N] [--ticks N] [--level N] [--snakes N] [--seed N] [--port N]" << endl
+            << "   or: " << argv[0] << " --serve <port> [--level N] [--snakes N] [--seed N] [--tick-ms N]" << endl
+            << "   or: " << argv[0] << " --watch <host> <port> [--viewers N] [--ticks N]" << endl;
+        return 1;
+    }
+
+    if (options.mode == Options::Mode::Loopback)
+        return runLoopback(options);
+    if (options.mode == Options::Mode::Serve)
+        return runServe(options);
+    return runWatch(options);
+}